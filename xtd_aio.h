@@ -0,0 +1,741 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Asynchronous file writing module
+// #define XTD_AIO_IMPLEMENTATION to include the implementation
+// Depends on xtd_thread.h and xtd_queue.h
+// Uses io_uring on Linux (raw syscalls, no liburing) and a thread pool everywhere else.
+// With glibc, O_DIRECT needs _GNU_SOURCE defined before the first include, direct writes
+// are silently buffered otherwise.
+
+#ifndef XTD_AIO_HEADER_H
+#define XTD_AIO_HEADER_H
+
+#ifndef XTD_AIO_FUNC
+#define XTD_AIO_FUNC
+#endif
+
+#ifndef XTD_AIO_FUNC_DECL
+#define XTD_AIO_FUNC_DECL extern
+#endif
+
+#include "xtd_common.h"
+#include "xtd_thread.h"
+#include "xtd_queue.h"
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  Async Writer Types
+//
+
+// Each request creates (or truncates) one file and writes a list of buffers to it, e.g. a
+// header and the pixels of a frame:
+//   XTD_WriteRequest req = {path, {&header, pixels}, {sizeof(header), pixels_size}, 2, ReleaseFrame, frame};
+//   XTD_AsyncWrite(&writer, &req);
+// Buffers must stay alive until on_done is called for the request.
+
+#define XTD_AIO_MAX_BUFFERS 4
+// O_DIRECT writes need buffer addresses and sizes aligned to this (the last size may be
+// unaligned, its tail is written buffered). Unaligned requests are written buffered.
+#define XTD_AIO_DIRECT_ALIGNMENT 4096
+
+// Called from a writer thread once the request finished, result is 0 or an errno value.
+// Must be thread safe when the thread pool backend runs more than one thread.
+typedef void XTD_WriteDoneFunc(void* user, int result);
+
+typedef struct {
+    const char* path;
+    const void* buffers[XTD_AIO_MAX_BUFFERS];
+    usize sizes[XTD_AIO_MAX_BUFFERS];
+    u32 buffer_count;
+    XTD_WriteDoneFunc* on_done; // Optional
+    void* user;
+} XTD_WriteRequest;
+
+typedef enum {
+    XTD_AIO_BACKEND_AUTO,     // io_uring when the kernel allows it, thread pool otherwise
+    XTD_AIO_BACKEND_IO_URING,
+    XTD_AIO_BACKEND_THREADS,
+} XTD_AIOBackend;
+
+typedef struct {
+    u32 queue_depth;  // Requests queued or in flight before XTD_AsyncWrite blocks (0 = 64)
+    u32 thread_count; // Threads of the thread pool backend (0 = 2), io_uring uses a single one
+    bool direct;      // Open files with O_DIRECT, bypassing the page cache
+    XTD_AIOBackend backend;
+} XTD_AsyncWriterDesc;
+
+typedef struct {
+    XTD_AIOBackend backend; // Backend in use, never AUTO after init
+    u32 queue_depth;
+    u32 thread_count;
+    bool direct;
+    XTD_MPMCQueue queue;  // Queued XTD_WriteRequests
+    XTD_Semaphore ready;  // Queued requests
+    XTD_Semaphore slots;  // Free queue slots, released when a request completes
+    XTD_Thread* threads;
+    void* ring;           // io_uring state
+
+    // Stats, updated atomically by the writer threads
+    u64 completed;
+    u64 failed;
+    u64 bytes_written;
+    u64 stalls;           // XTD_AsyncWrite calls that had to wait for a free slot
+} XTD_AsyncWriter;
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+XTD_AIO_FUNC_DECL bool XTD_AsyncWriterInit(XTD_AsyncWriter* writer, const XTD_AsyncWriterDesc* desc);
+// Waits for all the pending requests before stopping the threads
+XTD_AIO_FUNC_DECL void XTD_AsyncWriterFree(XTD_AsyncWriter* writer);
+
+// Queues a request, blocking while queue_depth requests are pending
+XTD_AIO_FUNC_DECL void XTD_AsyncWrite(XTD_AsyncWriter* writer, const XTD_WriteRequest* request);
+// Returns false instead of blocking when the queue is full
+XTD_AIO_FUNC_DECL bool XTD_AsyncTryWrite(XTD_AsyncWriter* writer, const XTD_WriteRequest* request);
+// Waits until every request queued so far completed. Must not run concurrently with another flush.
+XTD_AIO_FUNC_DECL void XTD_AsyncWriterFlush(XTD_AsyncWriter* writer);
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_AIO_IMPLEMENTATION
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <stdio.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+#if defined(__linux__)
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #ifndef __cplusplus
+    // Hidden by unistd.h in strict ISO C modes
+    extern long syscall(long number, ...);
+    #endif
+    #define _XTD_AIO_HAS_IO_URING 1
+#else
+    #define _XTD_AIO_HAS_IO_URING 0
+#endif
+
+#define _XTD_AIO_DEFAULT_QUEUE_DEPTH 64
+#define _XTD_AIO_DEFAULT_THREADS 2
+#define _XTD_AIO_MAX_RING_ENTRIES 4096
+
+// One request being written
+typedef struct {
+    XTD_WriteRequest request;
+#if !defined(_WIN32)
+    struct iovec iov[XTD_AIO_MAX_BUFFERS];
+    u32 iov_count;
+    u32 iov_first;         // First iovec with data left after short writes
+    int fd;
+    u64 offset;
+    usize remaining;
+    const u8* buffered_tail; // Unaligned end of the last buffer, written after dropping O_DIRECT
+    usize buffered_tail_size;
+#endif
+} _XTD_AIOOp;
+
+static void _xtd_AIOComplete(XTD_AsyncWriter* writer, _XTD_AIOOp* op, int result, usize bytes)
+{
+    if (result == 0)
+    {
+        XTD_ATOMIC_FETCH_ADD(&writer->completed, 1);
+        XTD_ATOMIC_FETCH_ADD(&writer->bytes_written, (u64)bytes);
+    } else
+    {
+        XTD_ATOMIC_FETCH_ADD(&writer->failed, 1);
+    }
+    if (op->request.on_done)
+        op->request.on_done(op->request.user, result);
+    XTD_SemaphorePost(&writer->slots, 1);
+}
+
+// The request semaphore was taken so a request is there, but with several producers the
+// queue cell may not be published yet
+static void _xtd_AIOPop(XTD_AsyncWriter* writer, XTD_WriteRequest* request)
+{
+    while (!XTD_MPMCTryPop(&writer->queue, request))
+        XTD_CPU_PAUSE();
+}
+
+static usize _xtd_AIORequestSize(const XTD_WriteRequest* request)
+{
+    usize size = 0;
+    for (u32 i = 0; i < request->buffer_count; i++)
+        size += request->sizes[i];
+    return size;
+}
+
+#if !defined(_WIN32)
+
+#ifdef O_DIRECT
+static bool _xtd_AIOIsDirectAligned(const XTD_WriteRequest* request)
+{
+    for (u32 i = 0; i < request->buffer_count; i++)
+    {
+        bool last = i + 1 == request->buffer_count;
+        if ((uintptr_t)request->buffers[i] % XTD_AIO_DIRECT_ALIGNMENT != 0 ||
+            (!last && request->sizes[i] % XTD_AIO_DIRECT_ALIGNMENT != 0))
+            return false;
+    }
+    return request->buffer_count > 0 && request->sizes[0] >= XTD_AIO_DIRECT_ALIGNMENT;
+}
+#endif
+
+// Opens the file and fills the iovecs. Direct writes split off the unaligned tail, falling
+// back to buffered writes if the file system does not support O_DIRECT.
+static int _xtd_AIOOpen(_XTD_AIOOp* op, bool direct)
+{
+    const XTD_WriteRequest* request = &op->request;
+    XTD_ASSERT(request->buffer_count <= XTD_AIO_MAX_BUFFERS);
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    op->fd = -1;
+#ifdef O_DIRECT
+    direct = direct && _xtd_AIOIsDirectAligned(request);
+    if (direct)
+    {
+        op->fd = open(request->path, flags | O_DIRECT, 0644);
+        if (op->fd < 0 && errno != EINVAL)
+            return errno;
+        direct = op->fd >= 0;
+    }
+#else
+    direct = false;
+#endif
+    if (op->fd < 0)
+        op->fd = open(request->path, flags, 0644);
+    if (op->fd < 0)
+        return errno;
+
+    op->iov_count = 0;
+    op->iov_first = 0;
+    op->offset = 0;
+    op->remaining = 0;
+    op->buffered_tail = NULL;
+    op->buffered_tail_size = 0;
+    for (u32 i = 0; i < request->buffer_count; i++)
+    {
+        usize size = request->sizes[i];
+        if (direct && i + 1 == request->buffer_count)
+        {
+            op->buffered_tail_size = size % XTD_AIO_DIRECT_ALIGNMENT;
+            size -= op->buffered_tail_size;
+            op->buffered_tail = (const u8*)request->buffers[i] + size;
+        }
+        op->iov[op->iov_count].iov_base = (void*)(uintptr_t)request->buffers[i];
+        op->iov[op->iov_count].iov_len = size;
+        op->iov_count++;
+        op->remaining += size;
+    }
+    return 0;
+}
+
+static void _xtd_AIOAdvance(_XTD_AIOOp* op, usize written)
+{
+    op->offset += written;
+    op->remaining -= written;
+    while (written > 0)
+    {
+        struct iovec* iov = &op->iov[op->iov_first];
+        usize n = XTD_MIN(written, (usize)iov->iov_len);
+        iov->iov_base = (u8*)iov->iov_base + n;
+        iov->iov_len -= n;
+        written -= n;
+        if (iov->iov_len == 0)
+            op->iov_first++;
+    }
+}
+
+static int _xtd_AIOFinish(_XTD_AIOOp* op, int result)
+{
+#ifdef O_DIRECT
+    if (result == 0 && op->buffered_tail_size > 0)
+    {
+        // O_DIRECT can't write a partial block
+        int flags = fcntl(op->fd, F_GETFL);
+        if (flags < 0 || fcntl(op->fd, F_SETFL, flags & ~O_DIRECT) < 0)
+        {
+            result = errno;
+        } else
+        {
+            const u8* p = op->buffered_tail;
+            usize left = op->buffered_tail_size;
+            while (left > 0 && result == 0)
+            {
+                // io_uring writes don't move the file position
+                ssize_t n = pwrite(op->fd, p, left, (off_t)op->offset);
+                if (n < 0 && errno != EINTR)
+                {
+                    result = errno;
+                } else if (n > 0)
+                {
+                    p += n;
+                    left -= (usize)n;
+                    op->offset += (u64)n;
+                }
+            }
+        }
+    }
+#endif
+    if (close(op->fd) != 0 && result == 0)
+        result = errno;
+    op->fd = -1;
+    return result;
+}
+
+#endif
+
+////////////////////////////////////////
+//
+//  Thread pool backend
+//
+
+static int _xtd_AIOWriteSync(_XTD_AIOOp* op, bool direct)
+{
+#if defined(_WIN32)
+    (void)direct;
+    FILE* file = fopen(op->request.path, "wb");
+    if (file == NULL)
+        return errno;
+    int result = 0;
+    for (u32 i = 0; i < op->request.buffer_count && result == 0; i++)
+    {
+        if (fwrite(op->request.buffers[i], 1, op->request.sizes[i], file) != op->request.sizes[i])
+            result = errno;
+    }
+    if (fclose(file) != 0 && result == 0)
+        result = errno;
+    return result;
+#else
+    int result = _xtd_AIOOpen(op, direct);
+    if (result != 0)
+        return result;
+    while (op->remaining > 0)
+    {
+        ssize_t n = writev(op->fd, op->iov + op->iov_first, (int)(op->iov_count - op->iov_first));
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            result = errno;
+            break;
+        }
+        _xtd_AIOAdvance(op, (usize)n);
+    }
+    return _xtd_AIOFinish(op, result);
+#endif
+}
+
+static void _xtd_AIOThreadWorker(void* arg)
+{
+    XTD_AsyncWriter* writer = (XTD_AsyncWriter*)arg;
+    _XTD_AIOOp op;
+    for (;;)
+    {
+        XTD_SemaphoreWait(&writer->ready);
+        _xtd_AIOPop(writer, &op.request);
+        if (op.request.path == NULL)
+            break;
+        int result = _xtd_AIOWriteSync(&op, writer->direct);
+        _xtd_AIOComplete(writer, &op, result, _xtd_AIORequestSize(&op.request));
+    }
+}
+
+////////////////////////////////////////
+//
+//  io_uring backend
+//
+
+// A single thread owns the ring: it opens the files, submits a writev per request and reaps
+// the completions, resubmitting the rest of short writes. It only sleeps on the request
+// semaphore when nothing is in flight, otherwise on the completion queue.
+// If io_uring_enter fails for good, the writes the kernel didn't take fail with its errno and
+// the thread keeps going as a single thread of the thread pool backend.
+
+#if _XTD_AIO_HAS_IO_URING
+
+typedef struct {
+    int fd;
+    u32 entries;
+    u32* sq_head;
+    u32* sq_tail;
+    u32* sq_mask;
+    u32* sq_array;
+    struct io_uring_sqe* sqes;
+    u32* cq_head;
+    u32* cq_tail;
+    u32* cq_mask;
+    struct io_uring_cqe* cqes;
+    void* sq_map;
+    usize sq_map_size;
+    void* cq_map;
+    usize cq_map_size;
+    usize sqes_map_size;
+
+    _XTD_AIOOp* ops;
+    u32* free_ops;
+    u32 free_count;
+    u32 in_flight;
+    u32 to_submit;
+    int error; // errno of a failed io_uring_enter, nothing is submitted after it
+} _XTD_AIORing;
+
+static void _xtd_AIORingFree(_XTD_AIORing* ring)
+{
+    if (ring->sqes)
+        munmap(ring->sqes, ring->sqes_map_size);
+    if (ring->cq_map && ring->cq_map != ring->sq_map)
+        munmap(ring->cq_map, ring->cq_map_size);
+    if (ring->sq_map)
+        munmap(ring->sq_map, ring->sq_map_size);
+    if (ring->fd >= 0)
+        close(ring->fd);
+    free(ring->ops);
+    free(ring->free_ops);
+    free(ring);
+}
+
+static _XTD_AIORing* _xtd_AIORingCreate(u32 entries)
+{
+    _XTD_AIORing* ring = (_XTD_AIORing*)calloc(1, sizeof(_XTD_AIORing));
+    if (ring == NULL)
+        return NULL;
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0)
+    {
+        free(ring);
+        return NULL;
+    }
+
+    ring->entries = params.sq_entries;
+    ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_map_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_map)
+        ring->sq_map_size = ring->cq_map_size = XTD_MAX(ring->sq_map_size, ring->cq_map_size);
+
+    void* sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_SQ_RING);
+    ring->sq_map = sq_map == MAP_FAILED ? NULL : sq_map;
+    void* cq_map = single_map ? sq_map : mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_CQ_RING);
+    ring->cq_map = cq_map == MAP_FAILED ? NULL : cq_map;
+    void* sqes = mmap(NULL, ring->sqes_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_SQES);
+    ring->sqes = sqes == MAP_FAILED ? NULL : (struct io_uring_sqe*)sqes;
+    ring->ops = (_XTD_AIOOp*)calloc(ring->entries, sizeof(_XTD_AIOOp));
+    ring->free_ops = (u32*)malloc(ring->entries * sizeof(u32));
+    if (ring->sq_map == NULL || ring->cq_map == NULL || ring->sqes == NULL || ring->ops == NULL || ring->free_ops == NULL)
+    {
+        _xtd_AIORingFree(ring);
+        return NULL;
+    }
+
+    u8* sq = (u8*)ring->sq_map;
+    ring->sq_head = (u32*)(sq + params.sq_off.head);
+    ring->sq_tail = (u32*)(sq + params.sq_off.tail);
+    ring->sq_mask = (u32*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (u32*)(sq + params.sq_off.array);
+    u8* cq = (u8*)ring->cq_map;
+    ring->cq_head = (u32*)(cq + params.cq_off.head);
+    ring->cq_tail = (u32*)(cq + params.cq_off.tail);
+    ring->cq_mask = (u32*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    for (u32 i = 0; i < ring->entries; i++)
+        ring->free_ops[i] = ring->entries - 1 - i;
+    ring->free_count = ring->entries;
+    return ring;
+}
+
+// There is always room in the submission queue, at most 'entries' ops are in flight
+static void _xtd_AIORingQueueWrite(_XTD_AIORing* ring, u32 op_index)
+{
+    _XTD_AIOOp* op = &ring->ops[op_index];
+    u32 tail = *ring->sq_tail;
+    u32 index = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = op->fd;
+    sqe->addr = (u64)(uintptr_t)(op->iov + op->iov_first);
+    sqe->len = op->iov_count - op->iov_first;
+    sqe->off = op->offset;
+    sqe->user_data = op_index;
+    ring->sq_array[index] = index;
+    XTD_ATOMIC_STORE_RELEASE(ring->sq_tail, tail + 1);
+    ring->to_submit++;
+}
+
+static void _xtd_AIORingRelease(_XTD_AIORing* ring, u32 op_index)
+{
+    ring->free_ops[ring->free_count++] = op_index;
+    ring->in_flight--;
+}
+
+static void _xtd_AIORingReap(XTD_AsyncWriter* writer, _XTD_AIORing* ring)
+{
+    u32 head = *ring->cq_head;
+    u32 tail = XTD_ATOMIC_LOAD_ACQUIRE(ring->cq_tail);
+    for (; head != tail; head++)
+    {
+        struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+        u32 op_index = (u32)cqe->user_data;
+        _XTD_AIOOp* op = &ring->ops[op_index];
+        int res = cqe->res;
+        if (res > 0)
+            _xtd_AIOAdvance(op, (usize)res);
+        bool retry = res == -EAGAIN || res == -EINTR || (res > 0 && op->remaining > 0);
+        if (retry && ring->error == 0)
+        {
+            _xtd_AIORingQueueWrite(ring, op_index);
+            continue;
+        }
+        int result = res < 0 ? -res : 0;
+        if (result == 0 && op->remaining > 0)
+            result = ring->error ? ring->error : EIO;
+        result = _xtd_AIOFinish(op, result);
+        _xtd_AIORingRelease(ring, op_index);
+        _xtd_AIOComplete(writer, op, result, _xtd_AIORequestSize(&op->request));
+    }
+    XTD_ATOMIC_STORE_RELEASE(ring->cq_head, head);
+}
+
+// Fails the writes still in the submission queue, the kernel never saw them, and waits for the
+// ones it took. Completions are reaped straight from the mapped queue without entering the ring.
+static void _xtd_AIORingAbandon(XTD_AsyncWriter* writer, _XTD_AIORing* ring, int error)
+{
+    ring->error = error;
+    u32 head = XTD_ATOMIC_LOAD_ACQUIRE(ring->sq_head);
+    for (u32 tail = *ring->sq_tail; head != tail; head++)
+    {
+        u32 op_index = (u32)ring->sqes[head & *ring->sq_mask].user_data;
+        _XTD_AIOOp* op = &ring->ops[op_index];
+        int result = _xtd_AIOFinish(op, error);
+        _xtd_AIORingRelease(ring, op_index);
+        _xtd_AIOComplete(writer, op, result, _xtd_AIORequestSize(&op->request));
+    }
+    ring->to_submit = 0;
+    while (ring->in_flight > 0)
+    {
+        XTD_ThreadYield();
+        _xtd_AIORingReap(writer, ring);
+    }
+}
+
+static void _xtd_AIORingWorker(void* arg)
+{
+    XTD_AsyncWriter* writer = (XTD_AsyncWriter*)arg;
+    _XTD_AIORing* ring = (_XTD_AIORing*)writer->ring;
+    bool exiting = false;
+    for (;;)
+    {
+        while (!exiting && ring->free_count > 0)
+        {
+            if (ring->in_flight == 0)
+                XTD_SemaphoreWait(&writer->ready);
+            else if (!XTD_SemaphoreTryWait(&writer->ready))
+                break;
+
+            u32 op_index = ring->free_ops[--ring->free_count];
+            _XTD_AIOOp* op = &ring->ops[op_index];
+            _xtd_AIOPop(writer, &op->request);
+            ring->in_flight++;
+            if (op->request.path == NULL)
+            {
+                exiting = true;
+                _xtd_AIORingRelease(ring, op_index);
+                break;
+            }
+
+            int result = _xtd_AIOOpen(op, writer->direct);
+            if (result == 0 && op->remaining > 0)
+            {
+                _xtd_AIORingQueueWrite(ring, op_index);
+                continue;
+            }
+            if (result == 0)
+                result = _xtd_AIOFinish(op, 0);
+            _xtd_AIORingRelease(ring, op_index);
+            _xtd_AIOComplete(writer, op, result, _xtd_AIORequestSize(&op->request));
+        }
+        if (ring->in_flight == 0)
+        {
+            if (exiting)
+                break;
+            continue;
+        }
+
+        // Submit everything queued and wait for at least one completion
+        long n = syscall(__NR_io_uring_enter, ring->fd, ring->to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (n >= 0)
+            ring->to_submit -= (u32)n;
+        else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            _xtd_AIORingAbandon(writer, ring, errno);
+            if (!exiting)
+                _xtd_AIOThreadWorker(writer);
+            return;
+        }
+        _xtd_AIORingReap(writer, ring);
+    }
+}
+
+#endif
+
+////////////////////////////////////////
+//
+//  Writer
+//
+
+XTD_AIO_FUNC bool XTD_AsyncWriterInit(XTD_AsyncWriter* writer, const XTD_AsyncWriterDesc* desc)
+{
+    XTD_ZERO_STRUCT(writer);
+    writer->queue_depth = desc->queue_depth ? desc->queue_depth : _XTD_AIO_DEFAULT_QUEUE_DEPTH;
+    writer->direct = desc->direct;
+    writer->backend = desc->backend;
+
+#if _XTD_AIO_HAS_IO_URING
+    if (writer->backend != XTD_AIO_BACKEND_THREADS)
+    {
+        writer->ring = _xtd_AIORingCreate(XTD_MIN(writer->queue_depth, (u32)_XTD_AIO_MAX_RING_ENTRIES));
+        if (writer->ring == NULL && writer->backend == XTD_AIO_BACKEND_IO_URING)
+            return false;
+        writer->backend = writer->ring ? XTD_AIO_BACKEND_IO_URING : XTD_AIO_BACKEND_THREADS;
+    }
+#else
+    if (writer->backend == XTD_AIO_BACKEND_IO_URING)
+        return false;
+    writer->backend = XTD_AIO_BACKEND_THREADS;
+#endif
+    if (writer->backend == XTD_AIO_BACKEND_IO_URING)
+        writer->thread_count = 1;
+    else
+        writer->thread_count = desc->thread_count ? desc->thread_count : _XTD_AIO_DEFAULT_THREADS;
+
+    // Room for the exit requests on top of a full queue
+    writer->threads = (XTD_Thread*)calloc(writer->thread_count, sizeof(XTD_Thread));
+    bool ok = writer->threads != NULL &&
+              XTD_MPMCQueueInit(&writer->queue, sizeof(XTD_WriteRequest), writer->queue_depth + writer->thread_count);
+    XTD_SemaphorePost(&writer->slots, writer->queue_depth);
+
+    XTD_ThreadFunc* worker = _xtd_AIOThreadWorker;
+#if _XTD_AIO_HAS_IO_URING
+    if (writer->backend == XTD_AIO_BACKEND_IO_URING)
+        worker = _xtd_AIORingWorker;
+#endif
+    u32 started = 0;
+    while (ok && started < writer->thread_count)
+    {
+        ok = XTD_ThreadCreate(&writer->threads[started], worker, writer);
+        if (ok)
+            started++;
+    }
+    if (!ok)
+    {
+        writer->thread_count = started;
+        XTD_AsyncWriterFree(writer);
+        return false;
+    }
+    return true;
+}
+
+XTD_AIO_FUNC void XTD_AsyncWriterFree(XTD_AsyncWriter* writer)
+{
+    XTD_AsyncWriterFlush(writer);
+    XTD_WriteRequest exit_request;
+    XTD_ZERO_STRUCT(&exit_request);
+    for (u32 i = 0; i < writer->thread_count; i++)
+    {
+        XTD_MPMCTryPush(&writer->queue, &exit_request);
+        XTD_SemaphorePost(&writer->ready, 1);
+    }
+    for (u32 i = 0; i < writer->thread_count; i++)
+        XTD_ThreadJoin(&writer->threads[i]);
+
+#if _XTD_AIO_HAS_IO_URING
+    if (writer->ring)
+        _xtd_AIORingFree((_XTD_AIORing*)writer->ring);
+#endif
+    if (writer->queue.cells)
+        XTD_MPMCQueueFree(&writer->queue);
+    free(writer->threads);
+    XTD_ZERO_STRUCT(writer);
+}
+
+static void _xtd_AIOPush(XTD_AsyncWriter* writer, const XTD_WriteRequest* request)
+{
+    XTD_ASSERT(request->path != NULL);
+    bool pushed = XTD_MPMCTryPush(&writer->queue, request);
+    XTD_ASSERT(pushed);
+    (void)pushed;
+    XTD_SemaphorePost(&writer->ready, 1);
+}
+
+XTD_AIO_FUNC void XTD_AsyncWrite(XTD_AsyncWriter* writer, const XTD_WriteRequest* request)
+{
+    if (!XTD_SemaphoreTryWait(&writer->slots))
+    {
+        XTD_ATOMIC_FETCH_ADD(&writer->stalls, 1);
+        XTD_SemaphoreWait(&writer->slots);
+    }
+    _xtd_AIOPush(writer, request);
+}
+
+XTD_AIO_FUNC bool XTD_AsyncTryWrite(XTD_AsyncWriter* writer, const XTD_WriteRequest* request)
+{
+    if (!XTD_SemaphoreTryWait(&writer->slots))
+        return false;
+    _xtd_AIOPush(writer, request);
+    return true;
+}
+
+// Owning every slot means nothing is queued or in flight
+XTD_AIO_FUNC void XTD_AsyncWriterFlush(XTD_AsyncWriter* writer)
+{
+    for (u32 i = 0; i < writer->queue_depth; i++)
+        XTD_SemaphoreWait(&writer->slots);
+    XTD_SemaphorePost(&writer->slots, writer->queue_depth);
+}
+
+#undef _XTD_AIO_HAS_IO_URING
+#undef _XTD_AIO_DEFAULT_QUEUE_DEPTH
+#undef _XTD_AIO_DEFAULT_THREADS
+#undef _XTD_AIO_MAX_RING_ENTRIES
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_AIO_HEADER_H
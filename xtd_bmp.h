@@ -4,6 +4,8 @@
 
 // BMP processing module
 // #define XTD_BMP_IMPLEMENTATION to include the implementation
+// The XTD_Image functions are only available when xtd_image.h is included before this header,
+// they need the xtd_image.h implementation for format conversion
 
 #ifndef XTD_BMP_HEADER_H
 #define XTD_BMP_HEADER_H
@@ -61,6 +63,13 @@ XTD_BMP_FUNC_DECL usize XTD_GetBMPFileSize(i32 width, i32 height, i32 bytes_per_
 XTD_BMP_FUNC_DECL void XTD_WriteBMPToMem(void* out_buffer, i32 width, i32 height, int bytes_per_pixel, u8* pixels);
 XTD_BMP_FUNC_DECL int XTD_WriteBMPToFile(void* out_file, i32 width, i32 height, int bytes_per_pixel, u8* pixels);
 
+#ifdef XTD_IMAGE_HEADER_H
+// Write any image view as a 32 bit BMP with row 0 at the top, padding between rows is skipped.
+// The buffer must hold XTD_GetBMPFileSize(img->width, img->height, 4) bytes.
+XTD_BMP_FUNC_DECL void XTD_WriteBMPImageToMem(void* out_buffer, const XTD_Image* img);
+XTD_BMP_FUNC_DECL int XTD_WriteBMPImageToFile(void* out_file, const XTD_Image* img);
+#endif
+
 ////////////////////////////////////////
 ////////////////////////////////////////
 //
@@ -70,6 +79,7 @@ XTD_BMP_FUNC_DECL int XTD_WriteBMPToFile(void* out_file, i32 width, i32 height,
 #ifdef XTD_BMP_IMPLEMENTATION
 
 #include <errno.h>
+#include <stdlib.h>
 
 XTD_BMP_FUNC usize XTD_GetBMPFileSize(i32 width, i32 height, i32 bytes_per_pixel)
 {
@@ -119,6 +129,63 @@ XTD_BMP_FUNC int XTD_WriteBMPToFile(void* out_file, i32 width, i32 height, int b
     return 0;
 }
 
+#ifdef XTD_IMAGE_HEADER_H
+
+// BMP rows are stored bottom up, each one is converted straight into place as BGRA
+XTD_BMP_FUNC void XTD_WriteBMPImageToMem(void* out_buffer, const XTD_Image* img)
+{
+    XTDB_BMPHeader* header = (XTDB_BMPHeader*)out_buffer;
+    XTD_ZERO_STRUCT(header);
+    _xtd_FillBMPHeader(header, img->width, img->height, 4);
+
+    u8* data = (u8*)(header + 1);
+    usize row_size = (usize)img->width * 4;
+    for (i32 y = 0; y < img->height; y++)
+    {
+        XTD_Image dst_row = XTD_ImageWrap(data + (usize)(img->height - 1 - y) * row_size, img->width, 1, row_size, XTD_PIXEL_BGRA8);
+        XTD_Image src_row = XTD_ImageSubView(img, 0, y, img->width, 1);
+        XTD_ImageCopy(&dst_row, &src_row);
+    }
+}
+
+XTD_BMP_FUNC int XTD_WriteBMPImageToFile(void* out_file, const XTD_Image* img)
+{
+    XTDB_BMPHeader header;
+    XTD_ZERO_STRUCT(&header);
+    _xtd_FillBMPHeader(&header, img->width, img->height, 4);
+
+    usize n = fwrite(&header, sizeof(header), 1, (FILE*)out_file);
+    if (n != 1)
+        return errno;
+
+    usize row_size = (usize)img->width * 4;
+    u8* buffer = img->format == XTD_PIXEL_BGRA8 ? NULL : (u8*)malloc(row_size);
+    if (img->format != XTD_PIXEL_BGRA8 && buffer == NULL)
+        return ENOMEM;
+
+    int result = 0;
+    for (i32 y = img->height - 1; y >= 0; y--)
+    {
+        const u8* row = XTD_ImageRow(img, y);
+        if (buffer)
+        {
+            XTD_Image dst_row = XTD_ImageWrap(buffer, img->width, 1, row_size, XTD_PIXEL_BGRA8);
+            XTD_Image src_row = XTD_ImageSubView(img, 0, y, img->width, 1);
+            XTD_ImageCopy(&dst_row, &src_row);
+            row = buffer;
+        }
+        if (fwrite(row, 1, row_size, (FILE*)out_file) != row_size)
+        {
+            result = errno;
+            break;
+        }
+    }
+    free(buffer);
+    return result;
+}
+
+#endif // XTD_IMAGE_HEADER_H
+
 #endif
 
 ////////////////////////////////////////
@@ -0,0 +1,510 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Bounding volume hierarchy module
+// #define XTD_BVH_IMPLEMENTATION to include the implementation
+// Depends on xtd_geom.h, xtd_dyn.h and xtd_thread.h for the parallel build
+
+#ifndef XTD_BVH_HEADER_H
+#define XTD_BVH_HEADER_H
+
+#ifndef XTD_BVH_FUNC
+#define XTD_BVH_FUNC
+#endif
+
+#ifndef XTD_BVH_FUNC_DECL
+#define XTD_BVH_FUNC_DECL extern
+#endif
+
+#include "xtd_common.h"
+#include "xtd_geom.h"
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  BVH
+//
+
+// Binary BVH built with binned SAH and flattened in depth-first order, so the first
+// child of an interior node is always the next node.
+// Builds split the top of the tree serially and then build the subtrees in parallel.
+// Traversal uses a fixed stack of XTD_BVH_MAX_DEPTH entries, the build keeps the tree
+// within that depth by falling back to median splits.
+
+#define XTD_BVH_BIN_COUNT 16
+#define XTD_BVH_MAX_LEAF_SIZE 8
+#define XTD_BVH_MAX_DEPTH 64
+
+typedef struct {
+    V3f min;
+    u32 offset;     // Leaf: first entry in prim_indices, interior: index of the second child
+    V3f max;
+    u16 prim_count; // 0 for interior nodes
+    u8 axis;        // Split axis, traversal visits the near child first
+    u8 pad;
+} XTD_BvhNode;
+
+XTD_STATIC_ASSERT(sizeof(XTD_BvhNode) == 32);
+
+typedef struct {
+    XTD_BvhNode* nodes;
+    u32 node_count;
+    u32 prim_count;
+    u32* prim_indices; // Primitive index of each leaf entry
+} XTD_Bvh;
+
+typedef struct {
+    f32 t;
+    f32 u, v; // Barycentric weights of the second and third vertex
+    u32 prim;
+} XTD_BvhHit;
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+// thread_count 0 uses one thread per CPU, 1 builds on the calling thread only
+XTD_BVH_FUNC_DECL bool XTD_BvhBuild(XTD_Bvh* bvh, const AABB3f* prim_bounds, u32 prim_count, u32 thread_count);
+XTD_BVH_FUNC_DECL void XTD_BvhFree(XTD_Bvh* bvh);
+
+// Triangle i uses vertices[indices[3 * i + k]], or vertices[3 * i + k] when indices is NULL
+XTD_BVH_FUNC_DECL bool XTD_BvhBuildTriangles(XTD_Bvh* bvh, const V3f* vertices, const u32* indices, u32 tri_count, u32 thread_count);
+XTD_BVH_FUNC_DECL bool XTD_BvhClosestHitTriangles(const XTD_Bvh* bvh, const V3f* vertices, const u32* indices, const Ray3f* ray, XTD_BvhHit* hit);
+XTD_BVH_FUNC_DECL bool XTD_BvhAnyHitTriangles(const XTD_Bvh* bvh, const V3f* vertices, const u32* indices, const Ray3f* ray);
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_BVH_IMPLEMENTATION
+
+#include "xtd_dyn.h"
+#include "xtd_thread.h"
+
+// Placeholder for a subtree that is built by a parallel task, offset is the task index
+#define _XTD_BVH_TASK_AXIS 0xFF
+
+typedef struct {
+    XTD_BvhNode* items;
+    usize capacity;
+    usize count;
+} _XTD_BvhNodeArray;
+
+typedef struct {
+    u32 begin;
+    u32 end;
+    u32 depth;
+    _XTD_BvhNodeArray nodes;
+} _XTD_BvhTask;
+
+typedef struct {
+    _XTD_BvhTask* items;
+    usize capacity;
+    usize count;
+} _XTD_BvhTaskArray;
+
+typedef struct {
+    const AABB3f* bounds;
+    V3f* centroids;
+    u32* indices;
+    u32 task_threshold; // Ranges this small become parallel tasks, 0 while building them
+    _XTD_BvhTaskArray tasks;
+} _XTD_BvhBuilder;
+
+typedef struct {
+    AABB3f bounds;
+    u32 count;
+} _XTD_BvhBin;
+
+static u32 _xtd_BvhLog2Ceil(u32 x)
+{
+    return x <= 1 ? 0 : 32 - XTD_CLZ32(x - 1);
+}
+
+static u32 _xtd_BvhBinIndex(f32 c, f32 min, f32 scale)
+{
+    i32 bin = (i32)((c - min) * scale);
+    return (u32)XTD_MIN(XTD_MAX(bin, 0), XTD_BVH_BIN_COUNT - 1);
+}
+
+static void _xtd_BvhBuildNode(_XTD_BvhBuilder* b, _XTD_BvhNodeArray* nodes, u32 begin, u32 end, u32 depth)
+{
+    u32 node_index = (u32)nodes->count;
+    XTD_BvhNode node;
+    XTD_ZERO_STRUCT(&node);
+    XTD_DA_PUSH(*nodes, node);
+
+    AABB3f bounds = aabbEmpty3f();
+    AABB3f cbounds = aabbEmpty3f();
+    for (u32 i = begin; i < end; i++)
+    {
+        u32 prim = b->indices[i];
+        bounds = aabbUnion3f(bounds, b->bounds[prim]);
+        cbounds = aabbExpand3f(cbounds, b->centroids[prim]);
+    }
+    nodes->items[node_index].min = bounds.min;
+    nodes->items[node_index].max = bounds.max;
+
+    u32 count = end - begin;
+    if (b->task_threshold != 0 && count <= b->task_threshold)
+    {
+        _XTD_BvhTask task;
+        XTD_ZERO_STRUCT(&task);
+        task.begin = begin;
+        task.end = end;
+        task.depth = depth;
+        nodes->items[node_index].offset = (u32)b->tasks.count;
+        nodes->items[node_index].axis = _XTD_BVH_TASK_AXIS;
+        XTD_DA_PUSH(b->tasks, task);
+        return;
+    }
+
+    if (count == 1)
+    {
+        nodes->items[node_index].offset = begin;
+        nodes->items[node_index].prim_count = 1;
+        return;
+    }
+
+    // Binned SAH over the centroid bounds of every axis
+    f32 best_cost = FLT_MAX;
+    u32 best_axis = 0;
+    u32 best_split = 0;
+    bool median_split = depth + _xtd_BvhLog2Ceil(count) >= XTD_BVH_MAX_DEPTH - 1;
+    for (u32 axis = 0; axis < 3 && !median_split; axis++)
+    {
+        f32 cmin = cbounds.min.e[axis];
+        f32 extent = cbounds.max.e[axis] - cmin;
+        if (extent <= 0.0f)
+            continue;
+
+        _XTD_BvhBin bins[XTD_BVH_BIN_COUNT];
+        for (u32 i = 0; i < XTD_BVH_BIN_COUNT; i++)
+        {
+            bins[i].bounds = aabbEmpty3f();
+            bins[i].count = 0;
+        }
+
+        f32 scale = XTD_BVH_BIN_COUNT / extent;
+        for (u32 i = begin; i < end; i++)
+        {
+            u32 prim = b->indices[i];
+            _XTD_BvhBin* bin = &bins[_xtd_BvhBinIndex(b->centroids[prim].e[axis], cmin, scale)];
+            bin->bounds = aabbUnion3f(bin->bounds, b->bounds[prim]);
+            bin->count++;
+        }
+
+        // Sweep from the right storing the cost of each right side, then from the left
+        f32 right_cost[XTD_BVH_BIN_COUNT];
+        AABB3f acc = aabbEmpty3f();
+        u32 acc_count = 0;
+        for (u32 i = XTD_BVH_BIN_COUNT - 1; i > 0; i--)
+        {
+            acc = aabbUnion3f(acc, bins[i].bounds);
+            acc_count += bins[i].count;
+            right_cost[i] = acc_count ? aabbSurfaceArea3f(acc) * (f32)acc_count : FLT_MAX;
+        }
+
+        acc = aabbEmpty3f();
+        acc_count = 0;
+        for (u32 i = 0; i < XTD_BVH_BIN_COUNT - 1; i++)
+        {
+            acc = aabbUnion3f(acc, bins[i].bounds);
+            acc_count += bins[i].count;
+            if (acc_count == 0 || right_cost[i + 1] == FLT_MAX)
+                continue;
+            f32 cost = aabbSurfaceArea3f(acc) * (f32)acc_count + right_cost[i + 1];
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_axis = axis;
+                best_split = i;
+            }
+        }
+    }
+
+    u32 mid;
+    if (best_cost == FLT_MAX)
+    {
+        // Degenerate centroids or too deep, split the range in half
+        if (count <= XTD_BVH_MAX_LEAF_SIZE && !median_split)
+        {
+            nodes->items[node_index].offset = begin;
+            nodes->items[node_index].prim_count = (u16)count;
+            return;
+        }
+        mid = begin + count / 2;
+    } else
+    {
+        // Split cost relative to intersecting every primitive, one traversal step costs about one test
+        f32 area = aabbSurfaceArea3f(bounds);
+        f32 split_cost = 1.0f + (area > 0.0f ? best_cost / area : (f32)count);
+        if (count <= XTD_BVH_MAX_LEAF_SIZE && (f32)count <= split_cost)
+        {
+            nodes->items[node_index].offset = begin;
+            nodes->items[node_index].prim_count = (u16)count;
+            return;
+        }
+
+        f32 cmin = cbounds.min.e[best_axis];
+        f32 scale = XTD_BVH_BIN_COUNT / (cbounds.max.e[best_axis] - cmin);
+        u32 i = begin;
+        u32 j = end;
+        while (i < j)
+        {
+            u32 prim = b->indices[i];
+            if (_xtd_BvhBinIndex(b->centroids[prim].e[best_axis], cmin, scale) <= best_split)
+            {
+                i++;
+            } else
+            {
+                b->indices[i] = b->indices[--j];
+                b->indices[j] = prim;
+            }
+        }
+        mid = i;
+        nodes->items[node_index].axis = (u8)best_axis;
+    }
+
+    _xtd_BvhBuildNode(b, nodes, begin, mid, depth + 1);
+    nodes->items[node_index].offset = (u32)nodes->count;
+    _xtd_BvhBuildNode(b, nodes, mid, end, depth + 1);
+}
+
+static void _xtd_BvhSubtreeTask(void* user, u32 task_index, u32 task_count)
+{
+    (void)task_count;
+    _XTD_BvhBuilder* b = (_XTD_BvhBuilder*)user;
+    _XTD_BvhTask* task = &b->tasks.items[task_index];
+    XTD_DA_RESERVE(task->nodes, 2 * (usize)(task->end - task->begin));
+    _xtd_BvhBuildNode(b, &task->nodes, task->begin, task->end, task->depth);
+}
+
+// Copies the top level nodes in depth-first order, replacing placeholders by their subtrees
+static void _xtd_BvhEmit(_XTD_BvhNodeArray* out, const _XTD_BvhNodeArray* top, u32 index, const _XTD_BvhTaskArray* tasks)
+{
+    XTD_BvhNode node = top->items[index];
+    if (node.prim_count == 0 && node.axis == _XTD_BVH_TASK_AXIS)
+    {
+        const _XTD_BvhNodeArray* sub = &tasks->items[node.offset].nodes;
+        u32 base = (u32)out->count;
+        for (usize i = 0; i < sub->count; i++)
+        {
+            XTD_BvhNode n = sub->items[i];
+            if (n.prim_count == 0)
+                n.offset += base;
+            out->items[out->count++] = n;
+        }
+        return;
+    }
+
+    u32 out_index = (u32)out->count;
+    out->items[out->count++] = node;
+    if (node.prim_count > 0)
+        return;
+    _xtd_BvhEmit(out, top, index + 1, tasks);
+    out->items[out_index].offset = (u32)out->count;
+    _xtd_BvhEmit(out, top, node.offset, tasks);
+}
+
+XTD_BVH_FUNC bool XTD_BvhBuild(XTD_Bvh* bvh, const AABB3f* prim_bounds, u32 prim_count, u32 thread_count)
+{
+    XTD_ZERO_STRUCT(bvh);
+    if (prim_count == 0)
+        return true;
+
+    _XTD_BvhBuilder b;
+    XTD_ZERO_STRUCT(&b);
+    b.bounds = prim_bounds;
+    b.centroids = (V3f*)malloc(prim_count * sizeof(V3f));
+    b.indices = (u32*)malloc(prim_count * sizeof(u32));
+    if (b.centroids == NULL || b.indices == NULL)
+    {
+        free(b.centroids);
+        free(b.indices);
+        return false;
+    }
+
+    for (u32 i = 0; i < prim_count; i++)
+    {
+        b.centroids[i] = aabbCenter3f(prim_bounds[i]);
+        b.indices[i] = i;
+    }
+
+    if (thread_count == 0)
+        thread_count = XTD_GetCPUCount();
+
+    // Enough subtrees per thread to balance uneven splits, small inputs are built serially
+    if (thread_count > 1 && prim_count >= 4096)
+        b.task_threshold = XTD_MAX(prim_count / (thread_count * 8), 1024u);
+
+    _XTD_BvhNodeArray top;
+    XTD_ZERO_STRUCT(&top);
+    XTD_DA_RESERVE(top, b.task_threshold ? 64 : 2 * (usize)prim_count);
+    _xtd_BvhBuildNode(&b, &top, 0, prim_count, 0);
+
+    _XTD_BvhNodeArray nodes = top;
+    if (b.tasks.count > 0)
+    {
+        b.task_threshold = 0;
+        XTD_ParallelFor((u32)b.tasks.count, thread_count, _xtd_BvhSubtreeTask, &b);
+
+        usize total = top.count;
+        for (usize i = 0; i < b.tasks.count; i++)
+            total += b.tasks.items[i].nodes.count;
+
+        XTD_ZERO_STRUCT(&nodes);
+        XTD_DA_RESERVE(nodes, total);
+        _xtd_BvhEmit(&nodes, &top, 0, &b.tasks);
+
+        for (usize i = 0; i < b.tasks.count; i++)
+            XTD_DA_FREE(b.tasks.items[i].nodes);
+        XTD_DA_FREE(b.tasks);
+        XTD_DA_FREE(top);
+    }
+
+    free(b.centroids);
+    bvh->nodes = nodes.items;
+    bvh->node_count = (u32)nodes.count;
+    bvh->prim_count = prim_count;
+    bvh->prim_indices = b.indices;
+    return true;
+}
+
+XTD_BVH_FUNC void XTD_BvhFree(XTD_Bvh* bvh)
+{
+    XTD_DYN_FREE(bvh->nodes);
+    free(bvh->prim_indices);
+    XTD_ZERO_STRUCT(bvh);
+}
+
+static void _xtd_BvhTriangle(const V3f* vertices, const u32* indices, u32 tri, V3f* a, V3f* b, V3f* c)
+{
+    if (indices)
+    {
+        *a = vertices[indices[3 * tri + 0]];
+        *b = vertices[indices[3 * tri + 1]];
+        *c = vertices[indices[3 * tri + 2]];
+    } else
+    {
+        *a = vertices[3 * tri + 0];
+        *b = vertices[3 * tri + 1];
+        *c = vertices[3 * tri + 2];
+    }
+}
+
+XTD_BVH_FUNC bool XTD_BvhBuildTriangles(XTD_Bvh* bvh, const V3f* vertices, const u32* indices, u32 tri_count, u32 thread_count)
+{
+    AABB3f* bounds = (AABB3f*)malloc((usize)tri_count * sizeof(AABB3f));
+    if (bounds == NULL && tri_count > 0)
+    {
+        XTD_ZERO_STRUCT(bvh);
+        return false;
+    }
+
+    for (u32 i = 0; i < tri_count; i++)
+    {
+        V3f a, b, c;
+        _xtd_BvhTriangle(vertices, indices, i, &a, &b, &c);
+        bounds[i] = aabbExpand3f(aabbExpand3f(aabb3f(a, a), b), c);
+    }
+
+    bool ok = XTD_BvhBuild(bvh, bounds, tri_count, thread_count);
+    free(bounds);
+    return ok;
+}
+
+// Shared traversal, any_hit stops at the first intersection found
+static bool _xtd_BvhTraverseTriangles(const XTD_Bvh* bvh, const V3f* vertices, const u32* indices, const Ray3f* ray_in,
+                                      XTD_BvhHit* hit, bool any_hit)
+{
+    if (bvh->node_count == 0)
+        return false;
+
+    Ray3f ray = *ray_in;
+    u32 dir_neg[3] = {ray.inv_dir.x < 0.0f, ray.inv_dir.y < 0.0f, ray.inv_dir.z < 0.0f};
+    u32 stack[XTD_BVH_MAX_DEPTH];
+    u32 stack_size = 0;
+    u32 current = 0;
+    bool found = false;
+
+    for (;;)
+    {
+        const XTD_BvhNode* node = &bvh->nodes[current];
+        if (rayAABB3f(&ray, aabb3f(node->min, node->max), NULL))
+        {
+            if (node->prim_count == 0)
+            {
+                // Visit the child on the near side of the split first
+                if (dir_neg[node->axis])
+                {
+                    stack[stack_size++] = current + 1;
+                    current = node->offset;
+                } else
+                {
+                    stack[stack_size++] = node->offset;
+                    current = current + 1;
+                }
+                continue;
+            }
+
+            for (u32 i = 0; i < node->prim_count; i++)
+            {
+                u32 tri = bvh->prim_indices[node->offset + i];
+                V3f a, b, c;
+                f32 t, u, v;
+                _xtd_BvhTriangle(vertices, indices, tri, &a, &b, &c);
+                if (rayTriangle3f(&ray, a, b, c, &t, &u, &v))
+                {
+                    found = true;
+                    if (any_hit)
+                        return true;
+                    ray.t_max = t;
+                    hit->t = t;
+                    hit->u = u;
+                    hit->v = v;
+                    hit->prim = tri;
+                }
+            }
+        }
+
+        if (stack_size == 0)
+            break;
+        current = stack[--stack_size];
+    }
+    return found;
+}
+
+XTD_BVH_FUNC bool XTD_BvhClosestHitTriangles(const XTD_Bvh* bvh, const V3f* vertices, const u32* indices, const Ray3f* ray, XTD_BvhHit* hit)
+{
+    return _xtd_BvhTraverseTriangles(bvh, vertices, indices, ray, hit, false);
+}
+
+XTD_BVH_FUNC bool XTD_BvhAnyHitTriangles(const XTD_Bvh* bvh, const V3f* vertices, const u32* indices, const Ray3f* ray)
+{
+    return _xtd_BvhTraverseTriangles(bvh, vertices, indices, ray, NULL, true);
+}
+
+#undef _XTD_BVH_TASK_AXIS
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_BVH_HEADER_H
@@ -3,13 +3,21 @@
 // by Marcos Oviedo Rodríguez
 
 // Common header
-// Does not need an implementation macro (XTD_COMMON_IMPL) yet.
+// #define XTD_COMMON_IMPLEMENTATION in one file for the aligned allocator, the rest is inline.
 
 // Assumes existence of libc, __STDC_HOSTED__ == 1
 
 #ifndef XTD_COMMON_HEADER_H
 #define XTD_COMMON_HEADER_H
 
+#ifndef XTD_COMMON_FUNC
+#define XTD_COMMON_FUNC
+#endif
+
+#ifndef XTD_COMMON_FUNC_DECL
+#define XTD_COMMON_FUNC_DECL extern
+#endif
+
 // C++ compatibility
 #ifdef __cplusplus
 extern "C" {
@@ -89,6 +97,37 @@ extern "C" {
     #define XTD_TYPEOF(X)
 #endif
 
+// Instruction sets enabled at compile time (e.g. -mavx2 or /arch:AVX2)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define XTD_HAS_SSE2 1
+#else
+    #define XTD_HAS_SSE2 0
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+    #define XTD_HAS_SSE41 1
+#else
+    #define XTD_HAS_SSE41 0
+#endif
+
+#if defined(__AVX2__)
+    #define XTD_HAS_AVX2 1
+#else
+    #define XTD_HAS_AVX2 0
+#endif
+
+#if defined(__F16C__)
+    #define XTD_HAS_F16C 1
+#else
+    #define XTD_HAS_F16C 0
+#endif
+
+#if defined(__BMI2__)
+    #define XTD_HAS_BMI2 1
+#else
+    #define XTD_HAS_BMI2 0
+#endif
+
 ////////////////////////////////////////
 //
 //  Utility Macros
@@ -215,6 +254,125 @@ typedef double f64;
 #define XTD_TOGGLEBITMASK(var, mask) ((var) ^= (mask))
 #define XTD_BITBLOCK(size) ((1ULL << (size)) - 1ULL)
 
+// Bit counting, undefined for x == 0 (except popcount)
+
+#if XTD_IS_COMPILER_CLANG || XTD_IS_COMPILER_GCC
+    #define XTD_POPCOUNT32(x) ((u32)__builtin_popcount((u32)(x)))
+    #define XTD_POPCOUNT64(x) ((u32)__builtin_popcountll((u64)(x)))
+    #define XTD_CTZ32(x) ((u32)__builtin_ctz((u32)(x)))
+    #define XTD_CTZ64(x) ((u32)__builtin_ctzll((u64)(x)))
+    #define XTD_CLZ32(x) ((u32)__builtin_clz((u32)(x)))
+    #define XTD_CLZ64(x) ((u32)__builtin_clzll((u64)(x)))
+#elif XTD_IS_COMPILER_MSVC
+    #include <intrin.h>
+    XTD_FORCE_INLINE u32 _XTD_Ctz32(u32 x) { unsigned long i; _BitScanForward(&i, x); return (u32)i; }
+    XTD_FORCE_INLINE u32 _XTD_Clz32(u32 x) { unsigned long i; _BitScanReverse(&i, x); return 31 - (u32)i; }
+    #if defined(_M_X64) || defined(_M_ARM64)
+    XTD_FORCE_INLINE u32 _XTD_Ctz64(u64 x) { unsigned long i; _BitScanForward64(&i, x); return (u32)i; }
+    XTD_FORCE_INLINE u32 _XTD_Clz64(u64 x) { unsigned long i; _BitScanReverse64(&i, x); return 63 - (u32)i; }
+    #else
+    XTD_FORCE_INLINE u32 _XTD_Ctz64(u64 x) { return (u32)x ? _XTD_Ctz32((u32)x) : 32 + _XTD_Ctz32((u32)(x >> 32)); }
+    XTD_FORCE_INLINE u32 _XTD_Clz64(u64 x) { return (x >> 32) ? _XTD_Clz32((u32)(x >> 32)) : 32 + _XTD_Clz32((u32)x); }
+    #endif
+    // Portable SWAR popcount, __popcnt requires the POPCNT instruction
+    XTD_FORCE_INLINE u32 _XTD_PopCount64(u64 x) {
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return (u32)((x * 0x0101010101010101ULL) >> 56);
+    }
+    #define XTD_POPCOUNT32(x) _XTD_PopCount64((u32)(x))
+    #define XTD_POPCOUNT64(x) _XTD_PopCount64((u64)(x))
+    #define XTD_CTZ32(x) _XTD_Ctz32((u32)(x))
+    #define XTD_CTZ64(x) _XTD_Ctz64((u64)(x))
+    #define XTD_CLZ32(x) _XTD_Clz32((u32)(x))
+    #define XTD_CLZ64(x) _XTD_Clz64((u64)(x))
+#else
+    #warning XTD_POPCOUNT/XTD_CTZ/XTD_CLZ not defined for this compiler
+#endif
+
+// Morton (Z-order) codes, interleaving coordinate bits with x in the lowest bit.
+// 2D takes 16 bit coordinates, 3D takes 10 bit coordinates, higher bits are ignored.
+// Uses BMI2 pdep/pext when enabled (slow on AMD before Zen 3, disable -mbmi2 there).
+
+#if XTD_HAS_BMI2
+    #if XTD_IS_COMPILER_MSVC
+        #include <intrin.h>
+    #else
+        #include <immintrin.h>
+    #endif
+#endif
+
+XTD_FORCE_INLINE u32 XTD_MortonEncode2D(u32 x, u32 y) {
+#if XTD_HAS_BMI2
+    return _pdep_u32(x, 0x55555555) | _pdep_u32(y, 0xAAAAAAAA);
+#else
+    u32 r[2] = {x & 0xFFFF, y & 0xFFFF};
+    for (int i = 0; i < 2; i++)
+    {
+        r[i] = (r[i] | (r[i] << 8)) & 0x00FF00FF;
+        r[i] = (r[i] | (r[i] << 4)) & 0x0F0F0F0F;
+        r[i] = (r[i] | (r[i] << 2)) & 0x33333333;
+        r[i] = (r[i] | (r[i] << 1)) & 0x55555555;
+    }
+    return r[0] | (r[1] << 1);
+#endif
+}
+
+XTD_FORCE_INLINE void XTD_MortonDecode2D(u32 code, u32* x, u32* y) {
+#if XTD_HAS_BMI2
+    *x = _pext_u32(code, 0x55555555);
+    *y = _pext_u32(code, 0xAAAAAAAA);
+#else
+    u32 r[2] = {code & 0x55555555, (code >> 1) & 0x55555555};
+    for (int i = 0; i < 2; i++)
+    {
+        r[i] = (r[i] | (r[i] >> 1)) & 0x33333333;
+        r[i] = (r[i] | (r[i] >> 2)) & 0x0F0F0F0F;
+        r[i] = (r[i] | (r[i] >> 4)) & 0x00FF00FF;
+        r[i] = (r[i] | (r[i] >> 8)) & 0x0000FFFF;
+    }
+    *x = r[0];
+    *y = r[1];
+#endif
+}
+
+XTD_FORCE_INLINE u32 XTD_MortonEncode3D(u32 x, u32 y, u32 z) {
+#if XTD_HAS_BMI2
+    return _pdep_u32(x, 0x09249249) | _pdep_u32(y, 0x12492492) | _pdep_u32(z, 0x24924924);
+#else
+    u32 r[3] = {x & 0x3FF, y & 0x3FF, z & 0x3FF};
+    for (int i = 0; i < 3; i++)
+    {
+        r[i] = (r[i] | (r[i] << 16)) & 0xFF0000FF;
+        r[i] = (r[i] | (r[i] << 8)) & 0x0300F00F;
+        r[i] = (r[i] | (r[i] << 4)) & 0x030C30C3;
+        r[i] = (r[i] | (r[i] << 2)) & 0x09249249;
+    }
+    return r[0] | (r[1] << 1) | (r[2] << 2);
+#endif
+}
+
+XTD_FORCE_INLINE void XTD_MortonDecode3D(u32 code, u32* x, u32* y, u32* z) {
+#if XTD_HAS_BMI2
+    *x = _pext_u32(code, 0x09249249);
+    *y = _pext_u32(code, 0x12492492);
+    *z = _pext_u32(code, 0x24924924);
+#else
+    u32 r[3] = {code & 0x09249249, (code >> 1) & 0x09249249, (code >> 2) & 0x09249249};
+    for (int i = 0; i < 3; i++)
+    {
+        r[i] = (r[i] | (r[i] >> 2)) & 0x030C30C3;
+        r[i] = (r[i] | (r[i] >> 4)) & 0x0300F00F;
+        r[i] = (r[i] | (r[i] >> 8)) & 0xFF0000FF;
+        r[i] = (r[i] | (r[i] >> 16)) & 0x000003FF;
+    }
+    *x = r[0];
+    *y = r[1];
+    *z = r[2];
+#endif
+}
+
 ////////////////////////////////////////
 //
 //  Defineable Functions
@@ -256,6 +414,445 @@ typedef double f64;
 #define XTD_ZERO_STRUCT(struct_ptr) XTD_ZERO_MEM((struct_ptr), sizeof(*(struct_ptr)))
 #define XTD_ZERO_FIXEDARRAY(fixed_array) XTD_ZERO_MEM((fixed_array), sizeof(fixed_array))
 
+// Aligned Allocation
+// XTD_AlignedAlloc returns size bytes aligned to a power of two, freed with XTD_AlignedFree.
+// Blocks of XTD_LARGE_PAGE_SIZE or more are mapped from the OS on Linux and other Unix
+// systems (heap blocks elsewhere). With XTD_ALLOC_LARGE_PAGES they use explicit 2 MiB pages
+// when some are reserved (vm.nr_hugepages), or are 2 MiB aligned and marked MADV_HUGEPAGE
+// for transparent huge pages, so sweeping a big buffer misses the TLB 512 times less.
+// Mapped memory is not touched here, pages get placed on the NUMA node of the thread that
+// writes them first (see XTD_FirstTouchRange in xtd_thread.h).
+// Both functions live in the XTD_COMMON_IMPLEMENTATION file, so a block is always freed by
+// the code that allocated it whatever the feature macros of the calling file.
+
+#define XTD_PAGE_SIZE XTD_KB(4)
+#define XTD_LARGE_PAGE_SIZE XTD_MB(2)
+
+#define XTD_ALLOC_ZEROED      (1u << 0) // Memory starts zeroed (free for mapped blocks)
+#define XTD_ALLOC_LARGE_PAGES (1u << 1) // Back mapped blocks with 2 MiB pages if possible
+
+XTD_COMMON_FUNC_DECL void* XTD_AlignedAlloc(usize size, usize alignment, u32 flags);
+XTD_COMMON_FUNC_DECL void XTD_AlignedFree(void* block);
+
+////////////////////////////////////////
+//
+//  Concurrency
+//
+
+#define XTD_CACHE_LINE_SIZE 64
+
+#if XTD_IS_COMPILER_MSVC
+    #define XTD_ALIGNAS(n) __declspec(align(n))
+#elif XTD_IS_COMPILER_CLANG || XTD_IS_COMPILER_GCC
+    #define XTD_ALIGNAS(n) __attribute__((aligned(n)))
+#else
+    #warning XTD_ALIGNAS not defined for this compiler
+#endif
+
+// Keeps independently written fields on their own cache line to avoid false sharing.
+// Padding a struct member by the bytes used since the last line boundary:
+//   usize head; XTD_CACHE_PAD(_pad0, sizeof(usize));
+#define XTD_CACHE_ALIGNED XTD_ALIGNAS(XTD_CACHE_LINE_SIZE)
+#define XTD_CACHE_PAD(name, used_bytes) u8 name[XTD_CACHE_LINE_SIZE - ((used_bytes) % XTD_CACHE_LINE_SIZE)]
+
+// Atomics
+// Work on naturally aligned 32 and 64 bit integers (and pointer sized ones).
+// XTD_ATOMIC_CAS writes the current value to *expected_ptr on failure.
+
+#if XTD_IS_COMPILER_CLANG || XTD_IS_COMPILER_GCC
+    #define XTD_ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+    #define XTD_ATOMIC_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+    #define XTD_ATOMIC_LOAD_RELAXED(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+    #define XTD_ATOMIC_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+    #define XTD_ATOMIC_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+    #define XTD_ATOMIC_STORE_RELAXED(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+    #define XTD_ATOMIC_CAS(ptr, expected_ptr, desired) \
+        __atomic_compare_exchange_n((ptr), (expected_ptr), (desired), 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+    #define XTD_ATOMIC_CAS_WEAK(ptr, expected_ptr, desired) \
+        __atomic_compare_exchange_n((ptr), (expected_ptr), (desired), 1, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+    #define XTD_ATOMIC_EXCHANGE(ptr, val) __atomic_exchange_n((ptr), (val), __ATOMIC_SEQ_CST)
+    #define XTD_ATOMIC_FETCH_ADD(ptr, val) __atomic_fetch_add((ptr), (val), __ATOMIC_SEQ_CST)
+    #define XTD_ATOMIC_FETCH_SUB(ptr, val) __atomic_fetch_sub((ptr), (val), __ATOMIC_SEQ_CST)
+    #define XTD_ATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif XTD_IS_COMPILER_MSVC
+    #include <intrin.h>
+
+    // x86/x64 only: aligned loads/stores are atomic and ordered, the barrier stops compiler reordering
+    XTD_FORCE_INLINE long _XTD_AtomicLoad32(volatile long* p) { long v = *p; _ReadWriteBarrier(); return v; }
+    XTD_FORCE_INLINE void _XTD_AtomicStore32(volatile long* p, long v) { _ReadWriteBarrier(); *p = v; }
+    #if defined(_M_IX86)
+    // 64 bit loads and stores are split in two on x86-32, go through cmpxchg8b instead
+    XTD_FORCE_INLINE __int64 _XTD_AtomicLoad64(volatile __int64* p) { return _InterlockedCompareExchange64(p, 0, 0); }
+    XTD_FORCE_INLINE void _XTD_AtomicStore64(volatile __int64* p, __int64 v) { _InterlockedExchange64(p, v); }
+    #else
+    XTD_FORCE_INLINE __int64 _XTD_AtomicLoad64(volatile __int64* p) { __int64 v = *p; _ReadWriteBarrier(); return v; }
+    XTD_FORCE_INLINE void _XTD_AtomicStore64(volatile __int64* p, __int64 v) { _ReadWriteBarrier(); *p = v; }
+    #endif
+    XTD_FORCE_INLINE int _XTD_AtomicCAS32(volatile long* p, void* expected, long desired) {
+        long prev = _InterlockedCompareExchange(p, desired, *(long*)expected);
+        int ok = prev == *(long*)expected;
+        *(long*)expected = prev;
+        return ok;
+    }
+    XTD_FORCE_INLINE int _XTD_AtomicCAS64(volatile __int64* p, void* expected, __int64 desired) {
+        __int64 prev = _InterlockedCompareExchange64(p, desired, *(__int64*)expected);
+        int ok = prev == *(__int64*)expected;
+        *(__int64*)expected = prev;
+        return ok;
+    }
+
+    #define _XTD_ATOMIC_SIZED(ptr, op32, op64, ...) (sizeof(*(ptr)) == 8 \
+        ? (i64)op64((volatile __int64*)(ptr), __VA_ARGS__) \
+        : (i64)op32((volatile long*)(ptr), __VA_ARGS__))
+
+    #define XTD_ATOMIC_LOAD(ptr) (sizeof(*(ptr)) == 8 ? _XTD_AtomicLoad64((volatile __int64*)(ptr)) : _XTD_AtomicLoad32((volatile long*)(ptr)))
+    #define XTD_ATOMIC_LOAD_ACQUIRE(ptr) XTD_ATOMIC_LOAD(ptr)
+    #define XTD_ATOMIC_LOAD_RELAXED(ptr) XTD_ATOMIC_LOAD(ptr)
+    #define XTD_ATOMIC_STORE(ptr, val) ((void)_XTD_ATOMIC_SIZED(ptr, _InterlockedExchange, _InterlockedExchange64, (val)))
+    #define XTD_ATOMIC_STORE_RELEASE(ptr, val) (sizeof(*(ptr)) == 8 ? _XTD_AtomicStore64((volatile __int64*)(ptr), (__int64)(val)) : _XTD_AtomicStore32((volatile long*)(ptr), (long)(val)))
+    #define XTD_ATOMIC_STORE_RELAXED(ptr, val) XTD_ATOMIC_STORE_RELEASE(ptr, val)
+    #define XTD_ATOMIC_CAS(ptr, expected_ptr, desired) _XTD_ATOMIC_SIZED(ptr, _XTD_AtomicCAS32, _XTD_AtomicCAS64, (expected_ptr), (desired))
+    #define XTD_ATOMIC_CAS_WEAK(ptr, expected_ptr, desired) XTD_ATOMIC_CAS(ptr, expected_ptr, desired)
+    #define XTD_ATOMIC_EXCHANGE(ptr, val) _XTD_ATOMIC_SIZED(ptr, _InterlockedExchange, _InterlockedExchange64, (val))
+    #define XTD_ATOMIC_FETCH_ADD(ptr, val) _XTD_ATOMIC_SIZED(ptr, _InterlockedExchangeAdd, _InterlockedExchangeAdd64, (val))
+    #define XTD_ATOMIC_FETCH_SUB(ptr, val) _XTD_ATOMIC_SIZED(ptr, _InterlockedExchangeAdd, _InterlockedExchangeAdd64, -(val))
+    #define XTD_ATOMIC_FENCE() _mm_mfence()
+#else
+    #warning XTD_ATOMIC_* not defined for this compiler
+#endif
+
+// Spin-wait hint for busy loops
+#if XTD_IS_COMPILER_MSVC
+    #define XTD_CPU_PAUSE() _mm_pause()
+#elif (XTD_IS_COMPILER_CLANG || XTD_IS_COMPILER_GCC) && (defined(__x86_64__) || defined(__i386__))
+    #define XTD_CPU_PAUSE() __builtin_ia32_pause()
+#elif (XTD_IS_COMPILER_CLANG || XTD_IS_COMPILER_GCC) && (defined(__aarch64__) || defined(__arm__))
+    #define XTD_CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+    #define XTD_CPU_PAUSE() ((void)0)
+#endif
+
+////////////////////////////////////////
+//
+//  CPU Features
+//
+
+// XTD_HAS_* say what the compiler may use everywhere, these say what the running CPU supports.
+// Kernels for higher tiers are built with XTD_TARGET_* and picked at runtime from a table
+// indexed by XTD_CPUTier, with the gaps filled by the next lower implementation:
+//
+//   static KernelFunc* const kernels[XTD_CPU_TIER_COUNT] = {
+//       KernelScalar, KernelSSE2, KernelSSE2, KernelAVX2, KernelAVX2 };
+//   kernels[XTD_GetCPUTier()](...);
+//
+// Detection runs once. Setting the XTD_CPU_TIER environment variable to scalar, sse2, sse41,
+// avx2 or avx512 caps the tier and the reported features, to test the fallbacks. It can't
+// disable what the compiler was allowed to use everywhere.
+
+#include <stdlib.h>
+#include <string.h>
+
+#define XTD_CPU_SSE2   (1u << 0)
+#define XTD_CPU_SSE41  (1u << 1)
+#define XTD_CPU_AVX    (1u << 2)
+#define XTD_CPU_AVX2   (1u << 3)
+#define XTD_CPU_FMA    (1u << 4)
+#define XTD_CPU_BMI2   (1u << 5) // BMI1 and BMI2
+#define XTD_CPU_F16C   (1u << 6)
+#define XTD_CPU_AVX512 (1u << 7) // AVX-512 F, BW, DQ and VL
+
+typedef enum {
+    XTD_CPU_TIER_SCALAR,
+    XTD_CPU_TIER_SSE2,
+    XTD_CPU_TIER_SSE41,
+    XTD_CPU_TIER_AVX2,   // AVX2, FMA, BMI2 and F16C (x86-64-v3)
+    XTD_CPU_TIER_AVX512, // AVX-512 F, BW, DQ and VL (x86-64-v4)
+    XTD_CPU_TIER_COUNT,
+} XTD_CPUTier;
+
+#if (XTD_IS_COMPILER_MSVC && (defined(_M_X64) || defined(_M_IX86))) || \
+    ((XTD_IS_COMPILER_CLANG || XTD_IS_COMPILER_GCC) && (defined(__x86_64__) || defined(__i386__)))
+    #define XTD_HAS_CPU_DISPATCH 1
+#else
+    #define XTD_HAS_CPU_DISPATCH 0
+#endif
+
+// Enables an instruction set for a single function, and expands to nothing when the whole build
+// already has it (so inline helpers marked with it can be called from any function there).
+// MSVC allows any intrinsic anywhere. FMA is never enabled implicitly, so multiplies and adds
+// are not fused and results match the other tiers.
+#if XTD_HAS_CPU_DISPATCH && (XTD_IS_COMPILER_CLANG || XTD_IS_COMPILER_GCC)
+    #define _XTD_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define _XTD_TARGET(isa)
+#endif
+
+#if XTD_HAS_SSE41
+    #define XTD_TARGET_SSE41
+#else
+    #define XTD_TARGET_SSE41 _XTD_TARGET("sse4.1")
+#endif
+
+#if XTD_HAS_F16C
+    #define XTD_TARGET_F16C
+#else
+    #define XTD_TARGET_F16C _XTD_TARGET("avx,f16c")
+#endif
+
+#if XTD_HAS_AVX2
+    #define XTD_TARGET_AVX2
+#else
+    #define XTD_TARGET_AVX2 _XTD_TARGET("avx2")
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+    #define XTD_TARGET_AVX512
+#else
+    #define XTD_TARGET_AVX512 _XTD_TARGET("avx2,avx512f,avx512bw,avx512dq,avx512vl")
+#endif
+
+#if XTD_HAS_CPU_DISPATCH
+    #if XTD_IS_COMPILER_MSVC
+        #include <intrin.h>
+        XTD_FORCE_INLINE void _XTD_CPUID(u32 leaf, u32* regs) {
+            int r[4];
+            __cpuidex(r, (int)leaf, 0);
+            for (int i = 0; i < 4; i++)
+                regs[i] = (u32)r[i];
+        }
+        XTD_FORCE_INLINE u64 _XTD_XGETBV(void) { return _xgetbv(0); }
+    #else
+        #include <cpuid.h>
+        XTD_FORCE_INLINE void _XTD_CPUID(u32 leaf, u32* regs) {
+            __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+        }
+        XTD_FORCE_INLINE u64 _XTD_XGETBV(void) {
+            u32 lo, hi;
+            __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            return ((u64)hi << 32) | lo;
+        }
+    #endif
+#endif
+
+// Features every tier needs, each one includes the ones below
+XTD_FORCE_INLINE u32 _XTD_CPUTierFeatures(u32 tier) {
+    static const u32 features[XTD_CPU_TIER_COUNT] = {
+        0,
+        XTD_CPU_SSE2,
+        XTD_CPU_SSE2 | XTD_CPU_SSE41,
+        XTD_CPU_SSE2 | XTD_CPU_SSE41 | XTD_CPU_AVX | XTD_CPU_AVX2 | XTD_CPU_FMA | XTD_CPU_BMI2 | XTD_CPU_F16C,
+        XTD_CPU_SSE2 | XTD_CPU_SSE41 | XTD_CPU_AVX | XTD_CPU_AVX2 | XTD_CPU_FMA | XTD_CPU_BMI2 | XTD_CPU_F16C | XTD_CPU_AVX512,
+    };
+    return features[tier];
+}
+
+XTD_FORCE_INLINE const char* XTD_CPUTierName(XTD_CPUTier tier) {
+    static const char* names[XTD_CPU_TIER_COUNT] = {"scalar", "sse2", "sse41", "avx2", "avx512"};
+    return (u32)tier < XTD_CPU_TIER_COUNT ? names[tier] : "unknown";
+}
+
+XTD_INLINE u32 _XTD_DetectCPUFeatures(void) {
+    u32 features = 0;
+#if XTD_HAS_CPU_DISPATCH
+    u32 r[4];
+    _XTD_CPUID(0, r);
+    u32 max_leaf = r[0];
+    _XTD_CPUID(1, r);
+    if (r[3] & (1u << 26))
+        features |= XTD_CPU_SSE2;
+    if (r[2] & (1u << 19))
+        features |= XTD_CPU_SSE41;
+
+    // The OS must save the AVX (and AVX-512) registers too, which XCR0 tells
+    int ymm = 0, zmm = 0;
+    if ((r[2] & (1u << 27)) && (r[2] & (1u << 28)))
+    {
+        u64 xcr0 = _XTD_XGETBV();
+        ymm = (xcr0 & 0x6) == 0x6;
+        zmm = ymm && (xcr0 & 0xE0) == 0xE0;
+    }
+    if (ymm)
+    {
+        features |= XTD_CPU_AVX;
+        if (r[2] & (1u << 12))
+            features |= XTD_CPU_FMA;
+        if (r[2] & (1u << 29))
+            features |= XTD_CPU_F16C;
+    }
+    if (max_leaf >= 7)
+    {
+        _XTD_CPUID(7, r);
+        u32 bmi = (1u << 3) | (1u << 8);
+        u32 avx512 = (1u << 16) | (1u << 17) | (1u << 30) | (1u << 31);
+        if (ymm && (r[1] & (1u << 5)))
+            features |= XTD_CPU_AVX2;
+        if ((r[1] & bmi) == bmi)
+            features |= XTD_CPU_BMI2;
+        if (zmm && (r[1] & avx512) == avx512)
+            features |= XTD_CPU_AVX512;
+    }
+#endif
+    return features;
+}
+
+// Cached as the features, the tier in bits 24-30 and bit 31 set once detected
+XTD_INLINE u32 _XTD_CPUState(void) {
+    static u32 state = 0;
+    u32 s = XTD_ATOMIC_LOAD_RELAXED(&state);
+    if (s != 0)
+        return s;
+
+    u32 features = _XTD_DetectCPUFeatures();
+    u32 tier = XTD_CPU_TIER_COUNT - 1;
+    while (tier > 0 && (features & _XTD_CPUTierFeatures(tier)) != _XTD_CPUTierFeatures(tier))
+        tier--;
+#if XTD_IS_COMPILER_MSVC
+    #pragma warning(suppress: 4996)
+#endif
+    const char* cap = getenv("XTD_CPU_TIER");
+    for (u32 t = 0; cap != NULL && t < tier; t++)
+    {
+        if (strcmp(cap, XTD_CPUTierName((XTD_CPUTier)t)) == 0)
+        {
+            tier = t;
+            features &= _XTD_CPUTierFeatures(t);
+        }
+    }
+    s = features | (tier << 24) | (1u << 31);
+    XTD_ATOMIC_STORE_RELAXED(&state, s);
+    return s;
+}
+
+// XTD_CPU_* flags
+XTD_FORCE_INLINE u32 XTD_GetCPUFeatures(void) {
+    return _XTD_CPUState() & 0xFFFFFF;
+}
+
+XTD_FORCE_INLINE XTD_CPUTier XTD_GetCPUTier(void) {
+    return (XTD_CPUTier)((_XTD_CPUState() >> 24) & 0x7F);
+}
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_COMMON_IMPLEMENTATION
+
+#include <stdlib.h>
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+#endif
+
+// glibc hides MAP_ANONYMOUS in strict ISO C modes, blocks come from the heap there
+#if defined(MAP_ANONYMOUS)
+    #define _XTD_ALLOC_MAP_ANONYMOUS MAP_ANONYMOUS
+#elif defined(MAP_ANON)
+    #define _XTD_ALLOC_MAP_ANONYMOUS MAP_ANON
+#endif
+
+// Kept right before every block, mapped_size is 0 for heap blocks
+typedef struct {
+    void* base;
+    usize mapped_size;
+} _XTD_AllocHeader;
+
+#if defined(_XTD_ALLOC_MAP_ANONYMOUS)
+// The block starts pad bytes into a region aligned to region_align. When mmap's own alignment
+// (page_size) is smaller the mapping is over reserved and what lies around the region given back.
+static void* _XTD_MapAligned(usize size, usize pad, usize region_align, usize page_size, int extra_flags, usize* mapped_size)
+{
+    usize length = XTD_ALIGNUP(pad + size, region_align);
+    usize reserve = region_align > page_size ? length + region_align : length;
+    if (pad + size < size || length < size || reserve < length)
+        return NULL;
+    u8* base = (u8*)mmap(NULL, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | _XTD_ALLOC_MAP_ANONYMOUS | extra_flags, -1, 0);
+    if (base == (u8*)MAP_FAILED)
+        return NULL;
+
+    u8* region = (u8*)XTD_ALIGNUP((usize)base, region_align);
+    if (region > base)
+        munmap(base, (usize)(region - base));
+    if (base + reserve > region + length)
+        munmap(region + length, (usize)(base + reserve - (region + length)));
+    *mapped_size = length;
+    return region;
+}
+#endif
+
+XTD_COMMON_FUNC void* XTD_AlignedAlloc(usize size, usize alignment, u32 flags)
+{
+    XTD_ASSERT(XTD_ISPOW2(alignment));
+    alignment = XTD_MAX(alignment, sizeof(_XTD_AllocHeader));
+    usize pad = XTD_ALIGNUP(sizeof(_XTD_AllocHeader), alignment);
+    void* base = NULL;
+    usize mapped_size = 0;
+#if defined(_XTD_ALLOC_MAP_ANONYMOUS)
+    if (size >= XTD_LARGE_PAGE_SIZE)
+    {
+        usize page_align = XTD_PAGE_SIZE;
+        if (flags & XTD_ALLOC_LARGE_PAGES)
+        {
+    #if defined(MAP_HUGETLB)
+            if (alignment <= XTD_LARGE_PAGE_SIZE)
+                base = _XTD_MapAligned(size, pad, XTD_LARGE_PAGE_SIZE, XTD_LARGE_PAGE_SIZE, MAP_HUGETLB, &mapped_size);
+    #endif
+            page_align = XTD_LARGE_PAGE_SIZE;
+        }
+        if (base == NULL)
+        {
+            base = _XTD_MapAligned(size, pad, XTD_MAX(alignment, page_align), XTD_PAGE_SIZE, 0, &mapped_size);
+    #if defined(MADV_HUGEPAGE)
+            if (base != NULL && (flags & XTD_ALLOC_LARGE_PAGES))
+                madvise(base, mapped_size, MADV_HUGEPAGE);
+    #endif
+        }
+    }
+#endif
+    if (base == NULL)
+    {
+        mapped_size = 0;
+        usize total = size + pad + alignment;
+        if (total < size)
+            return NULL;
+        base = (flags & XTD_ALLOC_ZEROED) ? calloc(1, total) : malloc(total);
+        if (base == NULL)
+            return NULL;
+    }
+
+    u8* block = (u8*)XTD_ALIGNUP((usize)base + sizeof(_XTD_AllocHeader), alignment);
+    _XTD_AllocHeader* header = (_XTD_AllocHeader*)block - 1;
+    header->base = base;
+    header->mapped_size = mapped_size;
+    return block;
+}
+
+XTD_COMMON_FUNC void XTD_AlignedFree(void* block)
+{
+    if (block == NULL)
+        return;
+    _XTD_AllocHeader header = ((_XTD_AllocHeader*)block)[-1];
+#if defined(_XTD_ALLOC_MAP_ANONYMOUS)
+    if (header.mapped_size != 0)
+    {
+        munmap(header.base, header.mapped_size);
+        return;
+    }
+#endif
+    free(header.base);
+}
+
+#undef _XTD_ALLOC_MAP_ANONYMOUS
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
 #ifdef __cplusplus //End extern "C"
 }
 #endif
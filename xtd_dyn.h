@@ -34,6 +34,7 @@ extern "C" {
 #endif
 
 #include "xtd_common.h"
+#include <stdbool.h>
 
 ////////////////////////////////////////
 //
@@ -48,11 +49,35 @@ extern "C" {
 
 #define XTD_DA_MIN_CAPACITY 16
 
+// Small buffer optimized arrays keep up to N items inside the struct and only
+// allocate once they outgrow it. Any struct with the XTD_DA fields followed by
+//   T inline_items[N];
+// works, and all XTD_DA_* macros can be used on it after XTD_SDA_INIT.
+// Don't copy one by value while its items are inline, items would still point into the source.
+#define XTD_SDA(T, N) struct { T* items; usize capacity; usize count; T inline_items[N]; }
+#define XTD_SDA_INIT(da) do { \
+        (da).items = (da).inline_items; \
+        (da).capacity = XTD_ARRAYCOUNT((da).inline_items); \
+        (da).count = 0; \
+    } while(0)
+#define XTD_SDA_FREE(da) do {XTD_DA_FREE(da); XTD_SDA_INIT(da);} while(0)
+
+// True when items points into the array struct itself (inline storage)
+#define XTD_DA_IS_INLINE(da) ((usize)(da).items - (usize)&(da) < sizeof(da))
+
+#ifdef __cplusplus
+    #define __XTD_DA_ITEMS_CAST(da) (decltype((da).items))
+#else
+    #define __XTD_DA_ITEMS_CAST(da)
+#endif
+
 #define __XTD_DA_SHOULD_GROW(da, new_len) ((da).items == ((void*)0) || (new_len) > (da).capacity)
 #define XTD_DA_RESERVE(da, new_cap) if ((da).items == (void*)0 || (da).capacity < (new_cap)) { \
         if ((da).items == (void*)0) (da).count = 0; \
         usize cap = XTD_MAX(new_cap, XTD_DA_MIN_CAPACITY); \
-        (da).items = _XTD_GrowBuffer((da).items, cap, sizeof((da).items[0])); \
+        (da).items = __XTD_DA_ITEMS_CAST(da) (XTD_DA_IS_INLINE(da) \
+            ? _XTD_SpillBuffer((da).items, (da).count, cap, sizeof((da).items[0])) \
+            : _XTD_GrowBuffer((da).items, cap, sizeof((da).items[0]))); \
         (da).capacity = cap; \
     }
 #define XTD_DA_PUSH(da, ...) do { \
@@ -63,7 +88,220 @@ extern "C" {
 
 #define XTD_DA_POP(da) ((da).count--, (da).items[(da).count])
 #define XTD_DA_CLEAR(da) do {(da).count = 0;} while(0)
-#define XTD_DA_FREE(da) do {XTD_DYN_FREE((da).items); (da).items = NULL; (da).capacity = 0; (da).count = 0;} while(0)
+#define XTD_DA_FREE(da) do { \
+        if (!XTD_DA_IS_INLINE(da)) XTD_DYN_FREE((da).items); \
+        (da).items = NULL; (da).capacity = 0; (da).count = 0; \
+    } while(0)
+
+////////////////////////////////////////
+//
+//  Segmented Array
+//
+
+// Array made of power-of-two sized blocks: block k holds XTD_SEGA_FIRST_BLOCK << k items.
+// Growing only allocates a new block, so nothing is copied and element addresses stay
+// valid for the lifetime of the array. Index i lives in block msb(i + FIRST) - FIRST_SHIFT.
+// Works with any struct with the following fields
+//   T* blocks[XTD_SEGA_MAX_BLOCKS];
+//   usize capacity;
+//   usize count;
+//   u32 block_count;
+
+#define XTD_SEGA_FIRST_BLOCK_SHIFT 4
+#define XTD_SEGA_FIRST_BLOCK ((usize)1 << XTD_SEGA_FIRST_BLOCK_SHIFT)
+#define XTD_SEGA_MAX_BLOCKS (sizeof(usize) * 8 - XTD_SEGA_FIRST_BLOCK_SHIFT)
+
+#define XTD_SEGA(T) struct { T* blocks[XTD_SEGA_MAX_BLOCKS]; usize capacity; usize count; u32 block_count; }
+
+#define XTD_SEGA_BLOCK_SIZE(block) (XTD_SEGA_FIRST_BLOCK << (block))
+#define XTD_SEGA_BLOCK_START(block) (XTD_SEGA_BLOCK_SIZE(block) - XTD_SEGA_FIRST_BLOCK)
+// Number of used items in a block
+#define XTD_SEGA_BLOCK_USED(sa, block) ((sa).count <= XTD_SEGA_BLOCK_START(block) ? 0 : \
+        XTD_MIN((sa).count - XTD_SEGA_BLOCK_START(block), XTD_SEGA_BLOCK_SIZE(block)))
+
+XTD_FORCE_INLINE u32 XTD_SegaBlockIndex(usize index) {
+    return 63 - XTD_CLZ64((u64)(index + XTD_SEGA_FIRST_BLOCK)) - XTD_SEGA_FIRST_BLOCK_SHIFT;
+}
+XTD_FORCE_INLINE usize XTD_SegaBlockOffset(usize index) {
+    u64 i = (u64)(index + XTD_SEGA_FIRST_BLOCK);
+    return (usize)(i & ~(1ULL << (63 - XTD_CLZ64(i))));
+}
+
+#ifdef __cplusplus
+    #define __XTD_SEGA_BLOCK_CAST(sa) (decltype(&(sa).blocks[0][0]))
+#else
+    #define __XTD_SEGA_BLOCK_CAST(sa)
+#endif
+
+#define XTD_SEGA_AT(sa, index) ((sa).blocks[XTD_SegaBlockIndex(index)][XTD_SegaBlockOffset(index)])
+
+#define XTD_SEGA_RESERVE(sa, new_cap) \
+    _XTD_SegaReserve((void**)(sa).blocks, &(sa).block_count, &(sa).capacity, (new_cap), sizeof((sa).blocks[0][0]))
+
+// Does nothing when a new block can't be allocated, check count if it matters
+#define XTD_SEGA_PUSH(sa, ...) do { \
+    if ((sa).count < (sa).capacity || XTD_SEGA_RESERVE(sa, (sa).count + 1)) { \
+        XTD_SEGA_AT(sa, (sa).count) = __VA_ARGS__; \
+        (sa).count++; \
+    } \
+    } while(0);
+
+#define XTD_SEGA_POP(sa) ((sa).count--, XTD_SEGA_AT(sa, (sa).count))
+#define XTD_SEGA_CLEAR(sa) do {(sa).count = 0;} while(0)
+#define XTD_SEGA_FREE(sa) do { \
+        for (u32 __xtd_b = 0; __xtd_b < (sa).block_count; __xtd_b++) XTD_DYN_FREE((sa).blocks[__xtd_b]); \
+        (sa).block_count = 0; (sa).capacity = 0; (sa).count = 0; \
+    } while(0)
+
+// Visits the blocks that hold items. Loop over the block contents directly so it vectorizes:
+//   XTD_SEGA_FOREACH_BLOCK(points, b) {
+//       V3f* p = points.blocks[b];
+//       for (usize i = 0, n = XTD_SEGA_BLOCK_USED(points, b); i < n; i++) ...
+//   }
+#define XTD_SEGA_FOREACH_BLOCK(sa, block_var) \
+    for (u32 block_var = 0; block_var < (sa).block_count && XTD_SEGA_BLOCK_START(block_var) < (sa).count; block_var++)
+
+////////////////////////////////////////
+//
+//  Virtual Memory Array
+//
+
+// Reserves address space for a maximum number of items up front and commits pages
+// as the array grows. items never moves: growth is O(1), never copies and pointers
+// stay valid. Reserving costs no memory, so max_count can be huge (e.g. 64 GiB worth).
+// Works with any struct with the XTD_DA fields plus
+//   usize reserved;  // Bytes of address space
+//   usize committed; // Bytes backed by memory
+//   u32 vm_flags;
+// Only grow it with XTD_VDA_* macros, XTD_DA_RESERVE/PUSH would realloc it.
+// XTD_VDA_RESERVE evaluates to false when the pages can't be committed (or max_count is
+// exceeded), XTD_VDA_PUSH then does nothing. Needs MAP_ANONYMOUS on POSIX systems, which
+// glibc hides in strict ISO C modes (-std=c11): XTD_VDA_INIT fails there unless the build
+// defines _DEFAULT_SOURCE.
+
+#define XTD_VDA(T) struct { T* items; usize capacity; usize count; usize reserved; usize committed; u32 vm_flags; }
+
+#define XTD_VM_HUGE_PAGES XTD_BIT(0)          // Request transparent huge pages (Linux)
+#define XTD_VM_DECOMMIT_ON_SHRINK XTD_BIT(1)  // XTD_VDA_SHRINK gives unused pages back to the OS
+
+// Commit granularity, huge page arrays commit 2 MiB at a time
+#ifndef XTD_VM_COMMIT_CHUNK
+#define XTD_VM_COMMIT_CHUNK XTD_KB(64)
+#endif
+
+#define XTD_VDA_INIT(da, max_count, flags) do { \
+        XTD_ZERO_STRUCT(&(da)); \
+        (da).vm_flags = (flags); \
+        (da).items = __XTD_DA_ITEMS_CAST(da) _XTD_VmReserve((usize)(max_count) * sizeof((da).items[0]), (flags), &(da).reserved); \
+    } while(0)
+#define XTD_VDA_RESERVE(da, new_cap) ((da).capacity >= (usize)(new_cap) || \
+        (_XTD_VmCommit((da).items, (da).reserved, &(da).committed, (usize)(new_cap) * sizeof((da).items[0]), (da).vm_flags) && \
+         ((da).capacity = (da).committed / sizeof((da).items[0])) >= (usize)(new_cap)))
+#define XTD_VDA_PUSH(da, ...) do { \
+    if ((da).count < (da).capacity || XTD_VDA_RESERVE(da, (da).count + 1)) \
+        (da).items[((da).count)++] = __VA_ARGS__; \
+    } while(0);
+// Decommits the pages past count when XTD_VM_DECOMMIT_ON_SHRINK is set
+#define XTD_VDA_SHRINK(da) do { \
+        if ((da).vm_flags & XTD_VM_DECOMMIT_ON_SHRINK) { \
+            _XTD_VmDecommit((da).items, &(da).committed, (da).count * sizeof((da).items[0]), (da).vm_flags); \
+            (da).capacity = (da).committed / sizeof((da).items[0]); \
+        } \
+    } while(0)
+#define XTD_VDA_FREE(da) do {_XTD_VmRelease((da).items, (da).reserved); XTD_ZERO_STRUCT(&(da));} while(0)
+
+////////////////////////////////////////
+//
+//  File-backed Array
+//
+
+// Array stored in a memory-mapped file that can be reopened without any parsing.
+// The file starts with a 64 byte XTD_FileArrayHeader followed by the items (host byte order).
+// Growing extends the file with ftruncate and remaps it, so items may move on growth.
+// Changes reach the file through the page cache, XTD_FDA_FLUSH forces them to disk.
+// XTD_FDA_RESERVE evaluates to false when the file can't grow, XTD_FDA_PUSH then does nothing.
+// Closing truncates the file to count items, dropping the capacity reserved past them.
+// POSIX only, XTD_FDA_OPEN fails on other platforms. It also fails in strict ISO C modes with
+// glibc (-std=c11), which hides ftruncate unless the build defines _DEFAULT_SOURCE.
+// Works with XTD_FDA(T) structs, whose layout must match XTD_FileArray.
+
+typedef struct {
+    u32 magic;      // XTD_FILE_ARRAY_MAGIC
+    u32 version;
+    u64 elem_size;
+    u64 count;
+    u64 capacity;
+    u8 reserved[32];
+} XTD_FileArrayHeader;
+
+#define XTD_FILE_ARRAY_MAGIC 0x41445458 // "XTDA"
+#define XTD_FILE_ARRAY_VERSION 1
+
+#define XTD_FDA_READ_ONLY XTD_BIT(0) // Map the file read-only, it must exist
+#define XTD_FDA_TRUNCATE XTD_BIT(1)  // Discard existing contents
+
+typedef struct {
+    void* items;
+    usize capacity;
+    usize count;
+    XTD_FileArrayHeader* header;
+    isize file;
+    u32 fda_flags;
+} XTD_FileArray;
+
+#define XTD_FDA(T) struct { T* items; usize capacity; usize count; XTD_FileArrayHeader* header; isize file; u32 fda_flags; }
+
+#define XTD_FDA_OPEN(da, path, flags) XTD_FileArrayOpen((XTD_FileArray*)&(da), (path), sizeof((da).items[0]), (flags))
+#define XTD_FDA_RESERVE(da, new_cap) ((da).capacity >= (usize)(new_cap) || \
+        XTD_FileArrayReserve((XTD_FileArray*)&(da), (new_cap), sizeof((da).items[0])))
+#define XTD_FDA_PUSH(da, ...) do { \
+    if ((da).count < (da).capacity || XTD_FDA_RESERVE(da, XTD_MAX((da).capacity * 2, (usize)XTD_DA_MIN_CAPACITY))) { \
+        (da).items[((da).count)++] = __VA_ARGS__; \
+        (da).header->count = (da).count; \
+    } \
+    } while(0);
+#define XTD_FDA_POP(da) ((da).header->count = --(da).count, (da).items[(da).count])
+#define XTD_FDA_CLEAR(da) do {(da).count = 0; (da).header->count = 0;} while(0)
+// wait = true blocks until the data is on disk (MS_SYNC), false only schedules the write
+#define XTD_FDA_FLUSH(da, wait) XTD_FileArrayFlush((XTD_FileArray*)&(da), (wait))
+#define XTD_FDA_CLOSE(da) XTD_FileArrayClose((XTD_FileArray*)&(da))
+
+////////////////////////////////////////
+//
+//  Bitset
+//
+
+// Dynamic bitset. Bits past bit_count in the last word are always kept at zero.
+typedef struct {
+    u64* words;
+    usize word_count;
+    usize bit_count;
+} XTD_Bitset;
+
+#define XTD_BITSET_WORDS(bit_count) XTD_DIVCEIL((usize)(bit_count), (usize)64)
+
+XTD_FORCE_INLINE bool XTD_BitsetTest(const XTD_Bitset* bs, usize index) {
+    return (bs->words[index >> 6] >> (index & 63)) & 1;
+}
+XTD_FORCE_INLINE void XTD_BitsetSet(XTD_Bitset* bs, usize index) {
+    XTD_SETBIT(bs->words[index >> 6], index & 63);
+}
+XTD_FORCE_INLINE void XTD_BitsetClear(XTD_Bitset* bs, usize index) {
+    XTD_CLEARBIT(bs->words[index >> 6], index & 63);
+}
+XTD_FORCE_INLINE void XTD_BitsetToggle(XTD_Bitset* bs, usize index) {
+    XTD_TOGGLEBIT(bs->words[index >> 6], index & 63);
+}
+XTD_FORCE_INLINE void XTD_BitsetAssign(XTD_Bitset* bs, usize index, bool value) {
+    XTD_MODIFYBITS(bs->words[index >> 6], XTD_BIT(index & 63), (u64)value << (index & 63));
+}
+
+// Visits every set bit in increasing order. 'break' only leaves the current word.
+#define XTD_BITSET_FOREACH(bs, index_var) \
+    for (usize __xtd_w = 0; __xtd_w < (bs).word_count; __xtd_w++) \
+        for (u64 __xtd_bits = (bs).words[__xtd_w], index_var = 0; \
+             __xtd_bits && ((index_var = __xtd_w * 64 + XTD_CTZ64(__xtd_bits)), 1); \
+             __xtd_bits &= __xtd_bits - 1)
 
 ////////////////////////////////////////
 //
@@ -71,6 +309,32 @@ extern "C" {
 //
 
 XTD_DYN_FUNC_DECL void* _XTD_GrowBuffer(void* buffer, usize new_capacity, usize elem_size);
+XTD_DYN_FUNC_DECL void* _XTD_SpillBuffer(const void* inline_items, usize count, usize new_capacity, usize elem_size);
+XTD_DYN_FUNC_DECL bool _XTD_SegaReserve(void** blocks, u32* block_count, usize* capacity, usize new_capacity, usize elem_size);
+XTD_DYN_FUNC_DECL void* _XTD_VmReserve(usize bytes, u32 flags, usize* out_reserved);
+XTD_DYN_FUNC_DECL bool _XTD_VmCommit(void* base, usize reserved, usize* committed, usize needed, u32 flags);
+XTD_DYN_FUNC_DECL void _XTD_VmDecommit(void* base, usize* committed, usize keep, u32 flags);
+XTD_DYN_FUNC_DECL void _XTD_VmRelease(void* base, usize reserved);
+
+XTD_DYN_FUNC_DECL bool XTD_FileArrayOpen(XTD_FileArray* fa, const char* path, usize elem_size, u32 flags);
+XTD_DYN_FUNC_DECL bool XTD_FileArrayReserve(XTD_FileArray* fa, usize new_capacity, usize elem_size);
+XTD_DYN_FUNC_DECL bool XTD_FileArrayFlush(XTD_FileArray* fa, bool wait);
+XTD_DYN_FUNC_DECL void XTD_FileArrayClose(XTD_FileArray* fa);
+
+XTD_DYN_FUNC_DECL bool XTD_BitsetInit(XTD_Bitset* bs, usize bit_count);
+XTD_DYN_FUNC_DECL bool XTD_BitsetResize(XTD_Bitset* bs, usize bit_count);
+XTD_DYN_FUNC_DECL void XTD_BitsetFree(XTD_Bitset* bs);
+XTD_DYN_FUNC_DECL void XTD_BitsetFillRange(XTD_Bitset* bs, usize begin, usize end, bool value);
+XTD_DYN_FUNC_DECL void XTD_BitsetFill(XTD_Bitset* bs, bool value);
+XTD_DYN_FUNC_DECL usize XTD_BitsetCount(const XTD_Bitset* bs);
+// Returns the index of the first set bit >= from, or bit_count if there is none
+XTD_DYN_FUNC_DECL usize XTD_BitsetFindNext(const XTD_Bitset* bs, usize from);
+XTD_DYN_FUNC_DECL usize XTD_BitsetFindNextClear(const XTD_Bitset* bs, usize from);
+// Whole-set operations, all bitsets must have the same bit_count. dst may alias a or b.
+XTD_DYN_FUNC_DECL void XTD_BitsetAnd(XTD_Bitset* dst, const XTD_Bitset* a, const XTD_Bitset* b);
+XTD_DYN_FUNC_DECL void XTD_BitsetOr(XTD_Bitset* dst, const XTD_Bitset* a, const XTD_Bitset* b);
+XTD_DYN_FUNC_DECL void XTD_BitsetXor(XTD_Bitset* dst, const XTD_Bitset* a, const XTD_Bitset* b);
+XTD_DYN_FUNC_DECL void XTD_BitsetAndNot(XTD_Bitset* dst, const XTD_Bitset* a, const XTD_Bitset* b);
 
 
 ////////////////////////////////////////
@@ -81,6 +345,9 @@ XTD_DYN_FUNC_DECL void* _XTD_GrowBuffer(void* buffer, usize new_capacity, usize
 
 #ifdef XTD_DYN_IMPLEMENTATION
 
+#include <stdlib.h>
+#include <string.h>
+
 XTD_DYN_FUNC void* _XTD_GrowBuffer(void* buffer, usize new_capacity, usize elem_size)
 {
     usize new_size = new_capacity * elem_size;
@@ -95,6 +362,508 @@ XTD_DYN_FUNC void* _XTD_GrowBuffer(void* buffer, usize new_capacity, usize elem_
     return buffer;
 }
 
+XTD_DYN_FUNC void* _XTD_SpillBuffer(const void* inline_items, usize count, usize new_capacity, usize elem_size)
+{
+    void* buffer = XTD_DYN_MALLOC(new_capacity * elem_size);
+    if (buffer != NULL)
+        memcpy(buffer, inline_items, count * elem_size);
+    return buffer;
+}
+
+XTD_DYN_FUNC bool _XTD_SegaReserve(void** blocks, u32* block_count, usize* capacity, usize new_capacity, usize elem_size)
+{
+    while (*capacity < new_capacity)
+    {
+        XTD_ASSERT(*block_count < XTD_SEGA_MAX_BLOCKS);
+        usize block_size = XTD_SEGA_BLOCK_SIZE(*block_count);
+        void* block = XTD_DYN_MALLOC(block_size * elem_size);
+        if (block == NULL)
+            return false;
+        blocks[(*block_count)++] = block;
+        *capacity += block_size;
+    }
+    return true;
+}
+
+//
+// Virtual memory array
+//
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+// Anonymous mappings are hidden by glibc in strict ISO C modes, the array is unavailable there
+#if !defined(_WIN32)
+    #if defined(MAP_ANONYMOUS)
+        #define _XTD_MAP_ANONYMOUS MAP_ANONYMOUS
+    #elif defined(MAP_ANON)
+        #define _XTD_MAP_ANONYMOUS MAP_ANON
+    #endif
+    #if defined(MAP_NORESERVE)
+        #define _XTD_MAP_NORESERVE MAP_NORESERVE
+    #else
+        #define _XTD_MAP_NORESERVE 0
+    #endif
+#endif
+
+static usize _xtd_VmChunk(u32 flags)
+{
+    return (flags & XTD_VM_HUGE_PAGES) ? XTD_MB(2) : XTD_VM_COMMIT_CHUNK;
+}
+
+XTD_DYN_FUNC void* _XTD_VmReserve(usize bytes, u32 flags, usize* out_reserved)
+{
+    usize chunk = _xtd_VmChunk(flags);
+    usize size = XTD_ALIGNUP(XTD_MAX(bytes, (usize)1), chunk);
+    *out_reserved = 0;
+
+#if defined(_WIN32)
+    void* base = VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+    if (base == NULL)
+        return NULL;
+    *out_reserved = size;
+    return base;
+#elif defined(_XTD_MAP_ANONYMOUS)
+    // Over-reserve so the start can be aligned to the commit chunk (needed for huge pages)
+    usize padded = size + chunk;
+    u8* raw = (u8*)mmap(NULL, padded, PROT_NONE, MAP_PRIVATE | _XTD_MAP_ANONYMOUS | _XTD_MAP_NORESERVE, -1, 0);
+    if (raw == (u8*)MAP_FAILED)
+        return NULL;
+    u8* base = (u8*)XTD_ALIGNUP((usize)raw, chunk);
+    if (base != raw)
+        munmap(raw, (usize)(base - raw));
+    if (raw + padded != base + size)
+        munmap(base + size, (usize)(raw + padded - (base + size)));
+    #ifdef MADV_HUGEPAGE
+    if (flags & XTD_VM_HUGE_PAGES)
+        madvise(base, size, MADV_HUGEPAGE);
+    #endif
+    *out_reserved = size;
+    return base;
+#else
+    (void)size;
+    return NULL;
+#endif
+}
+
+XTD_DYN_FUNC bool _XTD_VmCommit(void* base, usize reserved, usize* committed, usize needed, u32 flags)
+{
+    if (needed <= *committed)
+        return true;
+    if (base == NULL || needed > reserved)
+        return false;
+
+    // Grow geometrically so the number of commit syscalls stays logarithmic
+    usize target = XTD_MAX(needed, *committed + *committed / 2);
+    target = XTD_MIN(XTD_ALIGNUP(target, _xtd_VmChunk(flags)), reserved);
+
+    u8* start = (u8*)base + *committed;
+    usize size = target - *committed;
+#if defined(_WIN32)
+    if (VirtualAlloc(start, size, MEM_COMMIT, PAGE_READWRITE) == NULL)
+        return false;
+#else
+    if (mprotect(start, size, PROT_READ | PROT_WRITE) != 0)
+        return false;
+#endif
+
+    *committed = target;
+    return true;
+}
+
+XTD_DYN_FUNC void _XTD_VmDecommit(void* base, usize* committed, usize keep, u32 flags)
+{
+    usize target = XTD_ALIGNUP(keep, _xtd_VmChunk(flags));
+    if (base == NULL || target >= *committed)
+        return;
+
+    u8* start = (u8*)base + target;
+    usize size = *committed - target;
+#if defined(_WIN32)
+    VirtualFree(start, size, MEM_DECOMMIT);
+#elif defined(_XTD_MAP_ANONYMOUS)
+    // Mapping fresh pages over the range drops the old ones
+    if (mmap(start, size, PROT_NONE, MAP_PRIVATE | MAP_FIXED | _XTD_MAP_ANONYMOUS | _XTD_MAP_NORESERVE, -1, 0) == MAP_FAILED)
+        return;
+    #ifdef MADV_HUGEPAGE
+    if (flags & XTD_VM_HUGE_PAGES)
+        madvise(start, size, MADV_HUGEPAGE);
+    #endif
+#else
+    (void)start;
+    (void)size;
+#endif
+    *committed = target;
+}
+
+XTD_DYN_FUNC void _XTD_VmRelease(void* base, usize reserved)
+{
+    if (base == NULL)
+        return;
+#if defined(_WIN32)
+    (void)reserved;
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    munmap(base, reserved);
+#endif
+}
+
+//
+// File-backed array
+//
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// ftruncate is hidden by glibc in strict ISO C modes, the array is unavailable there
+#if defined(_WIN32)
+    #define _XTD_HAS_FILE_ARRAY 0
+#elif defined(__GLIBC__) && !(defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L) && \
+    !(defined(_XOPEN_SOURCE) && _XOPEN_SOURCE >= 500)
+    #define _XTD_HAS_FILE_ARRAY 0
+#else
+    #define _XTD_HAS_FILE_ARRAY 1
+#endif
+
+XTD_DYN_FUNC bool XTD_FileArrayOpen(XTD_FileArray* fa, const char* path, usize elem_size, u32 flags)
+{
+    XTD_ZERO_STRUCT(fa);
+    fa->file = -1;
+    fa->fda_flags = flags;
+
+#if !_XTD_HAS_FILE_ARRAY
+    (void)path;
+    (void)elem_size;
+    return false;
+#else
+    bool read_only = (flags & XTD_FDA_READ_ONLY) != 0;
+    int open_flags = read_only ? O_RDONLY : (O_RDWR | O_CREAT | ((flags & XTD_FDA_TRUNCATE) ? O_TRUNC : 0));
+    int fd = open(path, open_flags, 0644);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    usize file_size = (usize)st.st_size;
+    if (file_size == 0 && !read_only)
+    {
+        // New file: write a header with no items
+        file_size = sizeof(XTD_FileArrayHeader);
+        if (ftruncate(fd, (off_t)file_size) != 0)
+        {
+            close(fd);
+            return false;
+        }
+    }
+
+    if (file_size < sizeof(XTD_FileArrayHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    int prot = read_only ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void* map = mmap(NULL, file_size, prot, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    XTD_FileArrayHeader* header = (XTD_FileArrayHeader*)map;
+    if (header->magic == 0 && !read_only)
+    {
+        header->magic = XTD_FILE_ARRAY_MAGIC;
+        header->version = XTD_FILE_ARRAY_VERSION;
+        header->elem_size = elem_size;
+        header->count = 0;
+        header->capacity = 0;
+    }
+
+    usize capacity = (file_size - sizeof(XTD_FileArrayHeader)) / elem_size;
+    if (header->magic != XTD_FILE_ARRAY_MAGIC || header->version != XTD_FILE_ARRAY_VERSION ||
+        header->elem_size != elem_size || header->count > capacity)
+    {
+        munmap(map, file_size);
+        close(fd);
+        return false;
+    }
+    if (!read_only)
+        header->capacity = capacity;
+
+    fa->items = header + 1;
+    fa->capacity = capacity;
+    fa->count = (usize)header->count;
+    fa->header = header;
+    fa->file = fd;
+    return true;
+#endif
+}
+
+XTD_DYN_FUNC bool XTD_FileArrayReserve(XTD_FileArray* fa, usize new_capacity, usize elem_size)
+{
+#if !_XTD_HAS_FILE_ARRAY
+    (void)fa;
+    (void)new_capacity;
+    (void)elem_size;
+    return false;
+#else
+    if (new_capacity <= fa->capacity)
+        return true;
+    XTD_ASSERT(!(fa->fda_flags & XTD_FDA_READ_ONLY) && "XTD_FDA: can't grow a read-only array");
+
+    int fd = (int)fa->file;
+    usize old_size = sizeof(XTD_FileArrayHeader) + fa->capacity * elem_size;
+    usize new_size = sizeof(XTD_FileArrayHeader) + new_capacity * elem_size;
+    if (ftruncate(fd, (off_t)new_size) != 0)
+        return false;
+
+#ifdef MREMAP_MAYMOVE
+    void* map = mremap(fa->header, old_size, new_size, MREMAP_MAYMOVE);
+    if (map == MAP_FAILED)
+        return false;
+#else
+    // The old mapping stays valid until the new one exists
+    void* map = mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+        return false;
+    munmap(fa->header, old_size);
+#endif
+
+    fa->header = (XTD_FileArrayHeader*)map;
+    fa->header->capacity = new_capacity;
+    fa->items = fa->header + 1;
+    fa->capacity = new_capacity;
+    return true;
+#endif
+}
+
+XTD_DYN_FUNC bool XTD_FileArrayFlush(XTD_FileArray* fa, bool wait)
+{
+#if !_XTD_HAS_FILE_ARRAY
+    (void)fa;
+    (void)wait;
+    return false;
+#else
+    if (fa->header == NULL || (fa->fda_flags & XTD_FDA_READ_ONLY))
+        return true;
+    fa->header->count = fa->count;
+    usize size = sizeof(XTD_FileArrayHeader) + (usize)fa->header->capacity * (usize)fa->header->elem_size;
+    return msync(fa->header, size, wait ? MS_SYNC : MS_ASYNC) == 0;
+#endif
+}
+
+XTD_DYN_FUNC void XTD_FileArrayClose(XTD_FileArray* fa)
+{
+#if _XTD_HAS_FILE_ARRAY
+    if (fa->header != NULL)
+    {
+        usize elem_size = (usize)fa->header->elem_size;
+        bool writable = !(fa->fda_flags & XTD_FDA_READ_ONLY);
+        if (writable)
+        {
+            fa->header->count = fa->count;
+            fa->header->capacity = fa->count;
+        }
+        munmap(fa->header, sizeof(XTD_FileArrayHeader) + fa->capacity * elem_size);
+        if (writable && fa->capacity > fa->count)
+        {
+            // Gives the reserved capacity back. If it fails the header already says count and
+            // the longer file still opens.
+            int truncated = ftruncate((int)fa->file, (off_t)(sizeof(XTD_FileArrayHeader) + fa->count * elem_size));
+            (void)truncated;
+        }
+    }
+    if (fa->file >= 0)
+        close((int)fa->file);
+#endif
+    XTD_ZERO_STRUCT(fa);
+    fa->file = -1;
+}
+
+//
+// Bitset
+//
+
+#if XTD_HAS_SSE2
+#include <immintrin.h>
+#endif
+
+static void _xtd_BitsetClearTail(XTD_Bitset* bs)
+{
+    if (bs->bit_count & 63)
+        bs->words[bs->word_count - 1] &= XTD_BITBLOCK(bs->bit_count & 63);
+}
+
+XTD_DYN_FUNC bool XTD_BitsetInit(XTD_Bitset* bs, usize bit_count)
+{
+    XTD_ZERO_STRUCT(bs);
+    return XTD_BitsetResize(bs, bit_count);
+}
+
+XTD_DYN_FUNC bool XTD_BitsetResize(XTD_Bitset* bs, usize bit_count)
+{
+    usize word_count = XTD_BITSET_WORDS(bit_count);
+    if (word_count != bs->word_count)
+    {
+        u64* words = (u64*)_XTD_GrowBuffer(bs->words, XTD_MAX(word_count, (usize)1), sizeof(u64));
+        if (words == NULL)
+            return false;
+        if (word_count > bs->word_count)
+            XTD_ZERO_MEM(words + bs->word_count, (word_count - bs->word_count) * sizeof(u64));
+        bs->words = words;
+        bs->word_count = word_count;
+    }
+    bs->bit_count = bit_count;
+    if (word_count)
+        _xtd_BitsetClearTail(bs);
+    return true;
+}
+
+XTD_DYN_FUNC void XTD_BitsetFree(XTD_Bitset* bs)
+{
+    XTD_DYN_FREE(bs->words);
+    XTD_ZERO_STRUCT(bs);
+}
+
+XTD_DYN_FUNC void XTD_BitsetFillRange(XTD_Bitset* bs, usize begin, usize end, bool value)
+{
+    end = XTD_MIN(end, bs->bit_count);
+    if (begin >= end)
+        return;
+
+    usize first_word = begin >> 6;
+    usize last_word = (end - 1) >> 6;
+    u64 first_mask = ~0ULL << (begin & 63);
+    u64 last_mask = ~0ULL >> (63 - ((end - 1) & 63));
+
+    if (first_word == last_word)
+        first_mask &= last_mask;
+
+    if (value)
+        bs->words[first_word] |= first_mask;
+    else
+        bs->words[first_word] &= ~first_mask;
+
+    if (first_word == last_word)
+        return;
+
+    XTD_MEMSET(bs->words + first_word + 1, value ? 0xFF : 0, (last_word - first_word - 1) * sizeof(u64));
+
+    if (value)
+        bs->words[last_word] |= last_mask;
+    else
+        bs->words[last_word] &= ~last_mask;
+}
+
+XTD_DYN_FUNC void XTD_BitsetFill(XTD_Bitset* bs, bool value)
+{
+    XTD_MEMSET(bs->words, value ? 0xFF : 0, bs->word_count * sizeof(u64));
+    if (value && bs->word_count)
+        _xtd_BitsetClearTail(bs);
+}
+
+XTD_DYN_FUNC usize XTD_BitsetCount(const XTD_Bitset* bs)
+{
+    // Independent accumulators so the popcounts can overlap
+    usize c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    usize i = 0;
+    for (; i + 4 <= bs->word_count; i += 4)
+    {
+        c0 += XTD_POPCOUNT64(bs->words[i + 0]);
+        c1 += XTD_POPCOUNT64(bs->words[i + 1]);
+        c2 += XTD_POPCOUNT64(bs->words[i + 2]);
+        c3 += XTD_POPCOUNT64(bs->words[i + 3]);
+    }
+    for (; i < bs->word_count; i++)
+        c0 += XTD_POPCOUNT64(bs->words[i]);
+    return c0 + c1 + c2 + c3;
+}
+
+XTD_DYN_FUNC usize XTD_BitsetFindNext(const XTD_Bitset* bs, usize from)
+{
+    if (from >= bs->bit_count)
+        return bs->bit_count;
+
+    usize w = from >> 6;
+    u64 bits = bs->words[w] & (~0ULL << (from & 63));
+    while (bits == 0)
+    {
+        if (++w >= bs->word_count)
+            return bs->bit_count;
+        bits = bs->words[w];
+    }
+    return w * 64 + XTD_CTZ64(bits);
+}
+
+XTD_DYN_FUNC usize XTD_BitsetFindNextClear(const XTD_Bitset* bs, usize from)
+{
+    if (from >= bs->bit_count)
+        return bs->bit_count;
+
+    usize w = from >> 6;
+    u64 bits = ~bs->words[w] & (~0ULL << (from & 63));
+    while (bits == 0)
+    {
+        if (++w >= bs->word_count)
+            return bs->bit_count;
+        bits = ~bs->words[w];
+    }
+    return XTD_MIN(w * 64 + XTD_CTZ64(bits), bs->bit_count);
+}
+
+// Generates a whole-set binary operation with AVX2/SSE2 main loops and a scalar tail
+#if XTD_HAS_AVX2
+    #define _XTD_BITSET_SIMD_LOOP(avx_op, sse_op) \
+        for (; i + 4 <= n; i += 4) \
+        { \
+            __m256i va = _mm256_loadu_si256((const __m256i*)(a + i)); \
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i)); \
+            _mm256_storeu_si256((__m256i*)(dst + i), avx_op); \
+        }
+#elif XTD_HAS_SSE2
+    #define _XTD_BITSET_SIMD_LOOP(avx_op, sse_op) \
+        for (; i + 2 <= n; i += 2) \
+        { \
+            __m128i va = _mm_loadu_si128((const __m128i*)(a + i)); \
+            __m128i vb = _mm_loadu_si128((const __m128i*)(b + i)); \
+            _mm_storeu_si128((__m128i*)(dst + i), sse_op); \
+        }
+#else
+    #define _XTD_BITSET_SIMD_LOOP(avx_op, sse_op)
+#endif
+
+#define _XTD_BITSET_OP(name, scalar_op, avx_op, sse_op) \
+    XTD_DYN_FUNC void name(XTD_Bitset* out, const XTD_Bitset* in_a, const XTD_Bitset* in_b) \
+    { \
+        XTD_ASSERT(out->bit_count == in_a->bit_count && in_a->bit_count == in_b->bit_count); \
+        u64* dst = out->words; \
+        const u64* a = in_a->words; \
+        const u64* b = in_b->words; \
+        usize n = out->word_count; \
+        usize i = 0; \
+        _XTD_BITSET_SIMD_LOOP(avx_op, sse_op) \
+        for (; i < n; i++) \
+            dst[i] = scalar_op; \
+    }
+
+_XTD_BITSET_OP(XTD_BitsetAnd, a[i] & b[i], _mm256_and_si256(va, vb), _mm_and_si128(va, vb))
+_XTD_BITSET_OP(XTD_BitsetOr, a[i] | b[i], _mm256_or_si256(va, vb), _mm_or_si128(va, vb))
+_XTD_BITSET_OP(XTD_BitsetXor, a[i] ^ b[i], _mm256_xor_si256(va, vb), _mm_xor_si128(va, vb))
+_XTD_BITSET_OP(XTD_BitsetAndNot, a[i] & ~b[i], _mm256_andnot_si256(vb, va), _mm_andnot_si128(vb, va))
+
 #endif
 
 ////////////////////////////////////////
@@ -0,0 +1,378 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Geometry module: rays, bounding boxes and spheres with intersection tests
+// Header only, depends on xtd_math.h
+
+#ifndef XTD_GEOM_HEADER_H
+#define XTD_GEOM_HEADER_H
+
+#ifndef XTD_GEOM_FORCE_INLINE
+#define XTD_GEOM_FORCE_INLINE XTD_FORCE_INLINE
+#endif
+
+#include "xtd_common.h"
+#include "xtd_math.h"
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  Types
+//
+
+// inv_dir is 1 / dir per component, rays built with ray3f keep it in sync.
+// Hits are only reported for t in [t_min, t_max].
+typedef struct {
+    V3f origin;
+    V3f dir;
+    V3f inv_dir;
+    f32 t_min;
+    f32 t_max;
+} Ray3f;
+
+typedef struct {
+    V3f min;
+    V3f max;
+} AABB3f;
+
+typedef struct {
+    V3f center;
+    f32 radius;
+} Sphere3f;
+
+////////////////////////////////////////
+//
+//  Construction and bounds
+//
+
+XTD_GEOM_FORCE_INLINE Ray3f ray3f(V3f origin, V3f dir) {
+    Ray3f ray;
+    ray.origin = origin;
+    ray.dir = dir;
+    ray.inv_dir.x = 1.0f / dir.x;
+    ray.inv_dir.y = 1.0f / dir.y;
+    ray.inv_dir.z = 1.0f / dir.z;
+    ray.t_min = 0.0f;
+    ray.t_max = FLT_MAX;
+    return ray;
+}
+
+XTD_GEOM_FORCE_INLINE V3f rayAt3f(const Ray3f* ray, f32 t) {
+    return add3f(ray->origin, sc3f(ray->dir, t));
+}
+
+XTD_GEOM_FORCE_INLINE AABB3f aabb3f(V3f min, V3f max) {
+    AABB3f box;
+    box.min = min;
+    box.max = max;
+    return box;
+}
+
+// Inverted box that any union or expand overrides
+XTD_GEOM_FORCE_INLINE AABB3f aabbEmpty3f(void) {
+    AABB3f box;
+    box.min.x = box.min.y = box.min.z = FLT_MAX;
+    box.max.x = box.max.y = box.max.z = -FLT_MAX;
+    return box;
+}
+
+XTD_GEOM_FORCE_INLINE AABB3f aabbExpand3f(AABB3f box, V3f p) {
+    box.min.x = XTD_MIN(box.min.x, p.x);
+    box.min.y = XTD_MIN(box.min.y, p.y);
+    box.min.z = XTD_MIN(box.min.z, p.z);
+    box.max.x = XTD_MAX(box.max.x, p.x);
+    box.max.y = XTD_MAX(box.max.y, p.y);
+    box.max.z = XTD_MAX(box.max.z, p.z);
+    return box;
+}
+
+XTD_GEOM_FORCE_INLINE AABB3f aabbUnion3f(AABB3f a, AABB3f b) {
+    a = aabbExpand3f(a, b.min);
+    return aabbExpand3f(a, b.max);
+}
+
+XTD_GEOM_FORCE_INLINE V3f aabbCenter3f(AABB3f box) {
+    return sc3f(add3f(box.min, box.max), 0.5f);
+}
+
+XTD_GEOM_FORCE_INLINE V3f aabbExtent3f(AABB3f box) {
+    return sub3f(box.max, box.min);
+}
+
+XTD_GEOM_FORCE_INLINE f32 aabbSurfaceArea3f(AABB3f box) {
+    V3f e = aabbExtent3f(box);
+    return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+XTD_GEOM_FORCE_INLINE AABB3f sphereBounds3f(Sphere3f s) {
+    V3f r = {{s.radius, s.radius, s.radius}};
+    return aabb3f(sub3f(s.center, r), add3f(s.center, r));
+}
+
+////////////////////////////////////////
+//
+//  Intersection
+//
+
+// Slab test, returns the entry distance (clamped to t_min) in t_hit, which can be NULL.
+// Rays starting inside the box hit at t_min.
+XTD_GEOM_FORCE_INLINE bool rayAABB3f(const Ray3f* ray, AABB3f box, f32* t_hit) {
+    f32 t0 = ray->t_min;
+    f32 t1 = ray->t_max;
+    for (int i = 0; i < 3; i++)
+    {
+        f32 t_near = (box.min.e[i] - ray->origin.e[i]) * ray->inv_dir.e[i];
+        f32 t_far = (box.max.e[i] - ray->origin.e[i]) * ray->inv_dir.e[i];
+        // Selects instead of a swap so this compiles to min/max without branches
+        f32 t_enter = t_near < t_far ? t_near : t_far;
+        f32 t_exit = t_near < t_far ? t_far : t_near;
+        t0 = t_enter > t0 ? t_enter : t0;
+        t1 = t_exit < t1 ? t_exit : t1;
+    }
+    if (t_hit)
+        *t_hit = t0;
+    return t0 <= t1;
+}
+
+// Nearest hit in [t_min, t_max], the far side is reported when the ray starts inside.
+// dir doesn't need to be normalized.
+XTD_GEOM_FORCE_INLINE bool raySphere3f(const Ray3f* ray, Sphere3f s, f32* t_hit) {
+    V3f oc = sub3f(ray->origin, s.center);
+    f32 a = dot3f(ray->dir, ray->dir);
+    f32 b = dot3f(oc, ray->dir);
+    f32 c = dot3f(oc, oc) - s.radius * s.radius;
+    f32 disc = b * b - a * c;
+    if (disc < 0.0f)
+        return false;
+    f32 sq = sqrtf(disc);
+    f32 t = (-b - sq) / a;
+    if (t < ray->t_min)
+        t = (-b + sq) / a;
+    if (t < ray->t_min || t > ray->t_max)
+        return false;
+    if (t_hit)
+        *t_hit = t;
+    return true;
+}
+
+// Moller-Trumbore, double sided. u and v are the barycentric weights of b and c,
+// t_hit, u_hit and v_hit can be NULL.
+XTD_GEOM_FORCE_INLINE bool rayTriangle3f(const Ray3f* ray, V3f a, V3f b, V3f c, f32* t_hit, f32* u_hit, f32* v_hit) {
+    V3f e1 = sub3f(b, a);
+    V3f e2 = sub3f(c, a);
+    V3f p = cross3f(ray->dir, e2);
+    f32 det = dot3f(e1, p);
+    if (det == 0.0f)
+        return false;
+    f32 inv_det = 1.0f / det;
+    V3f s = sub3f(ray->origin, a);
+    f32 u = dot3f(s, p) * inv_det;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+    V3f q = cross3f(s, e1);
+    f32 v = dot3f(ray->dir, q) * inv_det;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+    f32 t = dot3f(e2, q) * inv_det;
+    if (t < ray->t_min || t > ray->t_max)
+        return false;
+    if (t_hit)
+        *t_hit = t;
+    if (u_hit)
+        *u_hit = u;
+    if (v_hit)
+        *v_hit = v;
+    return true;
+}
+
+////////////////////////////////////////
+//
+//  Packet intersection
+//
+
+// SoA packets of 4 (SSE2) or 8 (AVX2) boxes or rays, one per lane.
+// The packet tests return a lane mask (bit i set if lane i hit) and the per-lane
+// entry distance in t_hit, which can be NULL. Lanes that miss have undefined t_hit.
+
+#if XTD_HAS_SSE2
+
+typedef struct {
+    F32x4 min_x, min_y, min_z;
+    F32x4 max_x, max_y, max_z;
+} AABB3fx4;
+
+typedef struct {
+    F32x4 origin_x, origin_y, origin_z;
+    F32x4 inv_dir_x, inv_dir_y, inv_dir_z;
+    F32x4 t_min, t_max;
+} Ray3fx4;
+
+// Gathers the f32 at byte 'offset' of 4 structs laid out 'stride' bytes apart
+XTD_GEOM_FORCE_INLINE F32x4 _xtd_GatherLanes4(const void* base, usize stride, usize offset) {
+    const u8* p = (const u8*)base + offset;
+    return _mm_setr_ps(*(const f32*)(p), *(const f32*)(p + stride), *(const f32*)(p + 2 * stride), *(const f32*)(p + 3 * stride));
+}
+
+XTD_GEOM_FORCE_INLINE AABB3fx4 packAABB3fx4(const AABB3f boxes[4]) {
+    AABB3fx4 p;
+    p.min_x = _xtd_GatherLanes4(boxes, sizeof(AABB3f), offsetof(AABB3f, min.x));
+    p.min_y = _xtd_GatherLanes4(boxes, sizeof(AABB3f), offsetof(AABB3f, min.y));
+    p.min_z = _xtd_GatherLanes4(boxes, sizeof(AABB3f), offsetof(AABB3f, min.z));
+    p.max_x = _xtd_GatherLanes4(boxes, sizeof(AABB3f), offsetof(AABB3f, max.x));
+    p.max_y = _xtd_GatherLanes4(boxes, sizeof(AABB3f), offsetof(AABB3f, max.y));
+    p.max_z = _xtd_GatherLanes4(boxes, sizeof(AABB3f), offsetof(AABB3f, max.z));
+    return p;
+}
+
+XTD_GEOM_FORCE_INLINE Ray3fx4 packRay3fx4(const Ray3f rays[4]) {
+    Ray3fx4 p;
+    p.origin_x = _xtd_GatherLanes4(rays, sizeof(Ray3f), offsetof(Ray3f, origin.x));
+    p.origin_y = _xtd_GatherLanes4(rays, sizeof(Ray3f), offsetof(Ray3f, origin.y));
+    p.origin_z = _xtd_GatherLanes4(rays, sizeof(Ray3f), offsetof(Ray3f, origin.z));
+    p.inv_dir_x = _xtd_GatherLanes4(rays, sizeof(Ray3f), offsetof(Ray3f, inv_dir.x));
+    p.inv_dir_y = _xtd_GatherLanes4(rays, sizeof(Ray3f), offsetof(Ray3f, inv_dir.y));
+    p.inv_dir_z = _xtd_GatherLanes4(rays, sizeof(Ray3f), offsetof(Ray3f, inv_dir.z));
+    p.t_min = _xtd_GatherLanes4(rays, sizeof(Ray3f), offsetof(Ray3f, t_min));
+    p.t_max = _xtd_GatherLanes4(rays, sizeof(Ray3f), offsetof(Ray3f, t_max));
+    return p;
+}
+
+// Slab test shared by both packet layouts, operands are either per lane or broadcast
+XTD_GEOM_FORCE_INLINE u32 _xtd_Slab4(const Ray3fx4* r, const AABB3fx4* b, F32x4* t_hit) {
+    F32x4 tx0 = _mm_mul_ps(_mm_sub_ps(b->min_x, r->origin_x), r->inv_dir_x);
+    F32x4 tx1 = _mm_mul_ps(_mm_sub_ps(b->max_x, r->origin_x), r->inv_dir_x);
+    F32x4 ty0 = _mm_mul_ps(_mm_sub_ps(b->min_y, r->origin_y), r->inv_dir_y);
+    F32x4 ty1 = _mm_mul_ps(_mm_sub_ps(b->max_y, r->origin_y), r->inv_dir_y);
+    F32x4 tz0 = _mm_mul_ps(_mm_sub_ps(b->min_z, r->origin_z), r->inv_dir_z);
+    F32x4 tz1 = _mm_mul_ps(_mm_sub_ps(b->max_z, r->origin_z), r->inv_dir_z);
+    F32x4 t0 = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)), _mm_max_ps(_mm_min_ps(tz0, tz1), r->t_min));
+    F32x4 t1 = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx0, tx1), _mm_max_ps(ty0, ty1)), _mm_min_ps(_mm_max_ps(tz0, tz1), r->t_max));
+    if (t_hit)
+        *t_hit = t0;
+    return (u32)_mm_movemask_ps(_mm_cmple_ps(t0, t1));
+}
+
+// One ray against 4 boxes
+XTD_GEOM_FORCE_INLINE u32 rayAABB3fx4(const Ray3f* ray, const AABB3fx4* boxes, F32x4* t_hit) {
+    Ray3fx4 r;
+    r.origin_x = _mm_set1_ps(ray->origin.x);
+    r.origin_y = _mm_set1_ps(ray->origin.y);
+    r.origin_z = _mm_set1_ps(ray->origin.z);
+    r.inv_dir_x = _mm_set1_ps(ray->inv_dir.x);
+    r.inv_dir_y = _mm_set1_ps(ray->inv_dir.y);
+    r.inv_dir_z = _mm_set1_ps(ray->inv_dir.z);
+    r.t_min = _mm_set1_ps(ray->t_min);
+    r.t_max = _mm_set1_ps(ray->t_max);
+    return _xtd_Slab4(&r, boxes, t_hit);
+}
+
+// 4 rays against one box
+XTD_GEOM_FORCE_INLINE u32 rayPacketAABB3fx4(const Ray3fx4* rays, AABB3f box, F32x4* t_hit) {
+    AABB3fx4 b;
+    b.min_x = _mm_set1_ps(box.min.x);
+    b.min_y = _mm_set1_ps(box.min.y);
+    b.min_z = _mm_set1_ps(box.min.z);
+    b.max_x = _mm_set1_ps(box.max.x);
+    b.max_y = _mm_set1_ps(box.max.y);
+    b.max_z = _mm_set1_ps(box.max.z);
+    return _xtd_Slab4(rays, &b, t_hit);
+}
+
+#endif // XTD_HAS_SSE2
+
+#if XTD_HAS_AVX2
+
+typedef struct {
+    F32x8 min_x, min_y, min_z;
+    F32x8 max_x, max_y, max_z;
+} AABB3fx8;
+
+typedef struct {
+    F32x8 origin_x, origin_y, origin_z;
+    F32x8 inv_dir_x, inv_dir_y, inv_dir_z;
+    F32x8 t_min, t_max;
+} Ray3fx8;
+
+XTD_GEOM_FORCE_INLINE F32x8 _xtd_GatherLanes8(const void* base, usize stride, usize offset) {
+    const u8* p = (const u8*)base + offset;
+    return _mm256_setr_ps(*(const f32*)(p), *(const f32*)(p + stride), *(const f32*)(p + 2 * stride),
+        *(const f32*)(p + 3 * stride), *(const f32*)(p + 4 * stride), *(const f32*)(p + 5 * stride),
+        *(const f32*)(p + 6 * stride), *(const f32*)(p + 7 * stride));
+}
+
+XTD_GEOM_FORCE_INLINE AABB3fx8 packAABB3fx8(const AABB3f boxes[8]) {
+    AABB3fx8 p;
+    p.min_x = _xtd_GatherLanes8(boxes, sizeof(AABB3f), offsetof(AABB3f, min.x));
+    p.min_y = _xtd_GatherLanes8(boxes, sizeof(AABB3f), offsetof(AABB3f, min.y));
+    p.min_z = _xtd_GatherLanes8(boxes, sizeof(AABB3f), offsetof(AABB3f, min.z));
+    p.max_x = _xtd_GatherLanes8(boxes, sizeof(AABB3f), offsetof(AABB3f, max.x));
+    p.max_y = _xtd_GatherLanes8(boxes, sizeof(AABB3f), offsetof(AABB3f, max.y));
+    p.max_z = _xtd_GatherLanes8(boxes, sizeof(AABB3f), offsetof(AABB3f, max.z));
+    return p;
+}
+
+XTD_GEOM_FORCE_INLINE Ray3fx8 packRay3fx8(const Ray3f rays[8]) {
+    Ray3fx8 p;
+    p.origin_x = _xtd_GatherLanes8(rays, sizeof(Ray3f), offsetof(Ray3f, origin.x));
+    p.origin_y = _xtd_GatherLanes8(rays, sizeof(Ray3f), offsetof(Ray3f, origin.y));
+    p.origin_z = _xtd_GatherLanes8(rays, sizeof(Ray3f), offsetof(Ray3f, origin.z));
+    p.inv_dir_x = _xtd_GatherLanes8(rays, sizeof(Ray3f), offsetof(Ray3f, inv_dir.x));
+    p.inv_dir_y = _xtd_GatherLanes8(rays, sizeof(Ray3f), offsetof(Ray3f, inv_dir.y));
+    p.inv_dir_z = _xtd_GatherLanes8(rays, sizeof(Ray3f), offsetof(Ray3f, inv_dir.z));
+    p.t_min = _xtd_GatherLanes8(rays, sizeof(Ray3f), offsetof(Ray3f, t_min));
+    p.t_max = _xtd_GatherLanes8(rays, sizeof(Ray3f), offsetof(Ray3f, t_max));
+    return p;
+}
+
+XTD_GEOM_FORCE_INLINE u32 _xtd_Slab8(const Ray3fx8* r, const AABB3fx8* b, F32x8* t_hit) {
+    F32x8 tx0 = _mm256_mul_ps(_mm256_sub_ps(b->min_x, r->origin_x), r->inv_dir_x);
+    F32x8 tx1 = _mm256_mul_ps(_mm256_sub_ps(b->max_x, r->origin_x), r->inv_dir_x);
+    F32x8 ty0 = _mm256_mul_ps(_mm256_sub_ps(b->min_y, r->origin_y), r->inv_dir_y);
+    F32x8 ty1 = _mm256_mul_ps(_mm256_sub_ps(b->max_y, r->origin_y), r->inv_dir_y);
+    F32x8 tz0 = _mm256_mul_ps(_mm256_sub_ps(b->min_z, r->origin_z), r->inv_dir_z);
+    F32x8 tz1 = _mm256_mul_ps(_mm256_sub_ps(b->max_z, r->origin_z), r->inv_dir_z);
+    F32x8 t0 = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(tx0, tx1), _mm256_min_ps(ty0, ty1)), _mm256_max_ps(_mm256_min_ps(tz0, tz1), r->t_min));
+    F32x8 t1 = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(tx0, tx1), _mm256_max_ps(ty0, ty1)), _mm256_min_ps(_mm256_max_ps(tz0, tz1), r->t_max));
+    if (t_hit)
+        *t_hit = t0;
+    return (u32)_mm256_movemask_ps(_mm256_cmp_ps(t0, t1, _CMP_LE_OQ));
+}
+
+// One ray against 8 boxes
+XTD_GEOM_FORCE_INLINE u32 rayAABB3fx8(const Ray3f* ray, const AABB3fx8* boxes, F32x8* t_hit) {
+    Ray3fx8 r;
+    r.origin_x = _mm256_set1_ps(ray->origin.x);
+    r.origin_y = _mm256_set1_ps(ray->origin.y);
+    r.origin_z = _mm256_set1_ps(ray->origin.z);
+    r.inv_dir_x = _mm256_set1_ps(ray->inv_dir.x);
+    r.inv_dir_y = _mm256_set1_ps(ray->inv_dir.y);
+    r.inv_dir_z = _mm256_set1_ps(ray->inv_dir.z);
+    r.t_min = _mm256_set1_ps(ray->t_min);
+    r.t_max = _mm256_set1_ps(ray->t_max);
+    return _xtd_Slab8(&r, boxes, t_hit);
+}
+
+// 8 rays against one box
+XTD_GEOM_FORCE_INLINE u32 rayPacketAABB3fx8(const Ray3fx8* rays, AABB3f box, F32x8* t_hit) {
+    AABB3fx8 b;
+    b.min_x = _mm256_set1_ps(box.min.x);
+    b.min_y = _mm256_set1_ps(box.min.y);
+    b.min_z = _mm256_set1_ps(box.min.z);
+    b.max_x = _mm256_set1_ps(box.max.x);
+    b.max_y = _mm256_set1_ps(box.max.y);
+    b.max_z = _mm256_set1_ps(box.max.z);
+    return _xtd_Slab8(rays, &b, t_hit);
+}
+
+#endif // XTD_HAS_AVX2
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_GEOM_HEADER_H
@@ -0,0 +1,509 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Non-cryptographic hashing module
+// #define XTD_HASH_IMPLEMENTATION to include the implementation
+
+#ifndef XTD_HASH_HEADER_H
+#define XTD_HASH_HEADER_H
+
+#ifndef XTD_HASH_FUNC
+#define XTD_HASH_FUNC
+#endif
+
+#ifndef XTD_HASH_FUNC_DECL
+#define XTD_HASH_FUNC_DECL extern
+#endif
+
+#include "xtd_common.h"
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  Integer Mixers
+//
+
+// Bijective mixers for hash tables keyed by integers or pointers, 0 maps to 0.
+// 32 bit one is lowbias32 by Chris Wellons, 64 bit one is Pelle Evensen's moremur.
+
+XTD_FORCE_INLINE u32 XTD_HashU32(u32 x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+XTD_FORCE_INLINE u64 XTD_HashU64(u64 x) {
+    x ^= x >> 27;
+    x *= 0x3C79AC492BA7B653ULL;
+    x ^= x >> 33;
+    x *= 0x1C69B3F74AC4AE35ULL;
+    x ^= x >> 27;
+    return x;
+}
+
+XTD_FORCE_INLINE u64 XTD_HashPtr(const void* p) {
+    return XTD_HashU64((u64)(uintptr_t)p);
+}
+
+// Order dependent, combining (a, b) and (b, a) gives different results
+XTD_FORCE_INLINE u64 XTD_HashCombine(u64 h, u64 value) {
+    return XTD_HashU64(h ^ (value + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2)));
+}
+
+////////////////////////////////////////
+//
+//  Byte Hashing
+//
+
+// 64 bit hash of byte spans. Inputs up to 256 bytes go through a wyhash style path built on
+// 64x64->128 bit multiplies, longer ones through 8 independent lanes over 64 byte stripes
+// (like XXH3) that are accumulated with SSE2 or AVX2 when enabled.
+// Values do not match wyhash or XXH3, but are the same on every little endian platform and
+// whatever instruction set is enabled, so they can be stored (e.g. in cache keys).
+
+#define XTD_HASH_BUFFER_SIZE 256
+
+// Streaming state, feeding the data in any number of chunks gives the same value as XTD_Hash64
+typedef struct {
+    u64 acc[8];
+    u64 key[24];
+    u64 seed;
+    u64 total_len;
+    u64 stripe_index;
+    u32 buffered;
+    u8 buffer[XTD_HASH_BUFFER_SIZE];
+    u8 last_stripe[64]; // Last 64 consumed bytes, for when the final stripe overlaps them
+} XTD_HashState;
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+XTD_HASH_FUNC_DECL u64 XTD_Hash64(const void* data, usize len, u64 seed);
+
+XTD_HASH_FUNC_DECL void XTD_HashInit(XTD_HashState* state, u64 seed);
+XTD_HASH_FUNC_DECL void XTD_HashUpdate(XTD_HashState* state, const void* data, usize len);
+// Does not modify the state, more data can be added afterwards
+XTD_HASH_FUNC_DECL u64 XTD_HashDigest(const XTD_HashState* state);
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_HASH_IMPLEMENTATION
+
+#include <string.h>
+
+#if XTD_HAS_SSE2 || XTD_HAS_CPU_DISPATCH
+#include <immintrin.h>
+#endif
+
+#define _XTD_HASH_STRIPE 64
+#define _XTD_HASH_BLOCK_STRIPES 8
+#define _XTD_HASH_SCRAMBLE_KEY 16 // Keys [16, 24) scramble the lanes after every block of stripes
+#define _XTD_HASH_LAST_KEY 11     // Window for the final stripe, no regular stripe starts there
+#define _XTD_HASH_MERGE_KEY 3
+#define _XTD_HASH_SCRAMBLE_MUL 0x9E3779B1u
+
+// Odd with 32 bits set, from splitmix64 seeded with the first digits of pi
+static const u64 _xtd_hash_secret[24] = {
+    0x2CB0F69F4ABEA221ULL, 0xDD555950609DFE03ULL, 0xD2F4C799A2023CBDULL, 0xBF194DB8434A346DULL,
+    0x8C7D1D0D3D4A8EC5ULL, 0xA08F47EDD89B430BULL, 0x986360357932DCBDULL, 0xB2FD49E41FA25861ULL,
+    0x75931E90D5B688CDULL, 0x3E6B1D5CF28C5483ULL, 0x8E70BBB87A85A239ULL, 0xBF2966D283C64F11ULL,
+    0x1734BD4C86DE6E03ULL, 0x893BC7D1412EAE2DULL, 0x4AFA1F062E65178BULL, 0x43431F435C4CE1BFULL,
+    0x5C8E5CB0D53AC91DULL, 0x1E64127F5546DE29ULL, 0x661609E0DF62D2BDULL, 0xAA6BE65E2B80CB15ULL,
+    0x569A0959AF52A96DULL, 0xA153A8179073BAAFULL, 0x1C59F2BE15916987ULL, 0xD2A8CC646C355F1BULL,
+};
+
+static const u64 _xtd_hash_acc_init[8] = {
+    0x00000000C2B2AE3DULL, 0x9E3779B185EBCA87ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+    0x85EBCA77C2B2AE63ULL, 0x0000000085EBCA77ULL, 0x27D4EB2F165667C5ULL, 0x000000009E3779B1ULL,
+};
+
+XTD_FORCE_INLINE u64 _xtd_HashRead64(const u8* p)
+{
+    u64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+XTD_FORCE_INLINE u64 _xtd_HashRead32(const u8* p)
+{
+    u32 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Full 128 bit product of a and b, low half in a and high half in b
+XTD_FORCE_INLINE void _xtd_HashMum(u64* a, u64* b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (u64)r;
+    *b = (u64)(r >> 64);
+#elif XTD_IS_COMPILER_MSVC && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    u64 ha = *a >> 32, hb = *b >> 32, la = (u32)*a, lb = (u32)*b;
+    u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    u64 t = rl + (rm0 << 32), c = t < rl;
+    u64 lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+XTD_FORCE_INLINE u64 _xtd_HashMix(u64 a, u64 b)
+{
+    _xtd_HashMum(&a, &b);
+    return a ^ b;
+}
+
+static u64 _xtd_HashShort(const u8* p, usize len, u64 seed)
+{
+    const u64* s = _xtd_hash_secret;
+    u64 a, b;
+    seed ^= _xtd_HashMix(seed ^ s[0], s[1]);
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            usize mid = (len >> 3) << 2;
+            a = (_xtd_HashRead32(p) << 32) | _xtd_HashRead32(p + mid);
+            b = (_xtd_HashRead32(p + len - 4) << 32) | _xtd_HashRead32(p + len - 4 - mid);
+        } else if (len > 0)
+        {
+            a = ((u64)p[0] << 16) | ((u64)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else
+        {
+            a = b = 0;
+        }
+    } else
+    {
+        usize i = len;
+        if (i > 48)
+        {
+            u64 see1 = seed, see2 = seed;
+            do
+            {
+                seed = _xtd_HashMix(_xtd_HashRead64(p) ^ s[1], _xtd_HashRead64(p + 8) ^ seed);
+                see1 = _xtd_HashMix(_xtd_HashRead64(p + 16) ^ s[2], _xtd_HashRead64(p + 24) ^ see1);
+                see2 = _xtd_HashMix(_xtd_HashRead64(p + 32) ^ s[3], _xtd_HashRead64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = _xtd_HashMix(_xtd_HashRead64(p) ^ s[1], _xtd_HashRead64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // Last 16 bytes of the input, may overlap the ones already mixed
+        a = _xtd_HashRead64(p + i - 16);
+        b = _xtd_HashRead64(p + i - 8);
+    }
+    a ^= s[1];
+    b ^= seed;
+    _xtd_HashMum(&a, &b);
+    return _xtd_HashMix(a ^ s[0] ^ (u64)len, b ^ s[1]);
+}
+
+////////////////////////////////////////
+//
+//  Long inputs
+//
+
+// Every stripe adds the raw input words into the neighbouring lane and the product of the
+// 32 bit halves of input ^ key into its own lane. Lanes are scrambled after every block
+// so the products can not cancel out.
+
+static void _xtd_HashAccumulateScalar(u64* acc, const u8* p, usize stripes, const u64* key)
+{
+    for (usize s = 0; s < stripes; s++, p += _XTD_HASH_STRIPE)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            u64 d = _xtd_HashRead64(p + i * 8);
+            u64 dk = d ^ key[s + i];
+            acc[i ^ 1] += d;
+            acc[i] += (dk & 0xFFFFFFFF) * (dk >> 32);
+        }
+    }
+}
+
+static void _xtd_HashScrambleScalar(u64* acc, const u64* key)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        u64 a = acc[i];
+        a ^= a >> 47;
+        a ^= key[i];
+        acc[i] = a * _XTD_HASH_SCRAMBLE_MUL;
+    }
+}
+
+#if XTD_HAS_SSE2
+
+static void _xtd_HashAccumulateSSE2(u64* acc, const u8* p, usize stripes, const u64* key)
+{
+    __m128i a[4];
+    for (int i = 0; i < 4; i++)
+        a[i] = _mm_loadu_si128((const __m128i*)(acc + i * 2));
+    for (usize s = 0; s < stripes; s++, p += _XTD_HASH_STRIPE)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            __m128i d = _mm_loadu_si128((const __m128i*)(p + i * 16));
+            __m128i dk = _mm_xor_si128(d, _mm_loadu_si128((const __m128i*)(key + s + i * 2)));
+            a[i] = _mm_add_epi64(a[i], _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)));
+            a[i] = _mm_add_epi64(a[i], _mm_mul_epu32(dk, _mm_srli_epi64(dk, 32)));
+        }
+    }
+    for (int i = 0; i < 4; i++)
+        _mm_storeu_si128((__m128i*)(acc + i * 2), a[i]);
+}
+
+static void _xtd_HashScrambleSSE2(u64* acc, const u64* key)
+{
+    __m128i mul = _mm_set1_epi32((i32)_XTD_HASH_SCRAMBLE_MUL);
+    for (int i = 0; i < 4; i++)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(acc + i * 2));
+        a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)(key + i * 2)));
+        // 64x32 bit multiply from two 32x32->64 ones
+        __m128i lo = _mm_mul_epu32(a, mul);
+        __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), mul);
+        _mm_storeu_si128((__m128i*)(acc + i * 2), _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+    }
+}
+
+#endif
+
+#if XTD_HAS_AVX2 || XTD_HAS_CPU_DISPATCH
+
+static XTD_TARGET_AVX2 void _xtd_HashAccumulateAVX2(u64* acc, const u8* p, usize stripes, const u64* key)
+{
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+    for (usize s = 0; s < stripes; s++, p += _XTD_HASH_STRIPE)
+    {
+        __m256i d0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i d1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+        __m256i dk0 = _mm256_xor_si256(d0, _mm256_loadu_si256((const __m256i*)(key + s)));
+        __m256i dk1 = _mm256_xor_si256(d1, _mm256_loadu_si256((const __m256i*)(key + s + 4)));
+        a0 = _mm256_add_epi64(a0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2)));
+        a1 = _mm256_add_epi64(a1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2)));
+        a0 = _mm256_add_epi64(a0, _mm256_mul_epu32(dk0, _mm256_srli_epi64(dk0, 32)));
+        a1 = _mm256_add_epi64(a1, _mm256_mul_epu32(dk1, _mm256_srli_epi64(dk1, 32)));
+    }
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+}
+
+static XTD_TARGET_AVX2 void _xtd_HashScrambleAVX2(u64* acc, const u64* key)
+{
+    __m256i mul = _mm256_set1_epi32((i32)_XTD_HASH_SCRAMBLE_MUL);
+    for (int i = 0; i < 2; i++)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(acc + i * 4));
+        a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)(key + i * 4)));
+        // 64x32 bit multiply from two 32x32->64 ones
+        __m256i lo = _mm256_mul_epu32(a, mul);
+        __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), mul);
+        _mm256_storeu_si256((__m256i*)(acc + i * 4), _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+    }
+}
+
+#endif
+
+typedef struct {
+    void (*accumulate)(u64* acc, const u8* p, usize stripes, const u64* key);
+    void (*scramble)(u64* acc, const u64* key);
+} _XTD_HashKernels;
+
+// Best kernels for the running CPU, fetched once per hash or update call
+static const _XTD_HashKernels* _xtd_HashGetKernels(void)
+{
+    static const _XTD_HashKernels scalar = {_xtd_HashAccumulateScalar, _xtd_HashScrambleScalar};
+    XTD_CPUTier tier = XTD_GetCPUTier();
+    (void)tier;
+#if XTD_HAS_AVX2 || XTD_HAS_CPU_DISPATCH
+    static const _XTD_HashKernels avx2 = {_xtd_HashAccumulateAVX2, _xtd_HashScrambleAVX2};
+    if (tier >= XTD_CPU_TIER_AVX2)
+        return &avx2;
+#endif
+#if XTD_HAS_SSE2
+    static const _XTD_HashKernels sse2 = {_xtd_HashAccumulateSSE2, _xtd_HashScrambleSSE2};
+    if (tier >= XTD_CPU_TIER_SSE2)
+        return &sse2;
+#endif
+    return &scalar;
+}
+
+// Stripe keys are offset by the stripe position in its block
+static void _xtd_HashConsumeStripes(const _XTD_HashKernels* k, u64* acc, u64* stripe_index, const u8* p, usize stripes, const u64* key)
+{
+    while (stripes > 0)
+    {
+        usize first = (usize)(*stripe_index % _XTD_HASH_BLOCK_STRIPES);
+        usize count = XTD_MIN(_XTD_HASH_BLOCK_STRIPES - first, stripes);
+        k->accumulate(acc, p, count, key + first);
+        p += count * _XTD_HASH_STRIPE;
+        stripes -= count;
+        *stripe_index += count;
+        if (*stripe_index % _XTD_HASH_BLOCK_STRIPES == 0)
+            k->scramble(acc, key + _XTD_HASH_SCRAMBLE_KEY);
+    }
+}
+
+static void _xtd_HashDeriveKey(u64* key, u64 seed)
+{
+    for (int i = 0; i < 24; i += 2)
+    {
+        key[i] = _xtd_hash_secret[i] + seed;
+        key[i + 1] = _xtd_hash_secret[i + 1] - seed;
+    }
+}
+
+static u64 _xtd_HashMerge(const u64* acc, const u64* key, u64 total_len)
+{
+    u64 h = total_len * 0x9E3779B185EBCA87ULL;
+    for (int i = 0; i < 4; i++)
+        h += _xtd_HashMix(acc[i * 2] ^ key[_XTD_HASH_MERGE_KEY + i * 2], acc[i * 2 + 1] ^ key[_XTD_HASH_MERGE_KEY + i * 2 + 1]);
+    return XTD_HashU64(h);
+}
+
+// Full stripes are the ones before the last byte, the final stripe is always the last 64 bytes
+static u64 _xtd_HashLong(const u8* p, usize len, u64 seed)
+{
+    const _XTD_HashKernels* k = _xtd_HashGetKernels();
+    u64 acc[8], key[24], stripe_index = 0;
+    memcpy(acc, _xtd_hash_acc_init, sizeof(acc));
+    _xtd_HashDeriveKey(key, seed);
+    _xtd_HashConsumeStripes(k, acc, &stripe_index, p, (len - 1) / _XTD_HASH_STRIPE, key);
+    k->accumulate(acc, p + len - _XTD_HASH_STRIPE, 1, key + _XTD_HASH_LAST_KEY);
+    return _xtd_HashMerge(acc, key, len);
+}
+
+XTD_HASH_FUNC u64 XTD_Hash64(const void* data, usize len, u64 seed)
+{
+    if (len <= XTD_HASH_BUFFER_SIZE)
+        return _xtd_HashShort((const u8*)data, len, seed);
+    return _xtd_HashLong((const u8*)data, len, seed);
+}
+
+////////////////////////////////////////
+//
+//  Streaming
+//
+
+// Stripes are only consumed once more data follows them, so the buffer always keeps the last
+// 1 to 256 bytes and inputs up to 256 bytes can use the short path on digest
+
+XTD_HASH_FUNC void XTD_HashInit(XTD_HashState* state, u64 seed)
+{
+    XTD_ZERO_STRUCT(state);
+    memcpy(state->acc, _xtd_hash_acc_init, sizeof(state->acc));
+    _xtd_HashDeriveKey(state->key, seed);
+    state->seed = seed;
+}
+
+XTD_HASH_FUNC void XTD_HashUpdate(XTD_HashState* state, const void* data, usize len)
+{
+    const u8* p = (const u8*)data;
+    state->total_len += len;
+    if (state->buffered + len <= XTD_HASH_BUFFER_SIZE)
+    {
+        if (len > 0)
+            memcpy(state->buffer + state->buffered, p, len);
+        state->buffered += (u32)len;
+        return;
+    }
+
+    const _XTD_HashKernels* k = _xtd_HashGetKernels();
+    const u8* consumed_end = NULL;
+    if (state->buffered > 0)
+    {
+        usize fill = XTD_HASH_BUFFER_SIZE - state->buffered;
+        memcpy(state->buffer + state->buffered, p, fill);
+        p += fill;
+        len -= fill;
+        _xtd_HashConsumeStripes(k, state->acc, &state->stripe_index, state->buffer, XTD_HASH_BUFFER_SIZE / _XTD_HASH_STRIPE, state->key);
+        consumed_end = state->buffer + XTD_HASH_BUFFER_SIZE;
+        state->buffered = 0;
+    }
+    if (len > XTD_HASH_BUFFER_SIZE)
+    {
+        usize stripes = (len - 1) / _XTD_HASH_STRIPE;
+        _xtd_HashConsumeStripes(k, state->acc, &state->stripe_index, p, stripes, state->key);
+        p += stripes * _XTD_HASH_STRIPE;
+        len -= stripes * _XTD_HASH_STRIPE;
+        consumed_end = p;
+    }
+    memcpy(state->last_stripe, consumed_end - _XTD_HASH_STRIPE, _XTD_HASH_STRIPE);
+    memcpy(state->buffer, p, len);
+    state->buffered = (u32)len;
+}
+
+XTD_HASH_FUNC u64 XTD_HashDigest(const XTD_HashState* state)
+{
+    if (state->total_len <= XTD_HASH_BUFFER_SIZE)
+        return _xtd_HashShort(state->buffer, (usize)state->total_len, state->seed);
+
+    const _XTD_HashKernels* k = _xtd_HashGetKernels();
+    u64 acc[8], stripe_index = state->stripe_index;
+    memcpy(acc, state->acc, sizeof(acc));
+    usize stripes = (state->buffered - 1) / _XTD_HASH_STRIPE;
+    _xtd_HashConsumeStripes(k, acc, &stripe_index, state->buffer, stripes, state->key);
+
+    u8 last[_XTD_HASH_STRIPE];
+    if (state->buffered >= _XTD_HASH_STRIPE)
+    {
+        memcpy(last, state->buffer + state->buffered - _XTD_HASH_STRIPE, _XTD_HASH_STRIPE);
+    } else
+    {
+        usize old = _XTD_HASH_STRIPE - state->buffered;
+        memcpy(last, state->last_stripe + state->buffered, old);
+        memcpy(last + old, state->buffer, state->buffered);
+    }
+    k->accumulate(acc, last, 1, state->key + _XTD_HASH_LAST_KEY);
+    return _xtd_HashMerge(acc, state->key, state->total_len);
+}
+
+#undef _XTD_HASH_STRIPE
+#undef _XTD_HASH_BLOCK_STRIPES
+#undef _XTD_HASH_SCRAMBLE_KEY
+#undef _XTD_HASH_LAST_KEY
+#undef _XTD_HASH_MERGE_KEY
+#undef _XTD_HASH_SCRAMBLE_MUL
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_HASH_HEADER_H
@@ -0,0 +1,1063 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Image module
+// #define XTD_IMAGE_IMPLEMENTATION to include the implementation
+// Depends on xtd_thread.h for the parallel resampling and statistics, and on the xtd_common.h
+// implementation for XTD_ImageAlloc
+
+#ifndef XTD_IMAGE_HEADER_H
+#define XTD_IMAGE_HEADER_H
+
+#ifndef XTD_IMAGE_FUNC
+#define XTD_IMAGE_FUNC
+#endif
+
+#ifndef XTD_IMAGE_FUNC_DECL
+#define XTD_IMAGE_FUNC_DECL extern
+#endif
+
+#include "xtd_common.h"
+#include "xtd_colors.h"
+#include <stdbool.h>
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  Image Views
+//
+
+// An XTD_Image describes pixels somewhere in memory, it only owns them when it comes from
+// XTD_ImageAlloc. Rows are stride bytes apart and may be padded, so any rectangle of an image
+// is an image too (see XTD_ImageSubView) and can be passed around without copying.
+
+typedef enum {
+    XTD_PIXEL_RGBA8,   // ColorRGBA
+    XTD_PIXEL_BGRA8,   // ColorBGRA
+    XTD_PIXEL_RGBA32F, // V4f, channels in [0, 1]
+} XTD_PixelFormat;
+
+// Alignment of the first pixel and of the row stride of allocated images
+#define XTD_IMAGE_ALIGNMENT XTD_CACHE_LINE_SIZE
+
+typedef struct {
+    u8* pixels;
+    i32 width;
+    i32 height;
+    usize stride;
+    XTD_PixelFormat format;
+} XTD_Image;
+
+XTD_FORCE_INLINE i32 XTD_PixelSize(XTD_PixelFormat format) {
+    return format == XTD_PIXEL_RGBA32F ? 16 : 4;
+}
+
+XTD_FORCE_INLINE XTD_Image XTD_ImageWrap(void* pixels, i32 width, i32 height, usize stride, XTD_PixelFormat format) {
+    XTD_Image img;
+    img.pixels = (u8*)pixels;
+    img.width = width;
+    img.height = height;
+    img.stride = stride;
+    img.format = format;
+    return img;
+}
+
+XTD_FORCE_INLINE u8* XTD_ImageRow(const XTD_Image* img, i32 y) {
+    return img->pixels + (usize)y * img->stride;
+}
+
+XTD_FORCE_INLINE void* XTD_ImagePixel(const XTD_Image* img, i32 x, i32 y) {
+    return XTD_ImageRow(img, y) + (usize)x * (usize)XTD_PixelSize(img->format);
+}
+
+// View of a rectangle of img, clipped to its bounds (it can end up empty)
+XTD_FORCE_INLINE XTD_Image XTD_ImageSubView(const XTD_Image* img, i32 x, i32 y, i32 width, i32 height) {
+    i32 x0 = XTD_CLAMP(x, 0, img->width);
+    i32 y0 = XTD_CLAMP(y, 0, img->height);
+    i32 x1 = XTD_CLAMP(x + width, x0, img->width);
+    i32 y1 = XTD_CLAMP(y + height, y0, img->height);
+    XTD_Image view = *img;
+    view.width = x1 - x0;
+    view.height = y1 - y0;
+    if (view.width > 0 && view.height > 0)
+        view.pixels = (u8*)XTD_ImagePixel(img, x0, y0);
+    return view;
+}
+
+// Resampling filters, they are widened by the scale factor when downscaling
+typedef enum {
+    XTD_FILTER_BOX,      // Average of the covered pixels, 2x2 average at half size
+    XTD_FILTER_BILINEAR, // Tent filter
+    XTD_FILTER_LANCZOS3, // Windowed sinc with 3 lobes, sharpest but can ring on hard edges
+} XTD_ResampleFilter;
+
+typedef enum {
+    XTD_ALPHA_PREMULTIPLIED, // Colors are already multiplied by alpha
+    XTD_ALPHA_STRAIGHT,      // Colors are multiplied by alpha for filtering and divided back afterwards
+} XTD_AlphaMode;
+
+////////////////////////////////////////
+//
+//  Image Statistics
+//
+
+// Channels are in R, G, B, A order for every format. Histograms count channel values
+// quantized to 8 bits, float channels the same way XTD_ImageCopy converts them. Luminance
+// uses the Rec. 709 weights on the stored values (no linearization) and ignores alpha.
+// 8 bit statistics are computed with integers and are exact. Float sums are accumulated in
+// doubles per band and combined in a fixed order, so results don't depend on the thread count.
+
+#define XTD_HISTOGRAM_BINS 256
+
+typedef struct {
+    u64 pixel_count;
+    f32 min[4]; // In [0, 1] for 8 bit images
+    f32 max[4];
+    f64 mean[4];
+    f64 mean_luminance;
+    u32 histogram[4][XTD_HISTOGRAM_BINS];
+    u32 luminance_histogram[XTD_HISTOGRAM_BINS];
+} XTD_ImageStats;
+
+////////////////////////////////////////
+//
+//  Swizzled Image
+//
+
+// 32 bit per pixel image stored as 8x8 pixel tiles (256 bytes, 4 cache lines) in row-major
+// tile order, with the pixels of each tile in Morton order. Neighbouring pixels in both
+// directions stay close in memory, which makes column and block access much cheaper than
+// in a linear image. Width and height are padded to whole tiles.
+// Use XTD_SwizzleToLinear to get rows for XTD_WriteBMPImageToMem.
+
+#define XTD_SWIZZLE_TILE_SHIFT 3
+#define XTD_SWIZZLE_TILE_SIZE (1 << XTD_SWIZZLE_TILE_SHIFT)
+#define XTD_SWIZZLE_TILE_PIXELS (XTD_SWIZZLE_TILE_SIZE * XTD_SWIZZLE_TILE_SIZE)
+
+typedef struct {
+    u32* pixels;
+    i32 width;
+    i32 height;
+    i32 tiles_x;
+    i32 tiles_y;
+} XTD_SwizzledImage;
+
+XTD_FORCE_INLINE usize XTD_SwizzledOffset(const XTD_SwizzledImage* img, i32 x, i32 y) {
+    usize tile = (usize)(y >> XTD_SWIZZLE_TILE_SHIFT) * (usize)img->tiles_x + (usize)(x >> XTD_SWIZZLE_TILE_SHIFT);
+    u32 in_tile = XTD_MortonEncode2D((u32)x & (XTD_SWIZZLE_TILE_SIZE - 1), (u32)y & (XTD_SWIZZLE_TILE_SIZE - 1));
+    return tile * XTD_SWIZZLE_TILE_PIXELS + in_tile;
+}
+
+XTD_FORCE_INLINE u32* XTD_SwizzledPixel(const XTD_SwizzledImage* img, i32 x, i32 y) {
+    return img->pixels + XTD_SwizzledOffset(img, x, y);
+}
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+// Rows are padded to XTD_IMAGE_ALIGNMENT bytes. Pixels start zeroed.
+XTD_IMAGE_FUNC_DECL bool XTD_ImageAlloc(XTD_Image* img, i32 width, i32 height, XTD_PixelFormat format);
+// Only for images returned by XTD_ImageAlloc, not for sub views
+XTD_IMAGE_FUNC_DECL void XTD_ImageFree(XTD_Image* img);
+
+// Copies src into dst, converting between formats. Both views must have the same size.
+// Float to 8 bit conversion clamps to [0, 1] and rounds to nearest.
+XTD_IMAGE_FUNC_DECL void XTD_ImageCopy(XTD_Image* dst, const XTD_Image* src);
+// Copies src with its top left corner at (x, y) in dst, clipped to dst
+XTD_IMAGE_FUNC_DECL void XTD_ImageBlit(XTD_Image* dst, i32 x, i32 y, const XTD_Image* src);
+XTD_IMAGE_FUNC_DECL void XTD_ImageFill(XTD_Image* dst, ColorRGBA color);
+
+// Scales src to the size of dst with a separable filter. Both must be RGBA8 or BGRA8 images of
+// the same format. Rows are split across thread_count threads (0 = one per CPU).
+// Returns false when out of memory, dst may be partly written then.
+XTD_IMAGE_FUNC_DECL bool XTD_ImageResample(XTD_Image* dst, const XTD_Image* src, XTD_ResampleFilter filter, XTD_AlphaMode alpha, u32 thread_count);
+
+// Fills stats with the histograms, min, max and mean of every channel and the luminance of img.
+// Bands of rows are split across thread_count threads (0 = one per CPU).
+// Returns false when out of memory.
+XTD_IMAGE_FUNC_DECL bool XTD_ImageComputeStats(XTD_ImageStats* stats, const XTD_Image* img, u32 thread_count);
+
+// Pixels start zeroed, including the padding
+XTD_IMAGE_FUNC_DECL bool XTD_SwizzledImageInit(XTD_SwizzledImage* img, i32 width, i32 height);
+XTD_IMAGE_FUNC_DECL void XTD_SwizzledImageFree(XTD_SwizzledImage* img);
+
+// Linear images are rows of 32 bit pixels, stride is the distance between rows in bytes
+XTD_IMAGE_FUNC_DECL void XTD_SwizzleFromLinear(XTD_SwizzledImage* dst, const u32* src, usize src_stride);
+XTD_IMAGE_FUNC_DECL void XTD_SwizzleToLinear(u32* dst, usize dst_stride, const XTD_SwizzledImage* src);
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_IMAGE_IMPLEMENTATION
+
+#include "xtd_thread.h"
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if XTD_HAS_SSE2
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////
+//
+//  Image Views
+//
+
+// Frame sized images get large pages, so whole image passes don't keep missing the TLB
+XTD_IMAGE_FUNC bool XTD_ImageAlloc(XTD_Image* img, i32 width, i32 height, XTD_PixelFormat format)
+{
+    XTD_ZERO_STRUCT(img);
+    if (width <= 0 || height <= 0)
+        return false;
+
+    usize stride = XTD_ALIGNUP((usize)width * (usize)XTD_PixelSize(format), XTD_IMAGE_ALIGNMENT);
+    void* pixels = XTD_AlignedAlloc(stride * (usize)height, XTD_IMAGE_ALIGNMENT, XTD_ALLOC_ZEROED | XTD_ALLOC_LARGE_PAGES);
+    if (pixels == NULL)
+        return false;
+
+    *img = XTD_ImageWrap(pixels, width, height, stride, format);
+    return true;
+}
+
+XTD_IMAGE_FUNC void XTD_ImageFree(XTD_Image* img)
+{
+    XTD_AlignedFree(img->pixels);
+    XTD_ZERO_STRUCT(img);
+}
+
+// Rows don't need to be 4 byte aligned (BMP pixel data starts at offset 54)
+static void _xtd_SwapRedBlueRow(u8* dst, const u8* src, i32 count)
+{
+    i32 i = 0;
+#if XTD_HAS_SSE2
+    __m128i ga = _mm_set1_epi32((i32)0xFF00FF00);
+    __m128i low = _mm_set1_epi32(0xFF);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        __m128i rb = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), low), _mm_slli_epi32(_mm_and_si128(p, low), 16));
+        _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_or_si128(_mm_and_si128(p, ga), rb));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        u8 r = src[i * 4 + 0], b = src[i * 4 + 2];
+        dst[i * 4 + 0] = b;
+        dst[i * 4 + 1] = src[i * 4 + 1];
+        dst[i * 4 + 2] = r;
+        dst[i * 4 + 3] = src[i * 4 + 3];
+    }
+}
+
+// Converts count pixels, src and dst may be the same row when the formats have the same size
+static void _xtd_ConvertRow(u8* dst, XTD_PixelFormat dst_format, const u8* src, XTD_PixelFormat src_format, i32 count)
+{
+    if (dst_format == src_format)
+    {
+        memmove(dst, src, (usize)count * (usize)XTD_PixelSize(src_format));
+    } else if (dst_format != XTD_PIXEL_RGBA32F && src_format != XTD_PIXEL_RGBA32F)
+    {
+        _xtd_SwapRedBlueRow(dst, src, count);
+    } else if (dst_format == XTD_PIXEL_RGBA32F)
+    {
+        i32 r = src_format == XTD_PIXEL_BGRA8 ? 2 : 0;
+        f32* out = (f32*)dst;
+        for (i32 i = 0; i < count; i++)
+        {
+            const u8* p = src + i * 4;
+            out[i * 4 + 0] = p[r] * (1.0f / 255.0f);
+            out[i * 4 + 1] = p[1] * (1.0f / 255.0f);
+            out[i * 4 + 2] = p[2 - r] * (1.0f / 255.0f);
+            out[i * 4 + 3] = p[3] * (1.0f / 255.0f);
+        }
+    } else
+    {
+        i32 r = dst_format == XTD_PIXEL_BGRA8 ? 2 : 0;
+        const f32* in = (const f32*)src;
+        for (i32 i = 0; i < count; i++)
+        {
+            u8 c[4];
+            for (i32 k = 0; k < 4; k++)
+                c[k] = (u8)(XTD_CLAMP(in[i * 4 + k], 0.0f, 1.0f) * 255.0f + 0.5f);
+            u8* p = dst + i * 4;
+            p[r] = c[0];
+            p[1] = c[1];
+            p[2 - r] = c[2];
+            p[3] = c[3];
+        }
+    }
+}
+
+XTD_IMAGE_FUNC void XTD_ImageCopy(XTD_Image* dst, const XTD_Image* src)
+{
+    XTD_ASSERT(dst->width == src->width && dst->height == src->height);
+    if (dst->width <= 0 || dst->height <= 0)
+        return;
+
+    // Walk bottom up when copying down inside the same buffer so rows are read before being overwritten
+    bool reverse = dst->pixels > src->pixels;
+    for (i32 i = 0; i < src->height; i++)
+    {
+        i32 y = reverse ? src->height - 1 - i : i;
+        _xtd_ConvertRow(XTD_ImageRow(dst, y), dst->format, XTD_ImageRow(src, y), src->format, src->width);
+    }
+}
+
+XTD_IMAGE_FUNC void XTD_ImageBlit(XTD_Image* dst, i32 x, i32 y, const XTD_Image* src)
+{
+    XTD_Image dst_view = XTD_ImageSubView(dst, x, y, src->width, src->height);
+    XTD_Image src_view = XTD_ImageSubView(src, XTD_MAX(-x, 0), XTD_MAX(-y, 0), dst_view.width, dst_view.height);
+    XTD_ImageCopy(&dst_view, &src_view);
+}
+
+XTD_IMAGE_FUNC void XTD_ImageFill(XTD_Image* dst, ColorRGBA color)
+{
+    if (dst->width <= 0 || dst->height <= 0)
+        return;
+
+    // Fill the first row, then copy it to the rest
+    XTD_Image color_view = XTD_ImageWrap(&color, 1, 1, sizeof(color), XTD_PIXEL_RGBA8);
+    XTD_Image first = XTD_ImageSubView(dst, 0, 0, 1, 1);
+    XTD_ImageCopy(&first, &color_view);
+    usize pixel_size = (usize)XTD_PixelSize(dst->format);
+    u8* row = XTD_ImageRow(dst, 0);
+    for (i32 x = 1; x < dst->width; x++)
+        memcpy(row + (usize)x * pixel_size, row, pixel_size);
+    for (i32 y = 1; y < dst->height; y++)
+        memcpy(XTD_ImageRow(dst, y), row, (usize)dst->width * pixel_size);
+}
+
+////////////////////////////////////////
+//
+//  Resampling
+//
+
+// All the filtering is done on premultiplied 16 bit values: source pixels get 4 fraction bits,
+// the intermediate rows 6 (room for the Lanczos overshoot) and weights are Q14. The extra bits
+// keep colors of low alpha pixels accurate when unpremultiplying at the end.
+#define _XTD_RESAMPLE_WEIGHT_BITS 14
+#define _XTD_RESAMPLE_IN_BITS 4
+#define _XTD_RESAMPLE_MID_BITS 6
+#define _XTD_RESAMPLE_BAND_ROWS 32
+
+// Output pixel i reads source pixels [starts[i], starts[i] + taps) with weights[i * taps ...].
+// Taps past the image edges are folded into the edge pixel.
+typedef struct {
+    i32* starts;
+    i16* weights;
+    i32 taps;
+} _XTD_ResampleAxis;
+
+typedef struct {
+    XTD_Image* dst;
+    const XTD_Image* src;
+    _XTD_ResampleAxis h;
+    _XTD_ResampleAxis v;
+    i16* mid;
+    usize mid_stride; // In i16 units, padded to 2 pixels
+    bool straight_alpha;
+    i32 failed; // Set by any task that couldn't allocate its scratch row
+} _XTD_ResampleState;
+
+// Box is half open so ties between two pixels pick one of them
+static f64 _xtd_ResampleKernel(XTD_ResampleFilter filter, f64 x)
+{
+    switch (filter)
+    {
+        case XTD_FILTER_BOX:
+            return x >= -0.5 && x < 0.5 ? 1.0 : 0.0;
+        case XTD_FILTER_BILINEAR:
+            x = fabs(x);
+            return x < 1.0 ? 1.0 - x : 0.0;
+        default:
+        {
+            x = fabs(x);
+            if (x < 1e-8)
+                return 1.0;
+            if (x >= 3.0)
+                return 0.0;
+            f64 px = PI * x;
+            return 3.0 * sin(px) * sin(px * (1.0 / 3.0)) / (px * px);
+        }
+    }
+}
+
+static void _xtd_ResampleAxisFree(_XTD_ResampleAxis* axis)
+{
+    free(axis->starts);
+    free(axis->weights);
+    XTD_ZERO_STRUCT(axis);
+}
+
+static bool _xtd_ResampleAxisInit(_XTD_ResampleAxis* axis, XTD_ResampleFilter filter, i32 src_size, i32 dst_size)
+{
+    static const f64 supports[] = {0.5, 1.0, 3.0};
+    f64 scale = (f64)dst_size / (f64)src_size;
+    f64 filter_scale = scale < 1.0 ? 1.0 / scale : 1.0;
+    f64 radius = supports[filter] * filter_scale;
+    i32 taps = XTD_MIN((i32)ceil(radius * 2.0) + 1, src_size);
+
+    axis->taps = taps;
+    axis->starts = (i32*)malloc((usize)dst_size * sizeof(i32));
+    axis->weights = (i16*)malloc((usize)dst_size * (usize)taps * sizeof(i16));
+    f64* w = (f64*)malloc((usize)taps * sizeof(f64));
+    if (axis->starts == NULL || axis->weights == NULL || w == NULL)
+    {
+        free(w);
+        _xtd_ResampleAxisFree(axis);
+        return false;
+    }
+
+    for (i32 i = 0; i < dst_size; i++)
+    {
+        f64 center = ((f64)i + 0.5) / scale - 0.5;
+        i32 lo = (i32)ceil(center - radius);
+        i32 hi = (i32)floor(center + radius);
+        i32 start = XTD_CLAMP(lo, 0, src_size - taps);
+        memset(w, 0, (usize)taps * sizeof(f64));
+
+        f64 sum = 0.0;
+        for (i32 j = lo; j <= hi; j++)
+        {
+            f64 weight = _xtd_ResampleKernel(filter, ((f64)j - center) / filter_scale);
+            i32 k = XTD_CLAMP(j, 0, src_size - 1) - start;
+            XTD_ASSERT(k >= 0 && k < taps);
+            w[k] += weight;
+            sum += weight;
+        }
+        if (sum == 0.0)
+            sum = 1.0;
+
+        // Round every weight and give the remainder to the largest so they add up to exactly one
+        i16* q = axis->weights + (usize)i * (usize)taps;
+        i32 total = 0, largest = 0;
+        for (i32 k = 0; k < taps; k++)
+        {
+            q[k] = (i16)floor(w[k] / sum * (f64)(1 << _XTD_RESAMPLE_WEIGHT_BITS) + 0.5);
+            total += q[k];
+            if (fabs(w[k]) > fabs(w[largest]))
+                largest = k;
+        }
+        q[largest] = (i16)(q[largest] + (1 << _XTD_RESAMPLE_WEIGHT_BITS) - total);
+        axis->starts[i] = start;
+    }
+    free(w);
+    return true;
+}
+
+// Widens a source row to 16 bits with _XTD_RESAMPLE_IN_BITS fraction bits, premultiplying if needed
+static void _xtd_ResampleLoadRow(i16* out, const u8* row, i32 width, bool straight_alpha)
+{
+    i32 i = 0;
+    if (straight_alpha)
+    {
+        for (; i < width; i++)
+        {
+            const u8* p = row + i * 4;
+            u32 a = p[3];
+            out[i * 4 + 0] = (i16)((p[0] * a * (1 << _XTD_RESAMPLE_IN_BITS) + 127) / 255);
+            out[i * 4 + 1] = (i16)((p[1] * a * (1 << _XTD_RESAMPLE_IN_BITS) + 127) / 255);
+            out[i * 4 + 2] = (i16)((p[2] * a * (1 << _XTD_RESAMPLE_IN_BITS) + 127) / 255);
+            out[i * 4 + 3] = (i16)(a << _XTD_RESAMPLE_IN_BITS);
+        }
+        return;
+    }
+#if XTD_HAS_SSE2
+    for (; i + 4 <= width; i += 4)
+    {
+        __m128i px = _mm_loadu_si128((const __m128i*)(row + i * 4));
+        __m128i zero = _mm_setzero_si128();
+        _mm_storeu_si128((__m128i*)(out + i * 4), _mm_slli_epi16(_mm_unpacklo_epi8(px, zero), _XTD_RESAMPLE_IN_BITS));
+        _mm_storeu_si128((__m128i*)(out + i * 4 + 8), _mm_slli_epi16(_mm_unpackhi_epi8(px, zero), _XTD_RESAMPLE_IN_BITS));
+    }
+#endif
+    for (i *= 4; i < width * 4; i++)
+        out[i] = (i16)(row[i] << _XTD_RESAMPLE_IN_BITS);
+}
+
+// Filters one widened source row horizontally into the intermediate format
+static void _xtd_ResampleRowH(i16* out, const i16* row, const _XTD_ResampleAxis* h, i32 width)
+{
+    const i32 shift = _XTD_RESAMPLE_WEIGHT_BITS + _XTD_RESAMPLE_IN_BITS - _XTD_RESAMPLE_MID_BITS;
+    for (i32 x = 0; x < width; x++)
+    {
+        const i16* p = row + (usize)h->starts[x] * 4;
+        const i16* w = h->weights + (usize)x * (usize)h->taps;
+        i32 k = 0;
+#if XTD_HAS_SSE2
+        // madd multiplies and adds adjacent pairs, so two pixels are interleaved per channel
+        // (r0 r1 g0 g1 b0 b1 a0 a1) against (w0 w1) repeated
+        __m128i acc = _mm_set1_epi32(1 << (shift - 1));
+        for (; k + 2 <= h->taps; k += 2)
+        {
+            __m128i px = _mm_loadu_si128((const __m128i*)(p + k * 4));
+            __m128i wk = _mm_set1_epi32((i32)((u16)w[k] | ((u32)(u16)w[k + 1] << 16)));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi16(px, _mm_srli_si128(px, 8)), wk));
+        }
+        if (k < h->taps)
+        {
+            __m128i px = _mm_loadl_epi64((const __m128i*)(p + k * 4));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi16(px, _mm_setzero_si128()), _mm_set1_epi32((u16)w[k])));
+        }
+        acc = _mm_srai_epi32(acc, shift);
+        _mm_storel_epi64((__m128i*)(out + x * 4), _mm_packs_epi32(acc, acc));
+#else
+        i32 acc[4];
+        for (i32 c = 0; c < 4; c++)
+            acc[c] = 1 << (shift - 1);
+        for (; k < h->taps; k++)
+            for (i32 c = 0; c < 4; c++)
+                acc[c] += w[k] * p[k * 4 + c];
+        for (i32 c = 0; c < 4; c++)
+            out[x * 4 + c] = (i16)XTD_CLAMP(acc[c] >> shift, -32768, 32767);
+#endif
+    }
+}
+
+// Filters the intermediate rows vertically into one row, still in the intermediate format
+static void _xtd_ResampleRowV(i16* out, const _XTD_ResampleState* s, i32 y)
+{
+    const i32 shift = _XTD_RESAMPLE_WEIGHT_BITS;
+    const i16* first = s->mid + (usize)s->v.starts[y] * s->mid_stride;
+    const i16* w = s->v.weights + (usize)y * (usize)s->v.taps;
+    i32 taps = s->v.taps;
+    usize count = s->mid_stride;
+#if XTD_HAS_SSE2
+    // 2 pixels per iteration, rows are interleaved in pairs for madd like in the horizontal pass
+    __m128i zero = _mm_setzero_si128();
+    __m128i round = _mm_set1_epi32(1 << (shift - 1));
+    for (usize i = 0; i < count; i += 8)
+    {
+        __m128i lo = round, hi = round;
+        const i16* p = first + i;
+        i32 k = 0;
+        for (; k + 2 <= taps; k += 2, p += 2 * s->mid_stride)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)p);
+            __m128i b = _mm_loadu_si128((const __m128i*)(p + s->mid_stride));
+            __m128i wk = _mm_set1_epi32((i32)((u16)w[k] | ((u32)(u16)w[k + 1] << 16)));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), wk));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), wk));
+        }
+        if (k < taps)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)p);
+            __m128i wk = _mm_set1_epi32((u16)w[k]);
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), wk));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), wk));
+        }
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(_mm_srai_epi32(lo, shift), _mm_srai_epi32(hi, shift)));
+    }
+#else
+    for (usize i = 0; i < count; i++)
+    {
+        i32 acc = 1 << (shift - 1);
+        for (i32 k = 0; k < taps; k++)
+            acc += w[k] * first[(usize)k * s->mid_stride + i];
+        out[i] = (i16)XTD_CLAMP(acc >> shift, -32768, 32767);
+    }
+#endif
+}
+
+static void _xtd_ResampleTaskH(void* user, u32 task_index, u32 task_count)
+{
+    (void)task_count;
+    _XTD_ResampleState* s = (_XTD_ResampleState*)user;
+    const XTD_Image* src = s->src;
+    i32 y0 = (i32)task_index * _XTD_RESAMPLE_BAND_ROWS;
+    i32 y1 = XTD_MIN(y0 + _XTD_RESAMPLE_BAND_ROWS, src->height);
+
+    i16* row = (i16*)malloc((usize)src->width * 4 * sizeof(i16));
+    if (row == NULL)
+    {
+        XTD_ATOMIC_STORE_RELAXED(&s->failed, 1);
+        return;
+    }
+    for (i32 y = y0; y < y1; y++)
+    {
+        _xtd_ResampleLoadRow(row, XTD_ImageRow(src, y), src->width, s->straight_alpha);
+        _xtd_ResampleRowH(s->mid + (usize)y * s->mid_stride, row, &s->h, s->dst->width);
+    }
+    free(row);
+}
+
+static void _xtd_ResampleTaskV(void* user, u32 task_index, u32 task_count)
+{
+    (void)task_count;
+    _XTD_ResampleState* s = (_XTD_ResampleState*)user;
+    XTD_Image* dst = s->dst;
+    i32 y0 = (i32)task_index * _XTD_RESAMPLE_BAND_ROWS;
+    i32 y1 = XTD_MIN(y0 + _XTD_RESAMPLE_BAND_ROWS, dst->height);
+    const i32 one = 1 << _XTD_RESAMPLE_MID_BITS;
+
+    i16* row = (i16*)malloc(s->mid_stride * sizeof(i16));
+    if (row == NULL)
+    {
+        XTD_ATOMIC_STORE_RELAXED(&s->failed, 1);
+        return;
+    }
+    for (i32 y = y0; y < y1; y++)
+    {
+        _xtd_ResampleRowV(row, s, y);
+        u8* out = XTD_ImageRow(dst, y);
+        for (i32 x = 0; x < dst->width; x++)
+        {
+            const i16* p = row + x * 4;
+            // Ringing can push colors above alpha, which is invalid for premultiplied colors
+            i32 a = XTD_CLAMP(p[3], 0, 255 * one);
+            f32 unpremultiply = a > 0 ? 255.0f / (f32)a : 0.0f;
+            for (i32 c = 0; c < 3; c++)
+            {
+                i32 v = XTD_CLAMP(p[c], 0, a);
+                if (s->straight_alpha)
+                    out[x * 4 + c] = (u8)((f32)v * unpremultiply + 0.5f);
+                else
+                    out[x * 4 + c] = (u8)((v + one / 2) >> _XTD_RESAMPLE_MID_BITS);
+            }
+            out[x * 4 + 3] = (u8)((a + one / 2) >> _XTD_RESAMPLE_MID_BITS);
+        }
+    }
+    free(row);
+}
+
+XTD_IMAGE_FUNC bool XTD_ImageResample(XTD_Image* dst, const XTD_Image* src, XTD_ResampleFilter filter, XTD_AlphaMode alpha, u32 thread_count)
+{
+    XTD_ASSERT(dst->format == src->format && src->format != XTD_PIXEL_RGBA32F);
+    if (dst->width <= 0 || dst->height <= 0 || src->width <= 0 || src->height <= 0)
+        return true;
+
+    _XTD_ResampleState* s = (_XTD_ResampleState*)calloc(1, sizeof(_XTD_ResampleState));
+    if (s == NULL)
+        return false;
+    s->dst = dst;
+    s->src = src;
+    s->straight_alpha = alpha == XTD_ALPHA_STRAIGHT;
+    s->mid_stride = XTD_ALIGNUP((usize)dst->width * 4, 8);
+    s->mid = (i16*)calloc((usize)src->height * s->mid_stride, sizeof(i16));
+
+    bool ok = s->mid != NULL &&
+              _xtd_ResampleAxisInit(&s->h, filter, src->width, dst->width) &&
+              _xtd_ResampleAxisInit(&s->v, filter, src->height, dst->height);
+    if (ok)
+    {
+        XTD_ParallelFor((u32)XTD_DIVCEIL(src->height, _XTD_RESAMPLE_BAND_ROWS), thread_count, _xtd_ResampleTaskH, s);
+        ok = !XTD_ATOMIC_LOAD(&s->failed);
+    }
+    if (ok)
+    {
+        XTD_ParallelFor((u32)XTD_DIVCEIL(dst->height, _XTD_RESAMPLE_BAND_ROWS), thread_count, _xtd_ResampleTaskV, s);
+        ok = !XTD_ATOMIC_LOAD(&s->failed);
+    }
+
+    _xtd_ResampleAxisFree(&s->h);
+    _xtd_ResampleAxisFree(&s->v);
+    free(s->mid);
+    free(s);
+    return ok;
+}
+
+////////////////////////////////////////
+//
+//  Image Statistics
+//
+
+// Every band of rows fills its own partial, and partials are added up in band order.
+// Within a band, consecutive pixels count into different copies of the histograms, so a run
+// of equal values doesn't wait on the store of the previous increment to the same bin.
+// The counts of 8 bit images are enough to get their exact min, max and sums.
+
+#define _XTD_STATS_BAND_ROWS 64
+#define _XTD_STATS_CHUNK 256
+#define _XTD_STATS_COPIES 4
+#define _XTD_STATS_CHANNELS 5 // Channels in memory order, then luminance
+// Histograms 1 KiB apart alias in the store buffer when they hit the same bin, pad them
+#define _XTD_STATS_COPY_BINS (XTD_HISTOGRAM_BINS + 16)
+
+#define _XTD_LUMA_R 0.2126f
+#define _XTD_LUMA_G 0.7152f
+#define _XTD_LUMA_B 0.0722f
+// Same weights in Q15 for 8 bit pixels, they add up to exactly 1 << 15
+#define _XTD_LUMA_R_Q15 6966
+#define _XTD_LUMA_G_Q15 23436
+#define _XTD_LUMA_B_Q15 2366
+
+typedef struct {
+    u32 histogram[_XTD_STATS_CHANNELS][XTD_HISTOGRAM_BINS];
+    // Float images only
+    f64 sum[4];
+    f32 min[4];
+    f32 max[4];
+} _XTD_StatsPartial;
+
+typedef struct {
+    const XTD_Image* img;
+    _XTD_StatsPartial* partials;
+} _XTD_StatsState;
+
+// Luminance bins of count 8 bit pixels, red is at index r of every pixel
+static void _xtd_StatsLumaRow8(u8* lum, const u8* px, i32 count, i32 r)
+{
+    i32 w[4] = {0, _XTD_LUMA_G_Q15, 0, 0};
+    w[r] = _XTD_LUMA_R_Q15;
+    w[2 - r] = _XTD_LUMA_B_Q15;
+    i32 i = 0;
+#if XTD_HAS_SSE2
+    __m128i weights = _mm_setr_epi16((i16)w[0], (i16)w[1], (i16)w[2], 0, (i16)w[0], (i16)w[1], (i16)w[2], 0);
+    __m128i round = _mm_set1_epi32(1 << 14);
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4)
+    {
+        // Every pixel gives two dot products, (c0, c1) and (c2, alpha * 0)
+        __m128i p = _mm_loadu_si128((const __m128i*)(px + i * 4));
+        __m128 lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(p, zero), weights));
+        __m128 hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(p, zero), weights));
+        __m128i even = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i odd = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+        __m128i l = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(even, odd), round), 15);
+        l = _mm_packs_epi32(l, l);
+        i32 packed = _mm_cvtsi128_si32(_mm_packus_epi16(l, l));
+        memcpy(lum + i, &packed, 4);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        const u8* p = px + i * 4;
+        lum[i] = (u8)((w[0] * p[0] + w[1] * p[1] + w[2] * p[2] + (1 << 14)) >> 15);
+    }
+}
+
+// Quantizes count float pixels and their luminance to 8 bit bins, and adds them to the min,
+// max and sum of the band
+static void _xtd_StatsLoadRowF32(u8* bins, u8* lum, _XTD_StatsPartial* part, const f32* px, i32 count)
+{
+    i32 i = 0;
+#if XTD_HAS_SSE2
+    __m128 lo = _mm_loadu_ps(part->min);
+    __m128 hi = _mm_loadu_ps(part->max);
+    __m128d sum_rg = _mm_loadu_pd(part->sum);
+    __m128d sum_ba = _mm_loadu_pd(part->sum + 2);
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 scale = _mm_set1_ps(255.0f);
+    __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 p[4];
+        __m128i q[4];
+        for (i32 k = 0; k < 4; k++)
+        {
+            p[k] = _mm_loadu_ps(px + (i + k) * 4);
+            lo = _mm_min_ps(lo, p[k]);
+            hi = _mm_max_ps(hi, p[k]);
+            sum_rg = _mm_add_pd(sum_rg, _mm_cvtps_pd(p[k]));
+            sum_ba = _mm_add_pd(sum_ba, _mm_cvtps_pd(_mm_movehl_ps(p[k], p[k])));
+            q[k] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(p[k], zero), one), scale), half));
+        }
+        _mm_storeu_si128((__m128i*)(bins + i * 4), _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3])));
+
+        _MM_TRANSPOSE4_PS(p[0], p[1], p[2], p[3]);
+        __m128 l = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], _mm_set1_ps(_XTD_LUMA_R)), _mm_mul_ps(p[1], _mm_set1_ps(_XTD_LUMA_G))),
+                              _mm_mul_ps(p[2], _mm_set1_ps(_XTD_LUMA_B)));
+        __m128i ql = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(l, zero), one), scale), half));
+        ql = _mm_packs_epi32(ql, ql);
+        i32 packed = _mm_cvtsi128_si32(_mm_packus_epi16(ql, ql));
+        memcpy(lum + i, &packed, 4);
+    }
+    _mm_storeu_ps(part->min, lo);
+    _mm_storeu_ps(part->max, hi);
+    _mm_storeu_pd(part->sum, sum_rg);
+    _mm_storeu_pd(part->sum + 2, sum_ba);
+#endif
+    for (; i < count; i++)
+    {
+        const f32* p = px + i * 4;
+        for (i32 k = 0; k < 4; k++)
+        {
+            part->min[k] = XTD_MIN(part->min[k], p[k]);
+            part->max[k] = XTD_MAX(part->max[k], p[k]);
+            part->sum[k] += (f64)p[k];
+            bins[i * 4 + k] = (u8)(XTD_CLAMP(p[k], 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+        f32 l = p[0] * _XTD_LUMA_R + p[1] * _XTD_LUMA_G + p[2] * _XTD_LUMA_B;
+        lum[i] = (u8)(XTD_CLAMP(l, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+// bins has the 4 channel bins of every pixel. The histogram scatter doesn't vectorize, the
+// copies keep it at about one increment per cycle.
+static void _xtd_StatsCountChunk(u32 (*copies)[_XTD_STATS_CHANNELS][_XTD_STATS_COPY_BINS], const u8* bins, const u8* lum, i32 count)
+{
+    i32 i = 0;
+    for (; i + _XTD_STATS_COPIES <= count; i += _XTD_STATS_COPIES)
+    {
+        for (i32 k = 0; k < _XTD_STATS_COPIES; k++)
+        {
+            u32 (*h)[_XTD_STATS_COPY_BINS] = copies[k];
+            const u8* p = bins + (i + k) * 4;
+            h[0][p[0]]++;
+            h[1][p[1]]++;
+            h[2][p[2]]++;
+            h[3][p[3]]++;
+            h[4][lum[i + k]]++;
+        }
+    }
+    for (; i < count; i++)
+    {
+        const u8* p = bins + i * 4;
+        for (i32 c = 0; c < 4; c++)
+            copies[0][c][p[c]]++;
+        copies[0][4][lum[i]]++;
+    }
+}
+
+static void _xtd_StatsTask(void* user, u32 task_index, u32 task_count)
+{
+    (void)task_count;
+    _XTD_StatsState* s = (_XTD_StatsState*)user;
+    const XTD_Image* img = s->img;
+    _XTD_StatsPartial* part = &s->partials[task_index];
+    i32 y0 = (i32)task_index * _XTD_STATS_BAND_ROWS;
+    i32 y1 = XTD_MIN(y0 + _XTD_STATS_BAND_ROWS, img->height);
+    bool is_float = img->format == XTD_PIXEL_RGBA32F;
+    i32 r = img->format == XTD_PIXEL_BGRA8 ? 2 : 0;
+
+    u32 copies[_XTD_STATS_COPIES][_XTD_STATS_CHANNELS][_XTD_STATS_COPY_BINS];
+    u8 bins[_XTD_STATS_CHUNK * 4];
+    u8 lum[_XTD_STATS_CHUNK];
+    memset(copies, 0, sizeof(copies));
+    for (i32 c = 0; c < 4; c++)
+    {
+        part->sum[c] = 0.0;
+        part->min[c] = FLT_MAX;
+        part->max[c] = -FLT_MAX;
+    }
+
+    for (i32 y = y0; y < y1; y++)
+    {
+        const u8* row = XTD_ImageRow(img, y);
+        for (i32 x = 0; x < img->width; x += _XTD_STATS_CHUNK)
+        {
+            i32 count = XTD_MIN(_XTD_STATS_CHUNK, img->width - x);
+            if (is_float)
+            {
+                _xtd_StatsLoadRowF32(bins, lum, part, (const f32*)row + (usize)x * 4, count);
+                _xtd_StatsCountChunk(copies, bins, lum, count);
+            } else
+            {
+                const u8* px = row + (usize)x * 4;
+                _xtd_StatsLumaRow8(lum, px, count, r);
+                _xtd_StatsCountChunk(copies, px, lum, count);
+            }
+        }
+    }
+
+    for (i32 c = 0; c < _XTD_STATS_CHANNELS; c++)
+    {
+        for (i32 b = 0; b < XTD_HISTOGRAM_BINS; b++)
+        {
+            u32 n = 0;
+            for (i32 k = 0; k < _XTD_STATS_COPIES; k++)
+                n += copies[k][c][b];
+            part->histogram[c][b] = n;
+        }
+    }
+}
+
+XTD_IMAGE_FUNC bool XTD_ImageComputeStats(XTD_ImageStats* stats, const XTD_Image* img, u32 thread_count)
+{
+    XTD_ZERO_STRUCT(stats);
+    if (img->width <= 0 || img->height <= 0)
+        return true;
+
+    u32 band_count = (u32)XTD_DIVCEIL(img->height, _XTD_STATS_BAND_ROWS);
+    _XTD_StatsState s;
+    s.img = img;
+    s.partials = (_XTD_StatsPartial*)malloc(band_count * sizeof(_XTD_StatsPartial));
+    if (s.partials == NULL)
+        return false;
+    XTD_ParallelFor(band_count, thread_count, _xtd_StatsTask, &s);
+
+    // Channels stay in memory order until the end
+    f64 sum[4] = {0.0, 0.0, 0.0, 0.0};
+    for (i32 c = 0; c < 4; c++)
+    {
+        stats->min[c] = FLT_MAX;
+        stats->max[c] = -FLT_MAX;
+    }
+    for (u32 i = 0; i < band_count; i++)
+    {
+        const _XTD_StatsPartial* part = &s.partials[i];
+        for (i32 b = 0; b < XTD_HISTOGRAM_BINS; b++)
+        {
+            for (i32 c = 0; c < 4; c++)
+                stats->histogram[c][b] += part->histogram[c][b];
+            stats->luminance_histogram[b] += part->histogram[4][b];
+        }
+        for (i32 c = 0; c < 4; c++)
+        {
+            sum[c] += part->sum[c];
+            stats->min[c] = XTD_MIN(stats->min[c], part->min[c]);
+            stats->max[c] = XTD_MAX(stats->max[c], part->max[c]);
+        }
+    }
+    free(s.partials);
+
+    stats->pixel_count = (u64)img->width * (u64)img->height;
+    for (i32 c = 0; c < 4; c++)
+    {
+        if (img->format == XTD_PIXEL_RGBA32F)
+        {
+            stats->mean[c] = sum[c] / (f64)stats->pixel_count;
+            continue;
+        }
+        u64 total = 0;
+        i32 lo = -1, hi = 0;
+        for (i32 b = 0; b < XTD_HISTOGRAM_BINS; b++)
+        {
+            if (stats->histogram[c][b] == 0)
+                continue;
+            total += (u64)b * stats->histogram[c][b];
+            if (lo < 0)
+                lo = b;
+            hi = b;
+        }
+        stats->min[c] = (f32)lo / 255.0f;
+        stats->max[c] = (f32)hi / 255.0f;
+        stats->mean[c] = (f64)total / (255.0 * (f64)stats->pixel_count);
+    }
+
+    if (img->format == XTD_PIXEL_BGRA8)
+    {
+        u32 blue[XTD_HISTOGRAM_BINS];
+        memcpy(blue, stats->histogram[0], sizeof(blue));
+        memcpy(stats->histogram[0], stats->histogram[2], sizeof(blue));
+        memcpy(stats->histogram[2], blue, sizeof(blue));
+        f32 t = stats->min[0];
+        stats->min[0] = stats->min[2];
+        stats->min[2] = t;
+        t = stats->max[0];
+        stats->max[0] = stats->max[2];
+        stats->max[2] = t;
+        f64 m = stats->mean[0];
+        stats->mean[0] = stats->mean[2];
+        stats->mean[2] = m;
+    }
+    stats->mean_luminance = _XTD_LUMA_R * stats->mean[0] + _XTD_LUMA_G * stats->mean[1] + _XTD_LUMA_B * stats->mean[2];
+    return true;
+}
+
+////////////////////////////////////////
+//
+//  Swizzled Image
+//
+
+// Morton offset of every (x, y) in a tile, indexed by y * XTD_SWIZZLE_TILE_SIZE + x
+static const u8 _xtd_swizzle_table[XTD_SWIZZLE_TILE_PIXELS] = {
+     0,  1,  4,  5, 16, 17, 20, 21,
+     2,  3,  6,  7, 18, 19, 22, 23,
+     8,  9, 12, 13, 24, 25, 28, 29,
+    10, 11, 14, 15, 26, 27, 30, 31,
+    32, 33, 36, 37, 48, 49, 52, 53,
+    34, 35, 38, 39, 50, 51, 54, 55,
+    40, 41, 44, 45, 56, 57, 60, 61,
+    42, 43, 46, 47, 58, 59, 62, 63,
+};
+
+XTD_IMAGE_FUNC bool XTD_SwizzledImageInit(XTD_SwizzledImage* img, i32 width, i32 height)
+{
+    XTD_ZERO_STRUCT(img);
+    if (width <= 0 || height <= 0)
+        return false;
+
+    i32 tiles_x = (width + XTD_SWIZZLE_TILE_SIZE - 1) >> XTD_SWIZZLE_TILE_SHIFT;
+    i32 tiles_y = (height + XTD_SWIZZLE_TILE_SIZE - 1) >> XTD_SWIZZLE_TILE_SHIFT;
+    u32* pixels = (u32*)calloc((usize)tiles_x * (usize)tiles_y * XTD_SWIZZLE_TILE_PIXELS, sizeof(u32));
+    if (pixels == NULL)
+        return false;
+
+    img->pixels = pixels;
+    img->width = width;
+    img->height = height;
+    img->tiles_x = tiles_x;
+    img->tiles_y = tiles_y;
+    return true;
+}
+
+XTD_IMAGE_FUNC void XTD_SwizzledImageFree(XTD_SwizzledImage* img)
+{
+    free(img->pixels);
+    XTD_ZERO_STRUCT(img);
+}
+
+// Both directions walk tile by tile so each tile is written (or read) in one go
+XTD_IMAGE_FUNC void XTD_SwizzleFromLinear(XTD_SwizzledImage* dst, const u32* src, usize src_stride)
+{
+    const u8* table = _xtd_swizzle_table;
+    for (i32 ty = 0; ty < dst->tiles_y; ty++)
+    {
+        i32 y0 = ty * XTD_SWIZZLE_TILE_SIZE;
+        i32 rows = XTD_MIN(XTD_SWIZZLE_TILE_SIZE, dst->height - y0);
+        for (i32 tx = 0; tx < dst->tiles_x; tx++)
+        {
+            i32 x0 = tx * XTD_SWIZZLE_TILE_SIZE;
+            i32 cols = XTD_MIN(XTD_SWIZZLE_TILE_SIZE, dst->width - x0);
+            u32* tile = dst->pixels + ((usize)ty * (usize)dst->tiles_x + (usize)tx) * XTD_SWIZZLE_TILE_PIXELS;
+            for (i32 y = 0; y < rows; y++)
+            {
+                const u32* row = (const u32*)((const u8*)src + (usize)(y0 + y) * src_stride) + x0;
+                const u8* offsets = table + y * XTD_SWIZZLE_TILE_SIZE;
+                for (i32 x = 0; x < cols; x++)
+                    tile[offsets[x]] = row[x];
+            }
+        }
+    }
+}
+
+XTD_IMAGE_FUNC void XTD_SwizzleToLinear(u32* dst, usize dst_stride, const XTD_SwizzledImage* src)
+{
+    const u8* table = _xtd_swizzle_table;
+    for (i32 ty = 0; ty < src->tiles_y; ty++)
+    {
+        i32 y0 = ty * XTD_SWIZZLE_TILE_SIZE;
+        i32 rows = XTD_MIN(XTD_SWIZZLE_TILE_SIZE, src->height - y0);
+        for (i32 tx = 0; tx < src->tiles_x; tx++)
+        {
+            i32 x0 = tx * XTD_SWIZZLE_TILE_SIZE;
+            i32 cols = XTD_MIN(XTD_SWIZZLE_TILE_SIZE, src->width - x0);
+            const u32* tile = src->pixels + ((usize)ty * (usize)src->tiles_x + (usize)tx) * XTD_SWIZZLE_TILE_PIXELS;
+            for (i32 y = 0; y < rows; y++)
+            {
+                u32* row = (u32*)((u8*)dst + (usize)(y0 + y) * dst_stride) + x0;
+                const u8* offsets = table + y * XTD_SWIZZLE_TILE_SIZE;
+                for (i32 x = 0; x < cols; x++)
+                    row[x] = tile[offsets[x]];
+            }
+        }
+    }
+}
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_IMAGE_HEADER_H
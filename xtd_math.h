@@ -26,6 +26,10 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#if XTD_HAS_SSE2 || XTD_HAS_CPU_DISPATCH
+#include <immintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -49,6 +53,544 @@ XTD_MATH_FORCE_INLINE f32 lerpF32(f32 a, f32 b, f32 t) {
     return a + (b - a) * t;
 }
 
+////////////////////////////////////////
+//
+//  Fixed point
+//
+
+// Q16.16 signed fixed point for deterministic math without floats.
+// Addition, subtraction and negation wrap on overflow (computed as unsigned),
+// multiplication rounds to nearest and wraps the same way,
+// division truncates and saturates on overflow or division by zero.
+// Conversions from f32 are only meant for loading constants and assets.
+
+typedef i32 Q16;
+
+#define Q16_SHIFT 16
+#define Q16_ONE (1 << Q16_SHIFT)
+#define Q16_HALF (1 << (Q16_SHIFT - 1))
+#define Q16_MAX I32_MAX
+#define Q16_MIN I32_MIN
+
+XTD_MATH_FORCE_INLINE Q16 fromIntQ16(i32 x) {
+    return (Q16)((u32)x << Q16_SHIFT);
+}
+
+// Rounds towards negative infinity
+XTD_MATH_FORCE_INLINE i32 toIntQ16(Q16 x) {
+    return x >> Q16_SHIFT;
+}
+
+// Rounds half away from zero, floatToFixed4q does the same
+XTD_MATH_FORCE_INLINE Q16 fromF32Q16(f32 x) {
+    return (Q16)(x * (f32)Q16_ONE + (x >= 0.0f ? 0.5f : -0.5f));
+}
+
+XTD_MATH_FORCE_INLINE f32 toF32Q16(Q16 x) {
+    return (f32)x * (1.0f / Q16_ONE);
+}
+
+XTD_MATH_FORCE_INLINE Q16 mulQ16(Q16 a, Q16 b) {
+    return (Q16)(u32)(((i64)a * b + Q16_HALF) >> Q16_SHIFT);
+}
+
+XTD_MATH_FORCE_INLINE Q16 divQ16(Q16 a, Q16 b) {
+    if (b == 0)
+        return a >= 0 ? Q16_MAX : Q16_MIN;
+    i64 res = ((i64)a * Q16_ONE) / b;
+    return (Q16)XTD_CLAMP(res, (i64)Q16_MIN, (i64)Q16_MAX);
+}
+
+// Bitwise integer square root, truncated
+XTD_MATH_FORCE_INLINE u64 _xtd_IsqrtU64(u64 x) {
+    u64 res = 0;
+    u64 bit = (u64)1 << 62;
+    while (bit > x)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (x >= res + bit)
+        {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        } else
+        {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+// Truncated square root, negative inputs return 0
+XTD_MATH_FORCE_INLINE Q16 sqrtQ16(Q16 a) {
+    if (a <= 0)
+        return 0;
+    return (Q16)_xtd_IsqrtU64((u64)a << Q16_SHIFT);
+}
+
+// Length of a vector of count components. The root of the sum of the raw squares is already
+// Q16.16, the sum is kept at full precision and capped at 2^62 (past Q16_MAX squared) so it
+// can't overflow and long vectors saturate.
+XTD_MATH_FORCE_INLINE Q16 _xtd_LengthQ16(const Q16* e, int count) {
+    u64 sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        u64 m = (u64)XTD_ABS((i64)e[i]);
+        sum = XTD_MIN(sum + m * m, (u64)1 << 62);
+    }
+    return (Q16)XTD_MIN(_xtd_IsqrtU64(sum), (u64)Q16_MAX);
+}
+
+////////////////////////////////////////
+//
+//  Approximate functions
+//
+
+// Faster replacements for libm when a small error is acceptable.
+// Max errors are measured against double precision libm over the given input range.
+// NaN, infinities and denormals are not handled.
+
+XTD_MATH_FORCE_INLINE u32 _xtd_BitsF32(f32 x) {
+    union {
+        u32 u;
+        f32 f;
+    } r;
+    r.f = x;
+    return r.u;
+}
+
+XTD_MATH_FORCE_INLINE f32 _xtd_F32FromBits(u32 x) {
+    union {
+        u32 u;
+        f32 f;
+    } r;
+    r.u = x;
+    return r.f;
+}
+
+// 1 / sqrt(x) for x > 0
+// Max relative error 3e-7 with SSE (rsqrtss + one Newton step), 5e-6 without (two Newton steps)
+XTD_MATH_FORCE_INLINE f32 rsqrtApproxF32(f32 x) {
+#if XTD_HAS_SSE2
+    f32 y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#else
+    f32 y = _xtd_F32FromBits(0x5f375a86 - (_xtd_BitsF32(x) >> 1));
+    y = y * (1.5f - 0.5f * x * y * y);
+#endif
+    return y * (1.5f - 0.5f * x * y * y);
+}
+
+// Polynomial coefficients shared by the scalar and SIMD versions
+#define _XTD_SIN_C3 -1.6666654611e-1f
+#define _XTD_SIN_C5 8.3321608736e-3f
+#define _XTD_SIN_C7 -1.9515295891e-4f
+#define _XTD_COS_C4 4.166664568298827e-2f
+#define _XTD_COS_C6 -1.388731625493765e-3f
+#define _XTD_COS_C8 2.443315711809948e-5f
+// pi/2 split in three parts so q * part is exact for |q| < 2^16
+#define _XTD_HALF_PI_A 1.5703125f
+#define _XTD_HALF_PI_B 4.837512969970703125e-4f
+#define _XTD_HALF_PI_C 7.54978995489188216e-8f
+
+#define _XTD_EXP2_C0 1.00000008f
+#define _XTD_EXP2_C1 0.693147188f
+#define _XTD_EXP2_C2 0.240221075f
+#define _XTD_EXP2_C3 0.0555035711f
+#define _XTD_EXP2_C4 0.00967603192f
+#define _XTD_EXP2_C5 0.00133908634f
+
+#define _XTD_ATAN_C0 0.999999226f
+#define _XTD_ATAN_C1 -0.33325678f
+#define _XTD_ATAN_C2 0.198720403f
+#define _XTD_ATAN_C3 -0.134478641f
+#define _XTD_ATAN_C4 0.083126453f
+#define _XTD_ATAN_C5 -0.0363604309f
+#define _XTD_ATAN_C6 0.00764835393f
+
+// sin(x) and cos(x), max absolute error 1e-7 for |x| < 8192 and 1e-6 for |x| < 65536
+XTD_MATH_FORCE_INLINE void sincosApproxF32(f32 x, f32* out_sin, f32* out_cos) {
+    // x = r + q * pi/2 with r in [-pi/4, pi/4]
+    f32 qf = x * 0.636619772f;
+#if XTD_HAS_SSE2
+    i32 q = _mm_cvtss_si32(_mm_set_ss(qf));
+#else
+    i32 q = (i32)(qf + (qf >= 0.0f ? 0.5f : -0.5f));
+#endif
+    f32 r = x - (f32)q * _XTD_HALF_PI_A;
+    r = r - (f32)q * _XTD_HALF_PI_B;
+    r = r - (f32)q * _XTD_HALF_PI_C;
+
+    f32 r2 = r * r;
+    f32 s = r + r * r2 * (_XTD_SIN_C3 + r2 * (_XTD_SIN_C5 + r2 * _XTD_SIN_C7));
+    f32 c = 1.0f - 0.5f * r2 + r2 * r2 * (_XTD_COS_C4 + r2 * (_XTD_COS_C6 + r2 * _XTD_COS_C8));
+
+    // Quadrant q: sin = {s, c, -s, -c}, cos = {c, -s, -c, s}
+    f32 sin_x = (q & 1) ? c : s;
+    f32 cos_x = (q & 1) ? s : c;
+    *out_sin = (q & 2) ? -sin_x : sin_x;
+    *out_cos = ((q + 1) & 2) ? -cos_x : cos_x;
+}
+
+XTD_MATH_FORCE_INLINE f32 sinApproxF32(f32 x) {
+    f32 s, c;
+    sincosApproxF32(x, &s, &c);
+    return s;
+}
+
+XTD_MATH_FORCE_INLINE f32 cosApproxF32(f32 x) {
+    f32 s, c;
+    sincosApproxF32(x, &s, &c);
+    return c;
+}
+
+// 2^x, max relative error 2.5e-7, x is clamped to [-126, 127]
+XTD_MATH_FORCE_INLINE f32 exp2ApproxF32(f32 x) {
+    x = x < -126.0f ? -126.0f : x;
+    x = x > 127.0f ? 127.0f : x;
+#if XTD_HAS_SSE2
+    i32 i = _mm_cvtss_si32(_mm_set_ss(x));
+#else
+    i32 i = (i32)(x + (x >= 0.0f ? 0.5f : -0.5f));
+#endif
+    f32 f = x - (f32)i;
+    f32 p = _XTD_EXP2_C0 + f * (_XTD_EXP2_C1 + f * (_XTD_EXP2_C2 + f * (_XTD_EXP2_C3 + f * (_XTD_EXP2_C4 + f * _XTD_EXP2_C5))));
+    return p * _xtd_F32FromBits((u32)(i + 127) << 23);
+}
+
+// log2(x) for normal x > 0, max absolute error 1.6e-7 in [0.5, 2] and 2 ulp elsewhere
+XTD_MATH_FORCE_INLINE f32 log2ApproxF32(f32 x) {
+    // x = m * 2^e with m in [sqrt(0.5), sqrt(2))
+    u32 bits = _xtd_BitsF32(x) - 0x3f3504f3;
+    f32 e = (f32)((i32)bits >> 23);
+    f32 m = _xtd_F32FromBits((bits & 0x007fffff) + 0x3f3504f3);
+    // log2(m) = 2/ln(2) * atanh(t), t = (m - 1) / (m + 1) in [-0.172, 0.172]
+    f32 t = (m - 1.0f) / (m + 1.0f);
+    f32 t2 = t * t;
+    f32 p = t * (2.88539008f + t2 * (0.961796694f + t2 * (0.577078016f + t2 * 0.412198583f)));
+    return e + p;
+}
+
+// e^x, max relative error 7e-7 for |x| < 10 and 4e-6 up to the float limits
+XTD_MATH_FORCE_INLINE f32 expApproxF32(f32 x) {
+    return exp2ApproxF32(x * 1.44269504f);
+}
+
+// ln(x) for normal x > 0, max absolute error 1.2e-7 in [0.5, 2] and 7e-6 elsewhere
+XTD_MATH_FORCE_INLINE f32 logApproxF32(f32 x) {
+    return log2ApproxF32(x) * 0.693147181f;
+}
+
+// x^y for normal x > 0, relative error about 2.5e-7 + |y * log2(x)| * 1e-7
+XTD_MATH_FORCE_INLINE f32 powApproxF32(f32 x, f32 y) {
+    return exp2ApproxF32(y * log2ApproxF32(x));
+}
+
+// atan2(y, x) in [-pi, pi], max absolute error 7.5e-7, atan2(0, 0) = 0
+XTD_MATH_FORCE_INLINE f32 atan2ApproxF32(f32 y, f32 x) {
+    f32 ax = absF32(x);
+    f32 ay = absF32(y);
+    f32 mx = ax > ay ? ax : ay;
+    f32 mn = ax > ay ? ay : ax;
+    f32 z = mx > 0.0f ? mn / mx : 0.0f;
+    f32 z2 = z * z;
+    f32 r = z * (_XTD_ATAN_C0 + z2 * (_XTD_ATAN_C1 + z2 * (_XTD_ATAN_C2 + z2 * (_XTD_ATAN_C3 +
+        z2 * (_XTD_ATAN_C4 + z2 * (_XTD_ATAN_C5 + z2 * _XTD_ATAN_C6))))));
+    r = ay > ax ? 1.57079633f - r : r;
+    r = x < 0.0f ? 3.14159265f - r : r;
+    return _xtd_F32FromBits(_xtd_BitsF32(r) | (_xtd_BitsF32(y) & 0x80000000));
+}
+
+////////////////////////////////////////
+//
+//  Half precision
+//
+
+// IEEE 754 binary16 storage type, convert to f32 to do math with it.
+// Conversions round to nearest even and keep denormals, infinities and NaNs.
+// Uses F16C when enabled at compile time (-mf16c or /arch:AVX2).
+
+typedef u16 f16;
+
+XTD_MATH_FORCE_INLINE f16 _xtd_F32ToF16Soft(f32 x) {
+    u32 bits = _xtd_BitsF32(x);
+    u32 sign = (bits >> 16) & 0x8000;
+    u32 a = bits & 0x7fffffff;
+    if (a >= 0x7f800000) // Infinity or NaN, NaNs stay quiet NaNs
+        return (f16)(sign | 0x7c00 | (a > 0x7f800000 ? 0x200 | ((a >> 13) & 0x3ff) : 0));
+    if (a >= 0x477ff000) // Rounds above the largest half (65504)
+        return (f16)(sign | 0x7c00);
+    if (a < 0x38800000)
+    {
+        // Result is a denormal, adding 0.5 lets the FPU do the rounding shift
+        f32 d = _xtd_F32FromBits(a) + 0.5f;
+        return (f16)(sign | (_xtd_BitsF32(d) - 0x3f000000));
+    }
+    // Rebias the exponent and round the 13 dropped bits to nearest even
+    a += ((u32)(15 - 127) << 23) + 0xfff + ((a >> 13) & 1);
+    return (f16)(sign | (a >> 13));
+}
+
+XTD_MATH_FORCE_INLINE f32 _xtd_F16ToF32Soft(f16 h) {
+    u32 bits = ((u32)h & 0x7fff) << 13;
+    u32 exp = bits & (0x7c00 << 13);
+    bits += (u32)(127 - 15) << 23;
+    if (exp == (0x7c00 << 13))
+    {
+        // Infinity or NaN, NaNs come out quiet like with F16C
+        bits += (u32)(128 - 16) << 23;
+        if (h & 0x3ff)
+            bits |= 0x00400000;
+    } else if (exp == 0)
+    {
+        // Denormal, normalize through a float subtraction
+        bits += 1 << 23;
+        bits = _xtd_BitsF32(_xtd_F32FromBits(bits) - _xtd_F32FromBits(113 << 23));
+    }
+    return _xtd_F32FromBits(bits | (((u32)h & 0x8000) << 16));
+}
+
+XTD_MATH_FORCE_INLINE f16 fromF32F16(f32 x) {
+#if XTD_HAS_F16C
+    return (f16)_mm_extract_epi16(_mm_cvtps_ph(_mm_set_ss(x), _MM_FROUND_TO_NEAREST_INT), 0);
+#else
+    return _xtd_F32ToF16Soft(x);
+#endif
+}
+
+XTD_MATH_FORCE_INLINE f32 toF32F16(f16 x) {
+#if XTD_HAS_F16C
+    return _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(x)));
+#else
+    return _xtd_F16ToF32Soft(x);
+#endif
+}
+
+////////////////////////////////////////
+//
+//  SIMD approximate functions
+//
+
+// 4 and 8 wide versions of the approximate functions, same algorithms and error bounds.
+// F32x4 needs SSE2. F32x8 needs AVX2, either for the whole build or inside XTD_TARGET_AVX2
+// functions picked at runtime (see XTD_GetCPUTier).
+
+#if XTD_HAS_SSE2
+
+typedef __m128 F32x4;
+
+XTD_MATH_FORCE_INLINE F32x4 _xtd_Select4(F32x4 mask, F32x4 a, F32x4 b) {
+#if XTD_HAS_SSE41
+    return _mm_blendv_ps(b, a, mask);
+#else
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#endif
+}
+
+XTD_MATH_FORCE_INLINE F32x4 rsqrtApproxF32x4(F32x4 x) {
+    F32x4 y = _mm_rsqrt_ps(x);
+    F32x4 half_xyy = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), x), _mm_mul_ps(y, y));
+    return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), half_xyy));
+}
+
+XTD_MATH_FORCE_INLINE void sincosApproxF32x4(F32x4 x, F32x4* out_sin, F32x4* out_cos) {
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.636619772f)));
+    F32x4 qf = _mm_cvtepi32_ps(q);
+    F32x4 r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(_XTD_HALF_PI_A)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(_XTD_HALF_PI_B)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(_XTD_HALF_PI_C)));
+
+    F32x4 r2 = _mm_mul_ps(r, r);
+    F32x4 s = _mm_add_ps(_mm_set1_ps(_XTD_SIN_C5), _mm_mul_ps(r2, _mm_set1_ps(_XTD_SIN_C7)));
+    s = _mm_add_ps(_mm_set1_ps(_XTD_SIN_C3), _mm_mul_ps(r2, s));
+    s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), s));
+    F32x4 c = _mm_add_ps(_mm_set1_ps(_XTD_COS_C6), _mm_mul_ps(r2, _mm_set1_ps(_XTD_COS_C8)));
+    c = _mm_add_ps(_mm_set1_ps(_XTD_COS_C4), _mm_mul_ps(r2, c));
+    c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), c));
+
+    __m128i one = _mm_set1_epi32(1);
+    __m128i two = _mm_set1_epi32(2);
+    F32x4 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    F32x4 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    F32x4 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+    *out_sin = _mm_xor_ps(_xtd_Select4(swap, c, s), sin_sign);
+    *out_cos = _mm_xor_ps(_xtd_Select4(swap, s, c), cos_sign);
+}
+
+XTD_MATH_FORCE_INLINE F32x4 sinApproxF32x4(F32x4 x) {
+    F32x4 s, c;
+    sincosApproxF32x4(x, &s, &c);
+    return s;
+}
+
+XTD_MATH_FORCE_INLINE F32x4 cosApproxF32x4(F32x4 x) {
+    F32x4 s, c;
+    sincosApproxF32x4(x, &s, &c);
+    return c;
+}
+
+XTD_MATH_FORCE_INLINE F32x4 exp2ApproxF32x4(F32x4 x) {
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(127.0f));
+    __m128i i = _mm_cvtps_epi32(x);
+    F32x4 f = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+    F32x4 p = _mm_add_ps(_mm_set1_ps(_XTD_EXP2_C4), _mm_mul_ps(f, _mm_set1_ps(_XTD_EXP2_C5)));
+    p = _mm_add_ps(_mm_set1_ps(_XTD_EXP2_C3), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(_XTD_EXP2_C2), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(_XTD_EXP2_C1), _mm_mul_ps(f, p));
+    p = _mm_add_ps(_mm_set1_ps(_XTD_EXP2_C0), _mm_mul_ps(f, p));
+    F32x4 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(i, _mm_set1_epi32(127)), 23));
+    return _mm_mul_ps(p, scale);
+}
+
+XTD_MATH_FORCE_INLINE F32x4 log2ApproxF32x4(F32x4 x) {
+    __m128i bits = _mm_sub_epi32(_mm_castps_si128(x), _mm_set1_epi32(0x3f3504f3));
+    F32x4 e = _mm_cvtepi32_ps(_mm_srai_epi32(bits, 23));
+    F32x4 m = _mm_castsi128_ps(_mm_add_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f3504f3)));
+    F32x4 t = _mm_div_ps(_mm_sub_ps(m, _mm_set1_ps(1.0f)), _mm_add_ps(m, _mm_set1_ps(1.0f)));
+    F32x4 t2 = _mm_mul_ps(t, t);
+    F32x4 p = _mm_add_ps(_mm_set1_ps(0.577078016f), _mm_mul_ps(t2, _mm_set1_ps(0.412198583f)));
+    p = _mm_add_ps(_mm_set1_ps(0.961796694f), _mm_mul_ps(t2, p));
+    p = _mm_add_ps(_mm_set1_ps(2.88539008f), _mm_mul_ps(t2, p));
+    return _mm_add_ps(e, _mm_mul_ps(t, p));
+}
+
+XTD_MATH_FORCE_INLINE F32x4 expApproxF32x4(F32x4 x) {
+    return exp2ApproxF32x4(_mm_mul_ps(x, _mm_set1_ps(1.44269504f)));
+}
+
+XTD_MATH_FORCE_INLINE F32x4 logApproxF32x4(F32x4 x) {
+    return _mm_mul_ps(log2ApproxF32x4(x), _mm_set1_ps(0.693147181f));
+}
+
+XTD_MATH_FORCE_INLINE F32x4 powApproxF32x4(F32x4 x, F32x4 y) {
+    return exp2ApproxF32x4(_mm_mul_ps(y, log2ApproxF32x4(x)));
+}
+
+XTD_MATH_FORCE_INLINE F32x4 atan2ApproxF32x4(F32x4 y, F32x4 x) {
+    F32x4 sign_mask = _mm_set1_ps(-0.0f);
+    F32x4 ax = _mm_andnot_ps(sign_mask, x);
+    F32x4 ay = _mm_andnot_ps(sign_mask, y);
+    F32x4 mx = _mm_max_ps(ax, ay);
+    F32x4 mn = _mm_min_ps(ax, ay);
+    F32x4 z = _mm_and_ps(_mm_cmpgt_ps(mx, _mm_setzero_ps()), _mm_div_ps(mn, mx));
+    F32x4 z2 = _mm_mul_ps(z, z);
+    F32x4 r = _mm_add_ps(_mm_set1_ps(_XTD_ATAN_C5), _mm_mul_ps(z2, _mm_set1_ps(_XTD_ATAN_C6)));
+    r = _mm_add_ps(_mm_set1_ps(_XTD_ATAN_C4), _mm_mul_ps(z2, r));
+    r = _mm_add_ps(_mm_set1_ps(_XTD_ATAN_C3), _mm_mul_ps(z2, r));
+    r = _mm_add_ps(_mm_set1_ps(_XTD_ATAN_C2), _mm_mul_ps(z2, r));
+    r = _mm_add_ps(_mm_set1_ps(_XTD_ATAN_C1), _mm_mul_ps(z2, r));
+    r = _mm_mul_ps(z, _mm_add_ps(_mm_set1_ps(_XTD_ATAN_C0), _mm_mul_ps(z2, r)));
+    r = _xtd_Select4(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(1.57079633f), r), r);
+    r = _xtd_Select4(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(3.14159265f), r), r);
+    return _mm_or_ps(r, _mm_and_ps(y, sign_mask));
+}
+
+#endif // XTD_HAS_SSE2
+
+#if XTD_HAS_AVX2 || XTD_HAS_CPU_DISPATCH
+
+typedef __m256 F32x8;
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 rsqrtApproxF32x8(F32x8 x) {
+    F32x8 y = _mm256_rsqrt_ps(x);
+    F32x8 half_xyy = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), x), _mm256_mul_ps(y, y));
+    return _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.5f), half_xyy));
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE void sincosApproxF32x8(F32x8 x, F32x8* out_sin, F32x8* out_cos) {
+    __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(0.636619772f)));
+    F32x8 qf = _mm256_cvtepi32_ps(q);
+    F32x8 r = _mm256_sub_ps(x, _mm256_mul_ps(qf, _mm256_set1_ps(_XTD_HALF_PI_A)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(qf, _mm256_set1_ps(_XTD_HALF_PI_B)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(qf, _mm256_set1_ps(_XTD_HALF_PI_C)));
+
+    F32x8 r2 = _mm256_mul_ps(r, r);
+    F32x8 s = _mm256_add_ps(_mm256_set1_ps(_XTD_SIN_C5), _mm256_mul_ps(r2, _mm256_set1_ps(_XTD_SIN_C7)));
+    s = _mm256_add_ps(_mm256_set1_ps(_XTD_SIN_C3), _mm256_mul_ps(r2, s));
+    s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), s));
+    F32x8 c = _mm256_add_ps(_mm256_set1_ps(_XTD_COS_C6), _mm256_mul_ps(r2, _mm256_set1_ps(_XTD_COS_C8)));
+    c = _mm256_add_ps(_mm256_set1_ps(_XTD_COS_C4), _mm256_mul_ps(r2, c));
+    c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)), _mm256_mul_ps(_mm256_mul_ps(r2, r2), c));
+
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i two = _mm256_set1_epi32(2);
+    F32x8 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    F32x8 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+    F32x8 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+    *out_sin = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sin_sign);
+    *out_cos = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cos_sign);
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 sinApproxF32x8(F32x8 x) {
+    F32x8 s, c;
+    sincosApproxF32x8(x, &s, &c);
+    return s;
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 cosApproxF32x8(F32x8 x) {
+    F32x8 s, c;
+    sincosApproxF32x8(x, &s, &c);
+    return c;
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 exp2ApproxF32x8(F32x8 x) {
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-126.0f)), _mm256_set1_ps(127.0f));
+    __m256i i = _mm256_cvtps_epi32(x);
+    F32x8 f = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+    F32x8 p = _mm256_add_ps(_mm256_set1_ps(_XTD_EXP2_C4), _mm256_mul_ps(f, _mm256_set1_ps(_XTD_EXP2_C5)));
+    p = _mm256_add_ps(_mm256_set1_ps(_XTD_EXP2_C3), _mm256_mul_ps(f, p));
+    p = _mm256_add_ps(_mm256_set1_ps(_XTD_EXP2_C2), _mm256_mul_ps(f, p));
+    p = _mm256_add_ps(_mm256_set1_ps(_XTD_EXP2_C1), _mm256_mul_ps(f, p));
+    p = _mm256_add_ps(_mm256_set1_ps(_XTD_EXP2_C0), _mm256_mul_ps(f, p));
+    F32x8 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(i, _mm256_set1_epi32(127)), 23));
+    return _mm256_mul_ps(p, scale);
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 log2ApproxF32x8(F32x8 x) {
+    __m256i bits = _mm256_sub_epi32(_mm256_castps_si256(x), _mm256_set1_epi32(0x3f3504f3));
+    F32x8 e = _mm256_cvtepi32_ps(_mm256_srai_epi32(bits, 23));
+    F32x8 m = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f3504f3)));
+    F32x8 t = _mm256_div_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)), _mm256_add_ps(m, _mm256_set1_ps(1.0f)));
+    F32x8 t2 = _mm256_mul_ps(t, t);
+    F32x8 p = _mm256_add_ps(_mm256_set1_ps(0.577078016f), _mm256_mul_ps(t2, _mm256_set1_ps(0.412198583f)));
+    p = _mm256_add_ps(_mm256_set1_ps(0.961796694f), _mm256_mul_ps(t2, p));
+    p = _mm256_add_ps(_mm256_set1_ps(2.88539008f), _mm256_mul_ps(t2, p));
+    return _mm256_add_ps(e, _mm256_mul_ps(t, p));
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 expApproxF32x8(F32x8 x) {
+    return exp2ApproxF32x8(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)));
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 logApproxF32x8(F32x8 x) {
+    return _mm256_mul_ps(log2ApproxF32x8(x), _mm256_set1_ps(0.693147181f));
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 powApproxF32x8(F32x8 x, F32x8 y) {
+    return exp2ApproxF32x8(_mm256_mul_ps(y, log2ApproxF32x8(x)));
+}
+
+XTD_TARGET_AVX2 XTD_MATH_FORCE_INLINE F32x8 atan2ApproxF32x8(F32x8 y, F32x8 x) {
+    F32x8 sign_mask = _mm256_set1_ps(-0.0f);
+    F32x8 ax = _mm256_andnot_ps(sign_mask, x);
+    F32x8 ay = _mm256_andnot_ps(sign_mask, y);
+    F32x8 mx = _mm256_max_ps(ax, ay);
+    F32x8 mn = _mm256_min_ps(ax, ay);
+    F32x8 z = _mm256_and_ps(_mm256_cmp_ps(mx, _mm256_setzero_ps(), _CMP_GT_OQ), _mm256_div_ps(mn, mx));
+    F32x8 z2 = _mm256_mul_ps(z, z);
+    F32x8 r = _mm256_add_ps(_mm256_set1_ps(_XTD_ATAN_C5), _mm256_mul_ps(z2, _mm256_set1_ps(_XTD_ATAN_C6)));
+    r = _mm256_add_ps(_mm256_set1_ps(_XTD_ATAN_C4), _mm256_mul_ps(z2, r));
+    r = _mm256_add_ps(_mm256_set1_ps(_XTD_ATAN_C3), _mm256_mul_ps(z2, r));
+    r = _mm256_add_ps(_mm256_set1_ps(_XTD_ATAN_C2), _mm256_mul_ps(z2, r));
+    r = _mm256_add_ps(_mm256_set1_ps(_XTD_ATAN_C1), _mm256_mul_ps(z2, r));
+    r = _mm256_mul_ps(z, _mm256_add_ps(_mm256_set1_ps(_XTD_ATAN_C0), _mm256_mul_ps(z2, r)));
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(1.57079633f), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+    r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(3.14159265f), r), _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ));
+    return _mm256_or_ps(r, _mm256_and_ps(y, sign_mask));
+}
+
+#endif // XTD_HAS_AVX2 || XTD_HAS_CPU_DISPATCH
+
 ////////////////////////////////////////
 //
 //  Random functions
@@ -119,6 +661,109 @@ typedef union V4f_ {
     f32 e[4];
 } V4f; 
 
+// Integer and Q16.16 fixed point vectors
+
+typedef union V2i_ {
+    struct
+    {
+        i32 x, y;
+    };
+    i32 e[2];
+} V2i;
+
+typedef union V3i_ {
+    struct
+    {
+        i32 x, y, z;
+    };
+    struct
+    {
+        V2i xy;
+        i32 _z;
+    };
+    i32 e[3];
+} V3i;
+
+typedef union V4i_ {
+    struct
+    {
+        i32 x, y, z, w;
+    };
+    struct
+    {
+        V3i xyz;
+        i32 _w;
+    };
+    struct
+    {
+        V2i xy;
+        V2i zw;
+    };
+    i32 e[4];
+} V4i;
+
+typedef union V2q_ {
+    struct
+    {
+        Q16 x, y;
+    };
+    Q16 e[2];
+} V2q;
+
+typedef union V3q_ {
+    struct
+    {
+        Q16 x, y, z;
+    };
+    struct
+    {
+        V2q xy;
+        Q16 _z;
+    };
+    Q16 e[3];
+} V3q;
+
+typedef union V4q_ {
+    struct
+    {
+        Q16 x, y, z, w;
+    };
+    struct
+    {
+        V3q xyz;
+        Q16 _w;
+    };
+    struct
+    {
+        V2q xy;
+        V2q zw;
+    };
+    Q16 e[4];
+} V4q;
+
+// Half precision storage vectors, 8 and 6 bytes with no padding
+
+typedef union V3h_ {
+    struct
+    {
+        f16 x, y, z;
+    };
+    f16 e[3];
+} V3h;
+
+typedef union V4h_ {
+    struct
+    {
+        f16 x, y, z, w;
+    };
+    struct
+    {
+        V3h xyz;
+        f16 _w;
+    };
+    f16 e[4];
+} V4h;
+
 
 ////////////////////////////////////////
 //
@@ -528,66 +1173,630 @@ XTD_MATH_FORCE_INLINE V2f rand2fUnitLength() {
     return noz2f(rand2fUnitCircle());
 }
 
-#ifdef __cplusplus
-extern "C++" {
-
 //
-// Vector 4
+// Integer Vector 4
 //
 
-XTD_MATH_FORCE_INLINE V4f operator+(V4f a, V4f b) {
-    return add4f(a, b);
-}
-XTD_MATH_FORCE_INLINE V4f operator+(V4f a, f32 b) {
-    return addsc4f(a, b);
+XTD_MATH_FORCE_INLINE V4i add4i(V4i a, V4i b) {
+    V4i res;
+    res.x = a.x + b.x;
+    res.y = a.y + b.y;
+    res.z = a.z + b.z;
+    res.w = a.w + b.w;
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f operator+(f32 a, V4f b) {
-    return addsc4f(b, a);
+XTD_MATH_FORCE_INLINE V4i addsc4i(V4i a, i32 b) {
+    V4i res;
+    res.x = a.x + b;
+    res.y = a.y + b;
+    res.z = a.z + b;
+    res.w = a.w + b;
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f& operator+=(V4f& a, const V4f& b)
-{
-	a = add4f(a, b);
-	return a;
+XTD_MATH_FORCE_INLINE V4i sub4i(V4i a, V4i b) {
+    V4i res;
+    res.x = a.x - b.x;
+    res.y = a.y - b.y;
+    res.z = a.z - b.z;
+    res.w = a.w - b.w;
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f& operator+=(V4f& a, const f32& b)
-{
-	a = addsc4f(a, b);
-	return a;
+XTD_MATH_FORCE_INLINE V4i neg4i(V4i a) {
+    V4i res;
+    res.x = -a.x;
+    res.y = -a.y;
+    res.z = -a.z;
+    res.w = -a.w;
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f operator-(V4f a, V4f b) {
-    return sub4f(a, b);
+XTD_MATH_FORCE_INLINE V4i subsc4i(V4i a, i32 b) {
+    V4i res;
+    res.x = a.x - b;
+    res.y = a.y - b;
+    res.z = a.z - b;
+    res.w = a.w - b;
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f operator-(V4f a) {
-    return neg4f(a);
+XTD_MATH_FORCE_INLINE V4i mul4i(V4i a, V4i b) {
+    V4i res;
+    res.x = a.x * b.x;
+    res.y = a.y * b.y;
+    res.z = a.z * b.z;
+    res.w = a.w * b.w;
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f& operator-=(V4f& a, const V4f& b)
-{
-	a = sub4f(a, b);
-	return a;
+XTD_MATH_FORCE_INLINE V4i sc4i(V4i a, i32 b) {
+    V4i res;
+    res.x = a.x * b;
+    res.y = a.y * b;
+    res.z = a.z * b;
+    res.w = a.w * b;
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f& operator-=(V4f& a, const f32& b)
-{
-	a = subsc4f(a, b);
-	return a;
+XTD_MATH_FORCE_INLINE V4i min4i(V4i a, V4i b) {
+    V4i res;
+    res.x = XTD_MIN(a.x, b.x);
+    res.y = XTD_MIN(a.y, b.y);
+    res.z = XTD_MIN(a.z, b.z);
+    res.w = XTD_MIN(a.w, b.w);
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f operator*(V4f a, V4f b) {
-    return mul4f(a, b);
+XTD_MATH_FORCE_INLINE V4i max4i(V4i a, V4i b) {
+    V4i res;
+    res.x = XTD_MAX(a.x, b.x);
+    res.y = XTD_MAX(a.y, b.y);
+    res.z = XTD_MAX(a.z, b.z);
+    res.w = XTD_MAX(a.w, b.w);
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f& operator*=(V4f& a, const V4f& b) {
-    a = mul4f(a, b);
-    return a;
+XTD_MATH_FORCE_INLINE V4i clamp4i(V4i a, V4i lo, V4i hi) {
+    V4i res;
+    res.x = XTD_CLAMP(a.x, lo.x, hi.x);
+    res.y = XTD_CLAMP(a.y, lo.y, hi.y);
+    res.z = XTD_CLAMP(a.z, lo.z, hi.z);
+    res.w = XTD_CLAMP(a.w, lo.w, hi.w);
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f operator*(V4f a, f32 b) {
-    return sc4f(a, b);
+XTD_MATH_FORCE_INLINE V4i abs4i(V4i a) {
+    V4i res;
+    res.x = a.x < 0 ? -a.x : a.x;
+    res.y = a.y < 0 ? -a.y : a.y;
+    res.z = a.z < 0 ? -a.z : a.z;
+    res.w = a.w < 0 ? -a.w : a.w;
+    return res;
 }
-XTD_MATH_FORCE_INLINE V4f operator*(f32 a, V4f b) {
-    return sc4f(b, a);
+XTD_MATH_FORCE_INLINE i32 dot4i(V4i a, V4i b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
 }
-XTD_MATH_FORCE_INLINE V4f& operator*=(V4f& a, f32 b) {
-    a = sc4f(a, b);
-    return a;
+XTD_MATH_FORCE_INLINE bool equal4i(V4i a, V4i b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
 }
-XTD_MATH_FORCE_INLINE V4f operator/(V4f a, V4f b) {
+
+//
+// Integer Vector 3
+//
+
+XTD_MATH_FORCE_INLINE V3i add3i(V3i a, V3i b) {
+    V3i res;
+    res.x = a.x + b.x;
+    res.y = a.y + b.y;
+    res.z = a.z + b.z;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i addsc3i(V3i a, i32 b) {
+    V3i res;
+    res.x = a.x + b;
+    res.y = a.y + b;
+    res.z = a.z + b;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i sub3i(V3i a, V3i b) {
+    V3i res;
+    res.x = a.x - b.x;
+    res.y = a.y - b.y;
+    res.z = a.z - b.z;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i neg3i(V3i a) {
+    V3i res;
+    res.x = -a.x;
+    res.y = -a.y;
+    res.z = -a.z;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i subsc3i(V3i a, i32 b) {
+    V3i res;
+    res.x = a.x - b;
+    res.y = a.y - b;
+    res.z = a.z - b;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i mul3i(V3i a, V3i b) {
+    V3i res;
+    res.x = a.x * b.x;
+    res.y = a.y * b.y;
+    res.z = a.z * b.z;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i sc3i(V3i a, i32 b) {
+    V3i res;
+    res.x = a.x * b;
+    res.y = a.y * b;
+    res.z = a.z * b;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i min3i(V3i a, V3i b) {
+    V3i res;
+    res.x = XTD_MIN(a.x, b.x);
+    res.y = XTD_MIN(a.y, b.y);
+    res.z = XTD_MIN(a.z, b.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i max3i(V3i a, V3i b) {
+    V3i res;
+    res.x = XTD_MAX(a.x, b.x);
+    res.y = XTD_MAX(a.y, b.y);
+    res.z = XTD_MAX(a.z, b.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i clamp3i(V3i a, V3i lo, V3i hi) {
+    V3i res;
+    res.x = XTD_CLAMP(a.x, lo.x, hi.x);
+    res.y = XTD_CLAMP(a.y, lo.y, hi.y);
+    res.z = XTD_CLAMP(a.z, lo.z, hi.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3i abs3i(V3i a) {
+    V3i res;
+    res.x = a.x < 0 ? -a.x : a.x;
+    res.y = a.y < 0 ? -a.y : a.y;
+    res.z = a.z < 0 ? -a.z : a.z;
+    return res;
+}
+XTD_MATH_FORCE_INLINE i32 dot3i(V3i a, V3i b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+XTD_MATH_FORCE_INLINE bool equal3i(V3i a, V3i b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+//
+// Integer Vector 2
+//
+
+XTD_MATH_FORCE_INLINE V2i add2i(V2i a, V2i b) {
+    V2i res;
+    res.x = a.x + b.x;
+    res.y = a.y + b.y;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i addsc2i(V2i a, i32 b) {
+    V2i res;
+    res.x = a.x + b;
+    res.y = a.y + b;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i sub2i(V2i a, V2i b) {
+    V2i res;
+    res.x = a.x - b.x;
+    res.y = a.y - b.y;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i neg2i(V2i a) {
+    V2i res;
+    res.x = -a.x;
+    res.y = -a.y;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i subsc2i(V2i a, i32 b) {
+    V2i res;
+    res.x = a.x - b;
+    res.y = a.y - b;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i mul2i(V2i a, V2i b) {
+    V2i res;
+    res.x = a.x * b.x;
+    res.y = a.y * b.y;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i sc2i(V2i a, i32 b) {
+    V2i res;
+    res.x = a.x * b;
+    res.y = a.y * b;
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i min2i(V2i a, V2i b) {
+    V2i res;
+    res.x = XTD_MIN(a.x, b.x);
+    res.y = XTD_MIN(a.y, b.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i max2i(V2i a, V2i b) {
+    V2i res;
+    res.x = XTD_MAX(a.x, b.x);
+    res.y = XTD_MAX(a.y, b.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i clamp2i(V2i a, V2i lo, V2i hi) {
+    V2i res;
+    res.x = XTD_CLAMP(a.x, lo.x, hi.x);
+    res.y = XTD_CLAMP(a.y, lo.y, hi.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2i abs2i(V2i a) {
+    V2i res;
+    res.x = a.x < 0 ? -a.x : a.x;
+    res.y = a.y < 0 ? -a.y : a.y;
+    return res;
+}
+XTD_MATH_FORCE_INLINE i32 dot2i(V2i a, V2i b) {
+    return a.x * b.x + a.y * b.y;
+}
+XTD_MATH_FORCE_INLINE bool equal2i(V2i a, V2i b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+//
+// Fixed point Vector 4
+//
+
+XTD_MATH_FORCE_INLINE V4q add4q(V4q a, V4q b) {
+    V4q res;
+    res.x = (Q16)((u32)a.x + (u32)b.x);
+    res.y = (Q16)((u32)a.y + (u32)b.y);
+    res.z = (Q16)((u32)a.z + (u32)b.z);
+    res.w = (Q16)((u32)a.w + (u32)b.w);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q addsc4q(V4q a, Q16 b) {
+    V4q res;
+    res.x = (Q16)((u32)a.x + (u32)b);
+    res.y = (Q16)((u32)a.y + (u32)b);
+    res.z = (Q16)((u32)a.z + (u32)b);
+    res.w = (Q16)((u32)a.w + (u32)b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q sub4q(V4q a, V4q b) {
+    V4q res;
+    res.x = (Q16)((u32)a.x - (u32)b.x);
+    res.y = (Q16)((u32)a.y - (u32)b.y);
+    res.z = (Q16)((u32)a.z - (u32)b.z);
+    res.w = (Q16)((u32)a.w - (u32)b.w);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q neg4q(V4q a) {
+    V4q res;
+    res.x = (Q16)(0u - (u32)a.x);
+    res.y = (Q16)(0u - (u32)a.y);
+    res.z = (Q16)(0u - (u32)a.z);
+    res.w = (Q16)(0u - (u32)a.w);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q subsc4q(V4q a, Q16 b) {
+    V4q res;
+    res.x = (Q16)((u32)a.x - (u32)b);
+    res.y = (Q16)((u32)a.y - (u32)b);
+    res.z = (Q16)((u32)a.z - (u32)b);
+    res.w = (Q16)((u32)a.w - (u32)b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q mul4q(V4q a, V4q b) {
+    V4q res;
+    res.x = mulQ16(a.x, b.x);
+    res.y = mulQ16(a.y, b.y);
+    res.z = mulQ16(a.z, b.z);
+    res.w = mulQ16(a.w, b.w);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q sc4q(V4q a, Q16 b) {
+    V4q res;
+    res.x = mulQ16(a.x, b);
+    res.y = mulQ16(a.y, b);
+    res.z = mulQ16(a.z, b);
+    res.w = mulQ16(a.w, b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q div4q(V4q a, V4q b) {
+    V4q res;
+    res.x = divQ16(a.x, b.x);
+    res.y = divQ16(a.y, b.y);
+    res.z = divQ16(a.z, b.z);
+    res.w = divQ16(a.w, b.w);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q divsc4q(V4q a, Q16 b) {
+    V4q res;
+    res.x = divQ16(a.x, b);
+    res.y = divQ16(a.y, b);
+    res.z = divQ16(a.z, b);
+    res.w = divQ16(a.w, b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q min4q(V4q a, V4q b) {
+    V4q res;
+    res.x = XTD_MIN(a.x, b.x);
+    res.y = XTD_MIN(a.y, b.y);
+    res.z = XTD_MIN(a.z, b.z);
+    res.w = XTD_MIN(a.w, b.w);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q max4q(V4q a, V4q b) {
+    V4q res;
+    res.x = XTD_MAX(a.x, b.x);
+    res.y = XTD_MAX(a.y, b.y);
+    res.z = XTD_MAX(a.z, b.z);
+    res.w = XTD_MAX(a.w, b.w);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V4q clamp4q(V4q a, V4q lo, V4q hi) {
+    V4q res;
+    res.x = XTD_CLAMP(a.x, lo.x, hi.x);
+    res.y = XTD_CLAMP(a.y, lo.y, hi.y);
+    res.z = XTD_CLAMP(a.z, lo.z, hi.z);
+    res.w = XTD_CLAMP(a.w, lo.w, hi.w);
+    return res;
+}
+XTD_MATH_FORCE_INLINE Q16 dot4q(V4q a, V4q b) {
+    // Accumulated at 32.32 and rounded once
+    i64 acc = (i64)a.x * b.x + (i64)a.y * b.y + (i64)a.z * b.z + (i64)a.w * b.w;
+    return (Q16)((acc + 0x8000) >> 16);
+}
+XTD_MATH_FORCE_INLINE Q16 lengthSq4q(V4q a) {
+    return dot4q(a, a);
+}
+XTD_MATH_FORCE_INLINE Q16 length4q(V4q a) {
+    return _xtd_LengthQ16(a.e, 4);
+}
+
+//
+// Fixed point Vector 3
+//
+
+XTD_MATH_FORCE_INLINE V3q add3q(V3q a, V3q b) {
+    V3q res;
+    res.x = (Q16)((u32)a.x + (u32)b.x);
+    res.y = (Q16)((u32)a.y + (u32)b.y);
+    res.z = (Q16)((u32)a.z + (u32)b.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q addsc3q(V3q a, Q16 b) {
+    V3q res;
+    res.x = (Q16)((u32)a.x + (u32)b);
+    res.y = (Q16)((u32)a.y + (u32)b);
+    res.z = (Q16)((u32)a.z + (u32)b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q sub3q(V3q a, V3q b) {
+    V3q res;
+    res.x = (Q16)((u32)a.x - (u32)b.x);
+    res.y = (Q16)((u32)a.y - (u32)b.y);
+    res.z = (Q16)((u32)a.z - (u32)b.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q neg3q(V3q a) {
+    V3q res;
+    res.x = (Q16)(0u - (u32)a.x);
+    res.y = (Q16)(0u - (u32)a.y);
+    res.z = (Q16)(0u - (u32)a.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q subsc3q(V3q a, Q16 b) {
+    V3q res;
+    res.x = (Q16)((u32)a.x - (u32)b);
+    res.y = (Q16)((u32)a.y - (u32)b);
+    res.z = (Q16)((u32)a.z - (u32)b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q mul3q(V3q a, V3q b) {
+    V3q res;
+    res.x = mulQ16(a.x, b.x);
+    res.y = mulQ16(a.y, b.y);
+    res.z = mulQ16(a.z, b.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q sc3q(V3q a, Q16 b) {
+    V3q res;
+    res.x = mulQ16(a.x, b);
+    res.y = mulQ16(a.y, b);
+    res.z = mulQ16(a.z, b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q div3q(V3q a, V3q b) {
+    V3q res;
+    res.x = divQ16(a.x, b.x);
+    res.y = divQ16(a.y, b.y);
+    res.z = divQ16(a.z, b.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q divsc3q(V3q a, Q16 b) {
+    V3q res;
+    res.x = divQ16(a.x, b);
+    res.y = divQ16(a.y, b);
+    res.z = divQ16(a.z, b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q min3q(V3q a, V3q b) {
+    V3q res;
+    res.x = XTD_MIN(a.x, b.x);
+    res.y = XTD_MIN(a.y, b.y);
+    res.z = XTD_MIN(a.z, b.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q max3q(V3q a, V3q b) {
+    V3q res;
+    res.x = XTD_MAX(a.x, b.x);
+    res.y = XTD_MAX(a.y, b.y);
+    res.z = XTD_MAX(a.z, b.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V3q clamp3q(V3q a, V3q lo, V3q hi) {
+    V3q res;
+    res.x = XTD_CLAMP(a.x, lo.x, hi.x);
+    res.y = XTD_CLAMP(a.y, lo.y, hi.y);
+    res.z = XTD_CLAMP(a.z, lo.z, hi.z);
+    return res;
+}
+XTD_MATH_FORCE_INLINE Q16 dot3q(V3q a, V3q b) {
+    // Accumulated at 32.32 and rounded once
+    i64 acc = (i64)a.x * b.x + (i64)a.y * b.y + (i64)a.z * b.z;
+    return (Q16)((acc + 0x8000) >> 16);
+}
+XTD_MATH_FORCE_INLINE Q16 lengthSq3q(V3q a) {
+    return dot3q(a, a);
+}
+XTD_MATH_FORCE_INLINE Q16 length3q(V3q a) {
+    return _xtd_LengthQ16(a.e, 3);
+}
+
+//
+// Fixed point Vector 2
+//
+
+XTD_MATH_FORCE_INLINE V2q add2q(V2q a, V2q b) {
+    V2q res;
+    res.x = (Q16)((u32)a.x + (u32)b.x);
+    res.y = (Q16)((u32)a.y + (u32)b.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q addsc2q(V2q a, Q16 b) {
+    V2q res;
+    res.x = (Q16)((u32)a.x + (u32)b);
+    res.y = (Q16)((u32)a.y + (u32)b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q sub2q(V2q a, V2q b) {
+    V2q res;
+    res.x = (Q16)((u32)a.x - (u32)b.x);
+    res.y = (Q16)((u32)a.y - (u32)b.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q neg2q(V2q a) {
+    V2q res;
+    res.x = (Q16)(0u - (u32)a.x);
+    res.y = (Q16)(0u - (u32)a.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q subsc2q(V2q a, Q16 b) {
+    V2q res;
+    res.x = (Q16)((u32)a.x - (u32)b);
+    res.y = (Q16)((u32)a.y - (u32)b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q mul2q(V2q a, V2q b) {
+    V2q res;
+    res.x = mulQ16(a.x, b.x);
+    res.y = mulQ16(a.y, b.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q sc2q(V2q a, Q16 b) {
+    V2q res;
+    res.x = mulQ16(a.x, b);
+    res.y = mulQ16(a.y, b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q div2q(V2q a, V2q b) {
+    V2q res;
+    res.x = divQ16(a.x, b.x);
+    res.y = divQ16(a.y, b.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q divsc2q(V2q a, Q16 b) {
+    V2q res;
+    res.x = divQ16(a.x, b);
+    res.y = divQ16(a.y, b);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q min2q(V2q a, V2q b) {
+    V2q res;
+    res.x = XTD_MIN(a.x, b.x);
+    res.y = XTD_MIN(a.y, b.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q max2q(V2q a, V2q b) {
+    V2q res;
+    res.x = XTD_MAX(a.x, b.x);
+    res.y = XTD_MAX(a.y, b.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE V2q clamp2q(V2q a, V2q lo, V2q hi) {
+    V2q res;
+    res.x = XTD_CLAMP(a.x, lo.x, hi.x);
+    res.y = XTD_CLAMP(a.y, lo.y, hi.y);
+    return res;
+}
+XTD_MATH_FORCE_INLINE Q16 dot2q(V2q a, V2q b) {
+    // Accumulated at 32.32 and rounded once
+    i64 acc = (i64)a.x * b.x + (i64)a.y * b.y;
+    return (Q16)((acc + 0x8000) >> 16);
+}
+XTD_MATH_FORCE_INLINE Q16 lengthSq2q(V2q a) {
+    return dot2q(a, a);
+}
+XTD_MATH_FORCE_INLINE Q16 length2q(V2q a) {
+    return _xtd_LengthQ16(a.e, 2);
+}
+
+#ifdef __cplusplus
+extern "C++" {
+
+//
+// Vector 4
+//
+
+XTD_MATH_FORCE_INLINE V4f operator+(V4f a, V4f b) {
+    return add4f(a, b);
+}
+XTD_MATH_FORCE_INLINE V4f operator+(V4f a, f32 b) {
+    return addsc4f(a, b);
+}
+XTD_MATH_FORCE_INLINE V4f operator+(f32 a, V4f b) {
+    return addsc4f(b, a);
+}
+XTD_MATH_FORCE_INLINE V4f& operator+=(V4f& a, const V4f& b)
+{
+	a = add4f(a, b);
+	return a;
+}
+XTD_MATH_FORCE_INLINE V4f& operator+=(V4f& a, const f32& b)
+{
+	a = addsc4f(a, b);
+	return a;
+}
+XTD_MATH_FORCE_INLINE V4f operator-(V4f a, V4f b) {
+    return sub4f(a, b);
+}
+XTD_MATH_FORCE_INLINE V4f operator-(V4f a) {
+    return neg4f(a);
+}
+XTD_MATH_FORCE_INLINE V4f& operator-=(V4f& a, const V4f& b)
+{
+	a = sub4f(a, b);
+	return a;
+}
+XTD_MATH_FORCE_INLINE V4f& operator-=(V4f& a, const f32& b)
+{
+	a = subsc4f(a, b);
+	return a;
+}
+XTD_MATH_FORCE_INLINE V4f operator*(V4f a, V4f b) {
+    return mul4f(a, b);
+}
+XTD_MATH_FORCE_INLINE V4f& operator*=(V4f& a, const V4f& b) {
+    a = mul4f(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V4f operator*(V4f a, f32 b) {
+    return sc4f(a, b);
+}
+XTD_MATH_FORCE_INLINE V4f operator*(f32 a, V4f b) {
+    return sc4f(b, a);
+}
+XTD_MATH_FORCE_INLINE V4f& operator*=(V4f& a, f32 b) {
+    a = sc4f(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V4f operator/(V4f a, V4f b) {
     return div4f(a, b);
 }
 XTD_MATH_FORCE_INLINE V4f operator/(V4f a, f32 b) {
@@ -721,19 +1930,268 @@ XTD_MATH_FORCE_INLINE V2f operator/(V2f a, f32 b) {
 }
 
 //
-// C++: Operator Overloaded versions
+// V4i
 //
 
-XTD_MATH_FORCE_INLINE f32 lengthSq(V4f a) {
-    return lengthSq4f(a);
+XTD_MATH_FORCE_INLINE V4i operator+(V4i a, V4i b) {
+    return add4i(a, b);
 }
-XTD_MATH_FORCE_INLINE f32 length(V4f a) {
-    return length4f(a);
+XTD_MATH_FORCE_INLINE V4i operator+(V4i a, i32 b) {
+    return addsc4i(a, b);
 }
-XTD_MATH_FORCE_INLINE V4f normalized(V4f a) {
-    return normalized4f(a);
+XTD_MATH_FORCE_INLINE V4i& operator+=(V4i& a, const V4i& b) {
+    a = add4i(a, b);
+    return a;
 }
-XTD_MATH_FORCE_INLINE V4f noz(V4f a) {
+XTD_MATH_FORCE_INLINE V4i operator-(V4i a, V4i b) {
+    return sub4i(a, b);
+}
+XTD_MATH_FORCE_INLINE V4i operator-(V4i a) {
+    return neg4i(a);
+}
+XTD_MATH_FORCE_INLINE V4i operator-(V4i a, i32 b) {
+    return subsc4i(a, b);
+}
+XTD_MATH_FORCE_INLINE V4i& operator-=(V4i& a, const V4i& b) {
+    a = sub4i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V4i operator*(V4i a, V4i b) {
+    return mul4i(a, b);
+}
+XTD_MATH_FORCE_INLINE V4i& operator*=(V4i& a, const V4i& b) {
+    a = mul4i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V4i operator*(V4i a, i32 b) {
+    return sc4i(a, b);
+}
+XTD_MATH_FORCE_INLINE V4i operator*(i32 a, V4i b) {
+    return sc4i(b, a);
+}
+XTD_MATH_FORCE_INLINE V4i& operator*=(V4i& a, i32 b) {
+    a = sc4i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE bool operator==(V4i a, V4i b) {
+    return equal4i(a, b);
+}
+XTD_MATH_FORCE_INLINE bool operator!=(V4i a, V4i b) {
+    return !equal4i(a, b);
+}
+
+//
+// V3i
+//
+
+XTD_MATH_FORCE_INLINE V3i operator+(V3i a, V3i b) {
+    return add3i(a, b);
+}
+XTD_MATH_FORCE_INLINE V3i operator+(V3i a, i32 b) {
+    return addsc3i(a, b);
+}
+XTD_MATH_FORCE_INLINE V3i& operator+=(V3i& a, const V3i& b) {
+    a = add3i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V3i operator-(V3i a, V3i b) {
+    return sub3i(a, b);
+}
+XTD_MATH_FORCE_INLINE V3i operator-(V3i a) {
+    return neg3i(a);
+}
+XTD_MATH_FORCE_INLINE V3i operator-(V3i a, i32 b) {
+    return subsc3i(a, b);
+}
+XTD_MATH_FORCE_INLINE V3i& operator-=(V3i& a, const V3i& b) {
+    a = sub3i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V3i operator*(V3i a, V3i b) {
+    return mul3i(a, b);
+}
+XTD_MATH_FORCE_INLINE V3i& operator*=(V3i& a, const V3i& b) {
+    a = mul3i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V3i operator*(V3i a, i32 b) {
+    return sc3i(a, b);
+}
+XTD_MATH_FORCE_INLINE V3i operator*(i32 a, V3i b) {
+    return sc3i(b, a);
+}
+XTD_MATH_FORCE_INLINE V3i& operator*=(V3i& a, i32 b) {
+    a = sc3i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE bool operator==(V3i a, V3i b) {
+    return equal3i(a, b);
+}
+XTD_MATH_FORCE_INLINE bool operator!=(V3i a, V3i b) {
+    return !equal3i(a, b);
+}
+
+//
+// V2i
+//
+
+XTD_MATH_FORCE_INLINE V2i operator+(V2i a, V2i b) {
+    return add2i(a, b);
+}
+XTD_MATH_FORCE_INLINE V2i operator+(V2i a, i32 b) {
+    return addsc2i(a, b);
+}
+XTD_MATH_FORCE_INLINE V2i& operator+=(V2i& a, const V2i& b) {
+    a = add2i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V2i operator-(V2i a, V2i b) {
+    return sub2i(a, b);
+}
+XTD_MATH_FORCE_INLINE V2i operator-(V2i a) {
+    return neg2i(a);
+}
+XTD_MATH_FORCE_INLINE V2i operator-(V2i a, i32 b) {
+    return subsc2i(a, b);
+}
+XTD_MATH_FORCE_INLINE V2i& operator-=(V2i& a, const V2i& b) {
+    a = sub2i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V2i operator*(V2i a, V2i b) {
+    return mul2i(a, b);
+}
+XTD_MATH_FORCE_INLINE V2i& operator*=(V2i& a, const V2i& b) {
+    a = mul2i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V2i operator*(V2i a, i32 b) {
+    return sc2i(a, b);
+}
+XTD_MATH_FORCE_INLINE V2i operator*(i32 a, V2i b) {
+    return sc2i(b, a);
+}
+XTD_MATH_FORCE_INLINE V2i& operator*=(V2i& a, i32 b) {
+    a = sc2i(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE bool operator==(V2i a, V2i b) {
+    return equal2i(a, b);
+}
+XTD_MATH_FORCE_INLINE bool operator!=(V2i a, V2i b) {
+    return !equal2i(a, b);
+}
+
+//
+// V4q
+//
+
+XTD_MATH_FORCE_INLINE V4q operator+(V4q a, V4q b) {
+    return add4q(a, b);
+}
+XTD_MATH_FORCE_INLINE V4q& operator+=(V4q& a, const V4q& b) {
+    a = add4q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V4q operator-(V4q a, V4q b) {
+    return sub4q(a, b);
+}
+XTD_MATH_FORCE_INLINE V4q operator-(V4q a) {
+    return neg4q(a);
+}
+XTD_MATH_FORCE_INLINE V4q& operator-=(V4q& a, const V4q& b) {
+    a = sub4q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V4q operator*(V4q a, V4q b) {
+    return mul4q(a, b);
+}
+XTD_MATH_FORCE_INLINE V4q& operator*=(V4q& a, const V4q& b) {
+    a = mul4q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V4q operator/(V4q a, V4q b) {
+    return div4q(a, b);
+}
+
+//
+// V3q
+//
+
+XTD_MATH_FORCE_INLINE V3q operator+(V3q a, V3q b) {
+    return add3q(a, b);
+}
+XTD_MATH_FORCE_INLINE V3q& operator+=(V3q& a, const V3q& b) {
+    a = add3q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V3q operator-(V3q a, V3q b) {
+    return sub3q(a, b);
+}
+XTD_MATH_FORCE_INLINE V3q operator-(V3q a) {
+    return neg3q(a);
+}
+XTD_MATH_FORCE_INLINE V3q& operator-=(V3q& a, const V3q& b) {
+    a = sub3q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V3q operator*(V3q a, V3q b) {
+    return mul3q(a, b);
+}
+XTD_MATH_FORCE_INLINE V3q& operator*=(V3q& a, const V3q& b) {
+    a = mul3q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V3q operator/(V3q a, V3q b) {
+    return div3q(a, b);
+}
+
+//
+// V2q
+//
+
+XTD_MATH_FORCE_INLINE V2q operator+(V2q a, V2q b) {
+    return add2q(a, b);
+}
+XTD_MATH_FORCE_INLINE V2q& operator+=(V2q& a, const V2q& b) {
+    a = add2q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V2q operator-(V2q a, V2q b) {
+    return sub2q(a, b);
+}
+XTD_MATH_FORCE_INLINE V2q operator-(V2q a) {
+    return neg2q(a);
+}
+XTD_MATH_FORCE_INLINE V2q& operator-=(V2q& a, const V2q& b) {
+    a = sub2q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V2q operator*(V2q a, V2q b) {
+    return mul2q(a, b);
+}
+XTD_MATH_FORCE_INLINE V2q& operator*=(V2q& a, const V2q& b) {
+    a = mul2q(a, b);
+    return a;
+}
+XTD_MATH_FORCE_INLINE V2q operator/(V2q a, V2q b) {
+    return div2q(a, b);
+}
+
+//
+// C++: Operator Overloaded versions
+//
+
+XTD_MATH_FORCE_INLINE f32 lengthSq(V4f a) {
+    return lengthSq4f(a);
+}
+XTD_MATH_FORCE_INLINE f32 length(V4f a) {
+    return length4f(a);
+}
+XTD_MATH_FORCE_INLINE V4f normalized(V4f a) {
+    return normalized4f(a);
+}
+XTD_MATH_FORCE_INLINE V4f noz(V4f a) {
     return noz4f(a);
 }
 
@@ -744,10 +2202,10 @@ XTD_MATH_FORCE_INLINE f32 lengthSq(V3f a) {
 XTD_MATH_FORCE_INLINE f32 length(V3f a) {
     return length3f(a);
 }
-XTD_MATH_FORCE_INLINE V4f normalized(V3f a) {
+XTD_MATH_FORCE_INLINE V3f normalized(V3f a) {
     return normalized3f(a);
 }
-XTD_MATH_FORCE_INLINE V4f noz(V3f a) {
+XTD_MATH_FORCE_INLINE V3f noz(V3f a) {
     return noz3f(a);
 }
 
@@ -757,10 +2215,10 @@ XTD_MATH_FORCE_INLINE f32 lengthSq(V2f a) {
 XTD_MATH_FORCE_INLINE f32 length(V2f a) {
     return length2f(a);
 }
-XTD_MATH_FORCE_INLINE V4f normalized(V2f a) {
+XTD_MATH_FORCE_INLINE V2f normalized(V2f a) {
     return normalized2f(a);
 }
-XTD_MATH_FORCE_INLINE V4f noz(V2f a) {
+XTD_MATH_FORCE_INLINE V2f noz(V2f a) {
     return noz2f(a);
 }
 
@@ -772,12 +2230,516 @@ XTD_MATH_FORCE_INLINE V4f noz(V2f a) {
 //  Vector Utility functions
 //
 
+// Float, integer and fixed point vector conversions.
+// Round variants round to nearest even (current SSE rounding mode), trunc variants towards zero.
+
+XTD_MATH_FORCE_INLINE V4i floatToIntRound4i(V4f a) {
+    V4i res;
+#if XTD_HAS_SSE2
+    _mm_storeu_si128((__m128i*)res.e, _mm_cvtps_epi32(_mm_loadu_ps(a.e)));
+#else
+    for (int i = 0; i < 4; i++)
+        res.e[i] = (i32)lrintf(a.e[i]);
+#endif
+    return res;
+}
+
+XTD_MATH_FORCE_INLINE V4i floatToIntTrunc4i(V4f a) {
+    V4i res;
+#if XTD_HAS_SSE2
+    _mm_storeu_si128((__m128i*)res.e, _mm_cvttps_epi32(_mm_loadu_ps(a.e)));
+#else
+    for (int i = 0; i < 4; i++)
+        res.e[i] = (i32)a.e[i];
+#endif
+    return res;
+}
+
+XTD_MATH_FORCE_INLINE V4f intToFloat4f(V4i a) {
+    V4f res;
+#if XTD_HAS_SSE2
+    _mm_storeu_ps(res.e, _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)a.e)));
+#else
+    for (int i = 0; i < 4; i++)
+        res.e[i] = (f32)a.e[i];
+#endif
+    return res;
+}
+
+XTD_MATH_FORCE_INLINE V4q floatToFixed4q(V4f a) {
+    V4q res;
+#if XTD_HAS_SSE2
+    // Same steps as fromF32Q16: add +-0.5 and truncate
+    __m128 x = _mm_loadu_ps(a.e);
+    __m128 positive = _mm_cmpge_ps(x, _mm_setzero_ps());
+    __m128 half = _mm_or_ps(_mm_and_ps(positive, _mm_set1_ps(0.5f)), _mm_andnot_ps(positive, _mm_set1_ps(-0.5f)));
+    __m128 scaled = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps((f32)Q16_ONE)), half);
+    _mm_storeu_si128((__m128i*)res.e, _mm_cvttps_epi32(scaled));
+#else
+    for (int i = 0; i < 4; i++)
+        res.e[i] = fromF32Q16(a.e[i]);
+#endif
+    return res;
+}
+
+XTD_MATH_FORCE_INLINE V4f fixedToFloat4f(V4q a) {
+    V4f res;
+#if XTD_HAS_SSE2
+    __m128 f = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)a.e));
+    _mm_storeu_ps(res.e, _mm_mul_ps(f, _mm_set1_ps(1.0f / Q16_ONE)));
+#else
+    for (int i = 0; i < 4; i++)
+        res.e[i] = toF32Q16(a.e[i]);
+#endif
+    return res;
+}
+
+XTD_MATH_FORCE_INLINE V4q intToFixed4q(V4i a) {
+    V4q res;
+    for (int i = 0; i < 4; i++)
+        res.e[i] = fromIntQ16(a.e[i]);
+    return res;
+}
+
+// Rounds towards negative infinity
+XTD_MATH_FORCE_INLINE V4i fixedToInt4i(V4q a) {
+    V4i res;
+    for (int i = 0; i < 4; i++)
+        res.e[i] = toIntQ16(a.e[i]);
+    return res;
+}
+
+// The 3 and 2 component versions go through the 4 wide ones, the padding lanes are ignored
+
+XTD_MATH_FORCE_INLINE V3i floatToIntRound3i(V3f a) {
+    V4f v = {{a.x, a.y, a.z, 0.0f}};
+    return floatToIntRound4i(v).xyz;
+}
+
+XTD_MATH_FORCE_INLINE V3i floatToIntTrunc3i(V3f a) {
+    V4f v = {{a.x, a.y, a.z, 0.0f}};
+    return floatToIntTrunc4i(v).xyz;
+}
+
+XTD_MATH_FORCE_INLINE V3f intToFloat3f(V3i a) {
+    V4i v = {{a.x, a.y, a.z, 0}};
+    return intToFloat4f(v).xyz;
+}
+
+XTD_MATH_FORCE_INLINE V3q floatToFixed3q(V3f a) {
+    V4f v = {{a.x, a.y, a.z, 0.0f}};
+    return floatToFixed4q(v).xyz;
+}
+
+XTD_MATH_FORCE_INLINE V3f fixedToFloat3f(V3q a) {
+    V4q v = {{a.x, a.y, a.z, 0}};
+    return fixedToFloat4f(v).xyz;
+}
+
+XTD_MATH_FORCE_INLINE V3q intToFixed3q(V3i a) {
+    V4i v = {{a.x, a.y, a.z, 0}};
+    return intToFixed4q(v).xyz;
+}
+
+XTD_MATH_FORCE_INLINE V3i fixedToInt3i(V3q a) {
+    V4q v = {{a.x, a.y, a.z, 0}};
+    return fixedToInt4i(v).xyz;
+}
+
+XTD_MATH_FORCE_INLINE V2i floatToIntRound2i(V2f a) {
+    V4f v = {{a.x, a.y, 0.0f, 0.0f}};
+    return floatToIntRound4i(v).xy;
+}
+
+XTD_MATH_FORCE_INLINE V2i floatToIntTrunc2i(V2f a) {
+    V4f v = {{a.x, a.y, 0.0f, 0.0f}};
+    return floatToIntTrunc4i(v).xy;
+}
+
+XTD_MATH_FORCE_INLINE V2f intToFloat2f(V2i a) {
+    V4i v = {{a.x, a.y, 0, 0}};
+    return intToFloat4f(v).xy;
+}
+
+XTD_MATH_FORCE_INLINE V2q floatToFixed2q(V2f a) {
+    V4f v = {{a.x, a.y, 0.0f, 0.0f}};
+    return floatToFixed4q(v).xy;
+}
+
+XTD_MATH_FORCE_INLINE V2f fixedToFloat2f(V2q a) {
+    V4q v = {{a.x, a.y, 0, 0}};
+    return fixedToFloat4f(v).xy;
+}
+
+XTD_MATH_FORCE_INLINE V2q intToFixed2q(V2i a) {
+    V4i v = {{a.x, a.y, 0, 0}};
+    return intToFixed4q(v).xy;
+}
+
+XTD_MATH_FORCE_INLINE V2i fixedToInt2i(V2q a) {
+    V4q v = {{a.x, a.y, 0, 0}};
+    return fixedToInt4i(v).xy;
+}
+
+XTD_MATH_FORCE_INLINE V4h floatToHalf4h(V4f a) {
+    V4h res;
+#if XTD_HAS_F16C
+    _mm_storel_epi64((__m128i*)res.e, _mm_cvtps_ph(_mm_loadu_ps(a.e), _MM_FROUND_TO_NEAREST_INT));
+#else
+    for (int i = 0; i < 4; i++)
+        res.e[i] = _xtd_F32ToF16Soft(a.e[i]);
+#endif
+    return res;
+}
+
+XTD_MATH_FORCE_INLINE V4f halfToFloat4f(V4h a) {
+    V4f res;
+#if XTD_HAS_F16C
+    _mm_storeu_ps(res.e, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)a.e)));
+#else
+    for (int i = 0; i < 4; i++)
+        res.e[i] = _xtd_F16ToF32Soft(a.e[i]);
+#endif
+    return res;
+}
+
+XTD_MATH_FORCE_INLINE V3h floatToHalf3h(V3f a) {
+    V4f v = {{a.x, a.y, a.z, 0.0f}};
+    return floatToHalf4h(v).xyz;
+}
+
+XTD_MATH_FORCE_INLINE V3f halfToFloat3f(V3h a) {
+    V4h v;
+    v.xyz = a;
+    v._w = 0;
+    return halfToFloat4f(v).xyz;
+}
+
+// normalized*f using rsqrtApproxF32 instead of sqrtf and a divide, zero vectors give NaN
+
+XTD_MATH_FORCE_INLINE V4f normalizedApprox4f(V4f a) {
+    return sc4f(a, rsqrtApproxF32(lengthSq4f(a)));
+}
+
+XTD_MATH_FORCE_INLINE V3f normalizedApprox3f(V3f a) {
+    return sc3f(a, rsqrtApproxF32(lengthSq3f(a)));
+}
+
+XTD_MATH_FORCE_INLINE V2f normalizedApprox2f(V2f a) {
+    return sc2f(a, rsqrtApproxF32(lengthSq2f(a)));
+}
 
 
 #if XTD_IS_COMPILER_GCC
 #pragma GCC diagnostic pop
 #endif
 
+////////////////////////////////////////
+//
+//  Generic vector template (C++)
+//
+
+// #define XTD_MATH_VEC_TEMPLATE before including to get xtd::Vec<T, N>, a fixed size vector of any
+// arithmetic type. Arithmetic operators don't compute anything, they build a small expression
+// tree that is evaluated component by component in a single loop when it is assigned to a Vec,
+// so a * s + b * t - c needs no temporary vectors. Vec<f32, 2..4> and Vec<i32, 2..4> have the
+// same layout as V2f..V4f and V2i..V4i and convert to and from them implicitly.
+// Vectors are referenced (not copied) by expressions, so evaluate them before the end of the
+// statement (assign to a Vec or use eval) instead of keeping them in an auto variable.
+// Everything is constexpr from C++14 on.
+
+#if defined(__cplusplus) && defined(XTD_MATH_VEC_TEMPLATE)
+
+#if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#define XTD_VEC_CONSTEXPR constexpr
+#else
+#define XTD_VEC_CONSTEXPR
+#endif
+
+extern "C++" {
+namespace xtd {
+
+template <typename T, int N> struct Vec;
+
+// Base of every expression, Expr provides Scalar, Size and a const operator[]
+template <typename Expr>
+struct VecExpr {
+    constexpr const Expr& self() const { return static_cast<const Expr&>(*this); }
+};
+
+// C vector with the same layout, if any
+struct _xtd_NoCVec {};
+template <typename T, int N> struct _xtd_CVec { typedef _xtd_NoCVec Type; };
+template <> struct _xtd_CVec<f32, 2> { typedef V2f Type; };
+template <> struct _xtd_CVec<f32, 3> { typedef V3f Type; };
+template <> struct _xtd_CVec<f32, 4> { typedef V4f Type; };
+template <> struct _xtd_CVec<i32, 2> { typedef V2i Type; };
+template <> struct _xtd_CVec<i32, 3> { typedef V3i Type; };
+template <> struct _xtd_CVec<i32, 4> { typedef V4i Type; };
+
+// Vectors are stored by reference in expression nodes, nodes and scalars by value
+template <typename Expr> struct _xtd_VecOperand { typedef const Expr Type; };
+template <typename T, int N> struct _xtd_VecOperand<Vec<T, N> > { typedef const Vec<T, N>& Type; };
+
+template <typename T, int N>
+struct Vec : VecExpr<Vec<T, N> > {
+    typedef T Scalar;
+    static const int Size = N;
+    typedef typename _xtd_CVec<T, N>::Type CType;
+
+    T e[N];
+
+    constexpr Vec() : e() {}
+    explicit XTD_VEC_CONSTEXPR Vec(T s) : e() {
+        for (int i = 0; i < N; i++)
+            e[i] = s;
+    }
+    template <typename... Args>
+    constexpr Vec(T a, T b, Args... rest) : e{a, b, static_cast<T>(rest)...} {
+        static_assert(sizeof...(Args) + 2 == N, "Wrong number of components");
+    }
+
+    // Evaluates the whole expression in one pass. Only component i of the operands is read
+    // to compute component i, so the destination can appear in the expression.
+    template <typename Expr>
+    XTD_VEC_CONSTEXPR Vec(const VecExpr<Expr>& expr) : e() {
+        static_assert(Expr::Size == N, "Vector size mismatch");
+        for (int i = 0; i < N; i++)
+            e[i] = expr.self()[i];
+    }
+    template <typename Expr>
+    XTD_VEC_CONSTEXPR Vec& operator=(const VecExpr<Expr>& expr) {
+        static_assert(Expr::Size == N, "Vector size mismatch");
+        for (int i = 0; i < N; i++)
+            e[i] = expr.self()[i];
+        return *this;
+    }
+
+    Vec(const CType& c) {
+        for (int i = 0; i < N; i++)
+            e[i] = c.e[i];
+    }
+    operator CType() const {
+        CType c;
+        for (int i = 0; i < N; i++)
+            c.e[i] = e[i];
+        return c;
+    }
+
+    constexpr T operator[](int i) const { return e[i]; }
+    XTD_VEC_CONSTEXPR T& operator[](int i) { return e[i]; }
+
+    template <typename Expr>
+    XTD_VEC_CONSTEXPR Vec& operator+=(const VecExpr<Expr>& b) {
+        for (int i = 0; i < N; i++)
+            e[i] += b.self()[i];
+        return *this;
+    }
+    template <typename Expr>
+    XTD_VEC_CONSTEXPR Vec& operator-=(const VecExpr<Expr>& b) {
+        for (int i = 0; i < N; i++)
+            e[i] -= b.self()[i];
+        return *this;
+    }
+    template <typename Expr>
+    XTD_VEC_CONSTEXPR Vec& operator*=(const VecExpr<Expr>& b) {
+        for (int i = 0; i < N; i++)
+            e[i] *= b.self()[i];
+        return *this;
+    }
+    template <typename Expr>
+    XTD_VEC_CONSTEXPR Vec& operator/=(const VecExpr<Expr>& b) {
+        for (int i = 0; i < N; i++)
+            e[i] /= b.self()[i];
+        return *this;
+    }
+    XTD_VEC_CONSTEXPR Vec& operator+=(T s) {
+        for (int i = 0; i < N; i++)
+            e[i] += s;
+        return *this;
+    }
+    XTD_VEC_CONSTEXPR Vec& operator-=(T s) {
+        for (int i = 0; i < N; i++)
+            e[i] -= s;
+        return *this;
+    }
+    XTD_VEC_CONSTEXPR Vec& operator*=(T s) {
+        for (int i = 0; i < N; i++)
+            e[i] *= s;
+        return *this;
+    }
+    XTD_VEC_CONSTEXPR Vec& operator/=(T s) {
+        for (int i = 0; i < N; i++)
+            e[i] /= s;
+        return *this;
+    }
+};
+
+typedef Vec<f32, 2> Vec2f;
+typedef Vec<f32, 3> Vec3f;
+typedef Vec<f32, 4> Vec4f;
+typedef Vec<f64, 2> Vec2d;
+typedef Vec<f64, 3> Vec3d;
+typedef Vec<f64, 4> Vec4d;
+typedef Vec<i32, 2> Vec2i;
+typedef Vec<i32, 3> Vec3i;
+typedef Vec<i32, 4> Vec4i;
+
+static_assert(sizeof(Vec2f) == sizeof(V2f) && sizeof(Vec3f) == sizeof(V3f) && sizeof(Vec4f) == sizeof(V4f), "Vec layout");
+static_assert(sizeof(Vec2i) == sizeof(V2i) && sizeof(Vec3i) == sizeof(V3i) && sizeof(Vec4i) == sizeof(V4i), "Vec layout");
+
+// Expression nodes
+
+template <typename T, int N>
+struct VecSplat : VecExpr<VecSplat<T, N> > {
+    typedef T Scalar;
+    static const int Size = N;
+    T s;
+    constexpr explicit VecSplat(T s_) : s(s_) {}
+    constexpr T operator[](int) const { return s; }
+};
+
+template <typename Op, typename A>
+struct VecUnary : VecExpr<VecUnary<Op, A> > {
+    typedef typename A::Scalar Scalar;
+    static const int Size = A::Size;
+    typename _xtd_VecOperand<A>::Type a;
+    constexpr explicit VecUnary(const A& a_) : a(a_) {}
+    constexpr Scalar operator[](int i) const { return Op::apply(a[i]); }
+};
+
+template <typename Op, typename A, typename B>
+struct VecBinary : VecExpr<VecBinary<Op, A, B> > {
+    typedef typename A::Scalar Scalar;
+    static const int Size = A::Size;
+    static_assert(A::Size == B::Size, "Vector size mismatch");
+    typename _xtd_VecOperand<A>::Type a;
+    typename _xtd_VecOperand<B>::Type b;
+    constexpr VecBinary(const A& a_, const B& b_) : a(a_), b(b_) {}
+    constexpr Scalar operator[](int i) const { return Op::apply(a[i], b[i]); }
+};
+
+struct _xtd_VecAdd { template <typename T> static constexpr T apply(T a, T b) { return a + b; } };
+struct _xtd_VecSub { template <typename T> static constexpr T apply(T a, T b) { return a - b; } };
+struct _xtd_VecMul { template <typename T> static constexpr T apply(T a, T b) { return a * b; } };
+struct _xtd_VecDiv { template <typename T> static constexpr T apply(T a, T b) { return a / b; } };
+struct _xtd_VecMin { template <typename T> static constexpr T apply(T a, T b) { return a < b ? a : b; } };
+struct _xtd_VecMax { template <typename T> static constexpr T apply(T a, T b) { return a > b ? a : b; } };
+struct _xtd_VecNeg { template <typename T> static constexpr T apply(T a) { return -a; } };
+struct _xtd_VecAbs { template <typename T> static constexpr T apply(T a) { return a < T(0) ? -a : a; } };
+
+// Operators and element wise functions, scalars can go on either side
+
+#define _XTD_VEC_BINARY(func, op) \
+    template <typename A, typename B> \
+    XTD_MATH_FORCE_INLINE constexpr VecBinary<op, A, B> func(const VecExpr<A>& a, const VecExpr<B>& b) { \
+        return VecBinary<op, A, B>(a.self(), b.self()); \
+    } \
+    template <typename A> \
+    XTD_MATH_FORCE_INLINE constexpr VecBinary<op, A, VecSplat<typename A::Scalar, A::Size> > func(const VecExpr<A>& a, typename A::Scalar s) { \
+        return VecBinary<op, A, VecSplat<typename A::Scalar, A::Size> >(a.self(), VecSplat<typename A::Scalar, A::Size>(s)); \
+    } \
+    template <typename B> \
+    XTD_MATH_FORCE_INLINE constexpr VecBinary<op, VecSplat<typename B::Scalar, B::Size>, B> func(typename B::Scalar s, const VecExpr<B>& b) { \
+        return VecBinary<op, VecSplat<typename B::Scalar, B::Size>, B>(VecSplat<typename B::Scalar, B::Size>(s), b.self()); \
+    }
+
+_XTD_VEC_BINARY(operator+, _xtd_VecAdd)
+_XTD_VEC_BINARY(operator-, _xtd_VecSub)
+_XTD_VEC_BINARY(operator*, _xtd_VecMul)
+_XTD_VEC_BINARY(operator/, _xtd_VecDiv)
+_XTD_VEC_BINARY(min, _xtd_VecMin)
+_XTD_VEC_BINARY(max, _xtd_VecMax)
+
+#undef _XTD_VEC_BINARY
+
+template <typename A>
+XTD_MATH_FORCE_INLINE constexpr VecUnary<_xtd_VecNeg, A> operator-(const VecExpr<A>& a) {
+    return VecUnary<_xtd_VecNeg, A>(a.self());
+}
+template <typename A>
+XTD_MATH_FORCE_INLINE constexpr VecUnary<_xtd_VecAbs, A> abs(const VecExpr<A>& a) {
+    return VecUnary<_xtd_VecAbs, A>(a.self());
+}
+
+template <typename A, typename B>
+XTD_MATH_FORCE_INLINE constexpr auto lerp(const VecExpr<A>& a, const VecExpr<B>& b, typename A::Scalar t)
+    -> decltype(a.self() + (b.self() - a.self()) * t) {
+    return a.self() + (b.self() - a.self()) * t;
+}
+
+template <typename A>
+XTD_MATH_FORCE_INLINE constexpr auto clamp(const VecExpr<A>& a, typename A::Scalar lo, typename A::Scalar hi)
+    -> decltype(min(max(a.self(), lo), hi)) {
+    return min(max(a.self(), lo), hi);
+}
+
+// Forces evaluation, e.g. to reuse a sub expression or to keep the result in an auto variable
+template <typename Expr>
+XTD_MATH_FORCE_INLINE XTD_VEC_CONSTEXPR Vec<typename Expr::Scalar, Expr::Size> eval(const VecExpr<Expr>& a) {
+    return Vec<typename Expr::Scalar, Expr::Size>(a);
+}
+
+// Reductions and functions that mix components are evaluated on the spot
+
+template <typename A, typename B>
+XTD_MATH_FORCE_INLINE XTD_VEC_CONSTEXPR typename A::Scalar dot(const VecExpr<A>& a, const VecExpr<B>& b) {
+    static_assert(A::Size == B::Size, "Vector size mismatch");
+    typename A::Scalar res = a.self()[0] * b.self()[0];
+    for (int i = 1; i < A::Size; i++)
+        res += a.self()[i] * b.self()[i];
+    return res;
+}
+
+template <typename A>
+XTD_MATH_FORCE_INLINE XTD_VEC_CONSTEXPR typename A::Scalar lengthSq(const VecExpr<A>& a) {
+    return dot(a, a);
+}
+
+XTD_MATH_FORCE_INLINE f32 _xtd_VecSqrt(f32 a) { return sqrtf(a); }
+XTD_MATH_FORCE_INLINE f64 _xtd_VecSqrt(f64 a) { return sqrt(a); }
+template <typename T>
+XTD_MATH_FORCE_INLINE T _xtd_VecSqrt(T a) { return (T)sqrt((f64)a); }
+
+template <typename A>
+XTD_MATH_FORCE_INLINE typename A::Scalar length(const VecExpr<A>& a) {
+    return _xtd_VecSqrt(lengthSq(a));
+}
+
+template <typename A>
+XTD_MATH_FORCE_INLINE Vec<typename A::Scalar, A::Size> normalized(const VecExpr<A>& a) {
+    Vec<typename A::Scalar, A::Size> v = a;
+    typename A::Scalar inv_len = typename A::Scalar(1) / length(v);
+    return v * inv_len;
+}
+
+template <typename A, typename B>
+XTD_MATH_FORCE_INLINE XTD_VEC_CONSTEXPR Vec<typename A::Scalar, 3> cross(const VecExpr<A>& a, const VecExpr<B>& b) {
+    static_assert(A::Size == 3 && B::Size == 3, "cross needs 3 component vectors");
+    return Vec<typename A::Scalar, 3>(
+        a.self()[1] * b.self()[2] - a.self()[2] * b.self()[1],
+        a.self()[2] * b.self()[0] - a.self()[0] * b.self()[2],
+        a.self()[0] * b.self()[1] - a.self()[1] * b.self()[0]);
+}
+
+template <typename A, typename B>
+XTD_MATH_FORCE_INLINE XTD_VEC_CONSTEXPR bool operator==(const VecExpr<A>& a, const VecExpr<B>& b) {
+    static_assert(A::Size == B::Size, "Vector size mismatch");
+    for (int i = 0; i < A::Size; i++)
+        if (a.self()[i] != b.self()[i])
+            return false;
+    return true;
+}
+template <typename A, typename B>
+XTD_MATH_FORCE_INLINE XTD_VEC_CONSTEXPR bool operator!=(const VecExpr<A>& a, const VecExpr<B>& b) {
+    return !(a == b);
+}
+
+} // namespace xtd
+}
+
+#endif // XTD_MATH_VEC_TEMPLATE
+
 ////////////////////////////////////////
 //
 //  Function Declarations
@@ -788,6 +2750,52 @@ XTD_MATH_FUNC_DECL void XTD_fprint4f(void* file, V4f a);
 XTD_MATH_FUNC_DECL void XTD_fprint3f(void* file, V3f a);
 XTD_MATH_FUNC_DECL void XTD_fprint2f(void* file, V2f a);
 
+// Bulk vector serialization
+//
+// Text format is one vector per line, "[x,y,z]\n", the same layout XTD_fprint*f uses.
+// Floats are formatted with a fixed number of decimals (0-9) without printf or locale.
+// Values too large for fixed notation are written in scientific notation ("1.23456789e+30").
+
+#define XTD_TEXT_F32_MAX_CHARS 24
+#define XTD_TEXT_VEC_MAX_CHARS(components) ((components) * (XTD_TEXT_F32_MAX_CHARS + 1) + 2)
+
+// Binary format is a 16 byte header (magic "XTDV", u32 components, u64 count)
+// followed by count * components little-endian f32 values.
+
+#define XTD_VEC_BINARY_MAGIC 0x56445458 // "XTDV"
+#define XTD_VEC_BINARY_HEADER_SIZE 16
+#define XTD_VEC_BINARY_SIZE(components, count) (XTD_VEC_BINARY_HEADER_SIZE + (usize)(count) * (components) * sizeof(f32))
+
+XTD_MATH_FUNC_DECL usize XTD_FormatF32(char* out, f32 x, i32 precision);
+XTD_MATH_FUNC_DECL usize XTD_ParseF32(const char* text, usize text_len, f32* out);
+
+XTD_MATH_FUNC_DECL usize XTD_Format4fArray(char* out, const V4f* items, usize count, i32 precision);
+XTD_MATH_FUNC_DECL usize XTD_Format3fArray(char* out, const V3f* items, usize count, i32 precision);
+XTD_MATH_FUNC_DECL usize XTD_Format2fArray(char* out, const V2f* items, usize count, i32 precision);
+
+XTD_MATH_FUNC_DECL usize XTD_Parse4fArray(const char* text, usize text_len, V4f* out, usize max_count);
+XTD_MATH_FUNC_DECL usize XTD_Parse3fArray(const char* text, usize text_len, V3f* out, usize max_count);
+XTD_MATH_FUNC_DECL usize XTD_Parse2fArray(const char* text, usize text_len, V2f* out, usize max_count);
+
+XTD_MATH_FUNC_DECL void XTD_fprint4fArray(void* file, const V4f* items, usize count);
+XTD_MATH_FUNC_DECL void XTD_fprint3fArray(void* file, const V3f* items, usize count);
+XTD_MATH_FUNC_DECL void XTD_fprint2fArray(void* file, const V2f* items, usize count);
+
+XTD_MATH_FUNC_DECL usize XTD_Write4fArrayBinary(void* out, const V4f* items, usize count);
+XTD_MATH_FUNC_DECL usize XTD_Write3fArrayBinary(void* out, const V3f* items, usize count);
+XTD_MATH_FUNC_DECL usize XTD_Write2fArrayBinary(void* out, const V2f* items, usize count);
+
+// Pass out = NULL to query the number of vectors stored in the buffer
+XTD_MATH_FUNC_DECL usize XTD_Read4fArrayBinary(const void* in, usize in_size, V4f* out, usize max_count);
+XTD_MATH_FUNC_DECL usize XTD_Read3fArrayBinary(const void* in, usize in_size, V3f* out, usize max_count);
+XTD_MATH_FUNC_DECL usize XTD_Read2fArrayBinary(const void* in, usize in_size, V2f* out, usize max_count);
+
+// Bulk f32 <-> f16 conversion, 8 values at a time with F16C.
+// V4f/V3f arrays can be converted as (f32*)items with count * 4 or count * 3 values
+// into V4h/V3h arrays, which have no padding either.
+XTD_MATH_FUNC_DECL void XTD_F32ToF16Array(f16* out, const f32* in, usize count);
+XTD_MATH_FUNC_DECL void XTD_F16ToF32Array(f32* out, const f16* in, usize count);
+
 
 ////////////////////////////////////////
 ////////////////////////////////////////
@@ -818,6 +2826,483 @@ XTD_MATH_FUNC void XTD_fprint2f(void* file, V2f a)
     XTD_FPRINTF(file, "[%.4f,%.4f]", a.x, a.y);
 }
 
+//
+// Bulk vector serialization
+//
+
+#include <string.h>
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    #define _XTD_MATH_BIG_ENDIAN 1
+#else
+    #define _XTD_MATH_BIG_ENDIAN 0
+#endif
+
+static const f64 _xtd_pow10_table[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+    1e20, 1e21, 1e22, 1e23, 1e24, 1e25, 1e26, 1e27, 1e28, 1e29,
+    1e30, 1e31, 1e32, 1e33, 1e34, 1e35, 1e36, 1e37, 1e38, 1e39,
+    1e40, 1e41, 1e42, 1e43, 1e44, 1e45, 1e46, 1e47, 1e48, 1e49,
+    1e50, 1e51, 1e52, 1e53, 1e54, 1e55, 1e56, 1e57, 1e58, 1e59,
+    1e60, 1e61, 1e62, 1e63, 1e64,
+};
+#define _XTD_POW10_MAX ((i32)XTD_ARRAYCOUNT(_xtd_pow10_table) - 1)
+
+static const char _xtd_digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Writes exactly 'digits' decimal digits of v, zero padded
+static char* _xtd_WriteDigits(char* out, u64 v, i32 digits)
+{
+    char* p = out + digits;
+    while (p - out >= 2)
+    {
+        p -= 2;
+        memcpy(p, _xtd_digit_pairs + (v % 100) * 2, 2);
+        v /= 100;
+    }
+    if (p != out)
+        *out = (char)('0' + v % 10);
+    return out + digits;
+}
+
+static char* _xtd_WriteU64(char* out, u64 v)
+{
+    i32 digits = 1;
+    for (u64 t = v; t >= 10; t /= 10)
+        digits++;
+    return _xtd_WriteDigits(out, v, digits);
+}
+
+XTD_MATH_FUNC usize XTD_FormatF32(char* out, f32 x, i32 precision)
+{
+    union {
+        u32 u;
+        f32 f;
+    } bits;
+    bits.f = x;
+    char* p = out;
+    precision = XTD_CLAMP(precision, 0, 9);
+
+    if (bits.u & 0x80000000)
+        *p++ = '-';
+
+    if (((bits.u >> 23) & 0xFF) == 0xFF)
+    {
+        memcpy(p, (bits.u & 0x7FFFFF) ? "nan" : "inf", 3);
+        return (usize)(p + 3 - out);
+    }
+
+    f64 v = absF32(x);
+    f64 scaled = v * _xtd_pow10_table[precision];
+    if (scaled < 1e19)
+    {
+        // Round half to even like printf does
+        u64 q = (u64)scaled;
+        f64 frac = scaled - (f64)q;
+        if (frac > 0.5 || (frac == 0.5 && (q & 1)))
+            q++;
+
+        u64 unit = (u64)_xtd_pow10_table[precision];
+        p = _xtd_WriteU64(p, q / unit);
+        if (precision > 0)
+        {
+            *p++ = '.';
+            p = _xtd_WriteDigits(p, q % unit, precision);
+        }
+    } else
+    {
+        // Scientific notation with 9 significant digits, enough to round-trip any f32
+        i32 e = (i32)floor(log10(v));
+        u64 q = (u64)(v / _xtd_pow10_table[e - 8] + 0.5);
+        if (q >= 1000000000)
+        {
+            e++;
+            q = (u64)(v / _xtd_pow10_table[e - 8] + 0.5);
+        } else if (q < 100000000)
+        {
+            e--;
+            q = (u64)(v / _xtd_pow10_table[e - 8] + 0.5);
+        }
+        *p++ = (char)('0' + q / 100000000);
+        *p++ = '.';
+        p = _xtd_WriteDigits(p, q % 100000000, 8);
+        *p++ = 'e';
+        *p++ = '+';
+        p = _xtd_WriteDigits(p, (u64)e, 2);
+    }
+
+    return (usize)(p - out);
+}
+
+XTD_MATH_FUNC usize XTD_ParseF32(const char* text, usize text_len, f32* out)
+{
+    usize i = 0;
+    bool negative = false;
+    if (i < text_len && (text[i] == '-' || text[i] == '+'))
+    {
+        negative = text[i] == '-';
+        i++;
+    }
+
+    if (text_len - i >= 3 && (text[i] | 0x20) == 'n' && (text[i + 1] | 0x20) == 'a' && (text[i + 2] | 0x20) == 'n')
+    {
+        *out = negative ? -NAN : NAN;
+        return i + 3;
+    }
+    if (text_len - i >= 3 && (text[i] | 0x20) == 'i' && (text[i + 1] | 0x20) == 'n' && (text[i + 2] | 0x20) == 'f')
+    {
+        *out = negative ? -INFINITY : INFINITY;
+        return i + 3;
+    }
+
+    // Keep up to 19 significant digits, which always fit a u64
+    u64 mantissa = 0;
+    i32 significant = 0;
+    i32 exp10 = 0;
+    bool any_digit = false;
+
+    while (i < text_len && XTD_INRANGE(text[i], '0', '9' + 1))
+    {
+        any_digit = true;
+        if (significant < 19)
+        {
+            mantissa = mantissa * 10 + (u64)(text[i] - '0');
+            if (mantissa)
+                significant++;
+        } else
+        {
+            exp10++;
+        }
+        i++;
+    }
+
+    if (i < text_len && text[i] == '.')
+    {
+        i++;
+        while (i < text_len && XTD_INRANGE(text[i], '0', '9' + 1))
+        {
+            any_digit = true;
+            if (significant < 19)
+            {
+                mantissa = mantissa * 10 + (u64)(text[i] - '0');
+                if (mantissa)
+                    significant++;
+                exp10--;
+            }
+            i++;
+        }
+    }
+
+    if (!any_digit)
+        return 0;
+
+    if (i < text_len && (text[i] | 0x20) == 'e')
+    {
+        usize j = i + 1;
+        bool exp_negative = false;
+        if (j < text_len && (text[j] == '-' || text[j] == '+'))
+        {
+            exp_negative = text[j] == '-';
+            j++;
+        }
+        if (j < text_len && XTD_INRANGE(text[j], '0', '9' + 1))
+        {
+            i32 e = 0;
+            while (j < text_len && XTD_INRANGE(text[j], '0', '9' + 1))
+            {
+                if (e < 10000)
+                    e = e * 10 + (text[j] - '0');
+                j++;
+            }
+            exp10 += exp_negative ? -e : e;
+            i = j;
+        }
+    }
+
+    f64 v = (f64)mantissa;
+    if (mantissa != 0)
+    {
+        if (exp10 > _XTD_POW10_MAX)
+        {
+            v = INFINITY;
+        } else if (exp10 > 0)
+        {
+            v *= _xtd_pow10_table[exp10];
+        } else if (exp10 < -2 * _XTD_POW10_MAX)
+        {
+            v = 0.0;
+        } else if (exp10 < -_XTD_POW10_MAX)
+        {
+            v /= _xtd_pow10_table[_XTD_POW10_MAX];
+            v /= _xtd_pow10_table[-exp10 - _XTD_POW10_MAX];
+        } else if (exp10 < 0)
+        {
+            v /= _xtd_pow10_table[-exp10];
+        }
+    }
+
+    *out = (f32)(negative ? -v : v);
+    return i;
+}
+
+static usize _xtd_FormatVecArray(char* out, const f32* data, usize count, i32 components, i32 precision)
+{
+    char* p = out;
+    for (usize i = 0; i < count; i++)
+    {
+        *p++ = '[';
+        for (i32 c = 0; c < components; c++)
+        {
+            p += XTD_FormatF32(p, data[c], precision);
+            *p++ = ',';
+        }
+        p[-1] = ']';
+        *p++ = '\n';
+        data += components;
+    }
+    return (usize)(p - out);
+}
+
+static usize _xtd_SkipSpace(const char* text, usize text_len, usize i)
+{
+    while (i < text_len && (text[i] == ' ' || text[i] == '\t' || text[i] == '\n' || text[i] == '\r'))
+        i++;
+    return i;
+}
+
+static usize _xtd_ParseVecArray(const char* text, usize text_len, f32* out, usize max_count, i32 components)
+{
+    usize i = 0;
+    usize n = 0;
+    while (n < max_count)
+    {
+        i = _xtd_SkipSpace(text, text_len, i);
+        if (i >= text_len || text[i] != '[')
+            break;
+        i++;
+
+        for (i32 c = 0; c < components; c++)
+        {
+            i = _xtd_SkipSpace(text, text_len, i);
+            usize consumed = XTD_ParseF32(text + i, text_len - i, out + c);
+            if (consumed == 0)
+                return n;
+            i = _xtd_SkipSpace(text, text_len, i + consumed);
+            if (i >= text_len || text[i] != (c == components - 1 ? ']' : ','))
+                return n;
+            i++;
+        }
+
+        out += components;
+        n++;
+    }
+    return n;
+}
+
+static void _xtd_fprintVecArray(void* file, const f32* data, usize count, i32 components)
+{
+    char buffer[4096];
+    usize used = 0;
+    for (usize i = 0; i < count; i++)
+    {
+        if (sizeof(buffer) - used < XTD_TEXT_VEC_MAX_CHARS(4))
+        {
+            fwrite(buffer, 1, used, (FILE*)file);
+            used = 0;
+        }
+        used += _xtd_FormatVecArray(buffer + used, data + i * components, 1, components, 4);
+    }
+    fwrite(buffer, 1, used, (FILE*)file);
+}
+
+static void _xtd_StoreU32LE(u8* p, u32 v)
+{
+    p[0] = (u8)v;
+    p[1] = (u8)(v >> 8);
+    p[2] = (u8)(v >> 16);
+    p[3] = (u8)(v >> 24);
+}
+
+static u32 _xtd_LoadU32LE(const u8* p)
+{
+    return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+}
+
+// Copies f32 values between host order and little-endian order (the same operation both ways)
+static void _xtd_CopyF32LE(void* dst, const void* src, usize n)
+{
+#if _XTD_MATH_BIG_ENDIAN
+    const u8* s = (const u8*)src;
+    u8* d = (u8*)dst;
+    for (usize i = 0; i < n; i++, s += 4, d += 4)
+    {
+        d[0] = s[3];
+        d[1] = s[2];
+        d[2] = s[1];
+        d[3] = s[0];
+    }
+#else
+    memcpy(dst, src, n * sizeof(f32));
+#endif
+}
+
+static usize _xtd_WriteVecArrayBinary(void* out, const f32* data, usize count, i32 components)
+{
+    u8* p = (u8*)out;
+    _xtd_StoreU32LE(p, XTD_VEC_BINARY_MAGIC);
+    _xtd_StoreU32LE(p + 4, (u32)components);
+    _xtd_StoreU32LE(p + 8, (u32)((u64)count));
+    _xtd_StoreU32LE(p + 12, (u32)((u64)count >> 32));
+    _xtd_CopyF32LE(p + XTD_VEC_BINARY_HEADER_SIZE, data, count * components);
+    return XTD_VEC_BINARY_SIZE(components, count);
+}
+
+static usize _xtd_ReadVecArrayBinary(const void* in, usize in_size, f32* out, usize max_count, i32 components)
+{
+    const u8* p = (const u8*)in;
+    if (in_size < XTD_VEC_BINARY_HEADER_SIZE)
+        return 0;
+    if (_xtd_LoadU32LE(p) != XTD_VEC_BINARY_MAGIC || _xtd_LoadU32LE(p + 4) != (u32)components)
+        return 0;
+
+    u64 count = (u64)_xtd_LoadU32LE(p + 8) | ((u64)_xtd_LoadU32LE(p + 12) << 32);
+    usize available = (in_size - XTD_VEC_BINARY_HEADER_SIZE) / (components * sizeof(f32));
+    count = XTD_MIN(count, (u64)available);
+    if (out == NULL)
+        return (usize)count;
+
+    count = XTD_MIN(count, (u64)max_count);
+    _xtd_CopyF32LE(out, p + XTD_VEC_BINARY_HEADER_SIZE, (usize)count * components);
+    return (usize)count;
+}
+
+XTD_MATH_FUNC usize XTD_Format4fArray(char* out, const V4f* items, usize count, i32 precision)
+{
+    return _xtd_FormatVecArray(out, (const f32*)items, count, 4, precision);
+}
+
+XTD_MATH_FUNC usize XTD_Format3fArray(char* out, const V3f* items, usize count, i32 precision)
+{
+    return _xtd_FormatVecArray(out, (const f32*)items, count, 3, precision);
+}
+
+XTD_MATH_FUNC usize XTD_Format2fArray(char* out, const V2f* items, usize count, i32 precision)
+{
+    return _xtd_FormatVecArray(out, (const f32*)items, count, 2, precision);
+}
+
+XTD_MATH_FUNC usize XTD_Parse4fArray(const char* text, usize text_len, V4f* out, usize max_count)
+{
+    return _xtd_ParseVecArray(text, text_len, (f32*)out, max_count, 4);
+}
+
+XTD_MATH_FUNC usize XTD_Parse3fArray(const char* text, usize text_len, V3f* out, usize max_count)
+{
+    return _xtd_ParseVecArray(text, text_len, (f32*)out, max_count, 3);
+}
+
+XTD_MATH_FUNC usize XTD_Parse2fArray(const char* text, usize text_len, V2f* out, usize max_count)
+{
+    return _xtd_ParseVecArray(text, text_len, (f32*)out, max_count, 2);
+}
+
+XTD_MATH_FUNC void XTD_fprint4fArray(void* file, const V4f* items, usize count)
+{
+    _xtd_fprintVecArray(file, (const f32*)items, count, 4);
+}
+
+XTD_MATH_FUNC void XTD_fprint3fArray(void* file, const V3f* items, usize count)
+{
+    _xtd_fprintVecArray(file, (const f32*)items, count, 3);
+}
+
+XTD_MATH_FUNC void XTD_fprint2fArray(void* file, const V2f* items, usize count)
+{
+    _xtd_fprintVecArray(file, (const f32*)items, count, 2);
+}
+
+XTD_MATH_FUNC usize XTD_Write4fArrayBinary(void* out, const V4f* items, usize count)
+{
+    return _xtd_WriteVecArrayBinary(out, (const f32*)items, count, 4);
+}
+
+XTD_MATH_FUNC usize XTD_Write3fArrayBinary(void* out, const V3f* items, usize count)
+{
+    return _xtd_WriteVecArrayBinary(out, (const f32*)items, count, 3);
+}
+
+XTD_MATH_FUNC usize XTD_Write2fArrayBinary(void* out, const V2f* items, usize count)
+{
+    return _xtd_WriteVecArrayBinary(out, (const f32*)items, count, 2);
+}
+
+XTD_MATH_FUNC usize XTD_Read4fArrayBinary(const void* in, usize in_size, V4f* out, usize max_count)
+{
+    return _xtd_ReadVecArrayBinary(in, in_size, (f32*)out, max_count, 4);
+}
+
+XTD_MATH_FUNC usize XTD_Read3fArrayBinary(const void* in, usize in_size, V3f* out, usize max_count)
+{
+    return _xtd_ReadVecArrayBinary(in, in_size, (f32*)out, max_count, 3);
+}
+
+XTD_MATH_FUNC usize XTD_Read2fArrayBinary(const void* in, usize in_size, V2f* out, usize max_count)
+{
+    return _xtd_ReadVecArrayBinary(in, in_size, (f32*)out, max_count, 2);
+}
+
+//
+// Half precision arrays
+//
+
+// The F16C loops return how many values they converted, the rest use the scalar conversion
+
+#if XTD_HAS_F16C || XTD_HAS_CPU_DISPATCH
+
+static XTD_TARGET_F16C usize _xtd_F32ToF16ArrayF16C(f16* out, const f32* in, usize count)
+{
+    usize i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm_storeu_si128((__m128i*)(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+    return i;
+}
+
+static XTD_TARGET_F16C usize _xtd_F16ToF32ArrayF16C(f32* out, const f16* in, usize count)
+{
+    usize i = 0;
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in + i))));
+    return i;
+}
+
+#endif
+
+XTD_MATH_FUNC void XTD_F32ToF16Array(f16* out, const f32* in, usize count)
+{
+    usize i = 0;
+#if XTD_HAS_F16C || XTD_HAS_CPU_DISPATCH
+    if (XTD_GetCPUFeatures() & XTD_CPU_F16C)
+        i = _xtd_F32ToF16ArrayF16C(out, in, count);
+#endif
+    for (; i < count; i++)
+        out[i] = fromF32F16(in[i]);
+}
+
+XTD_MATH_FUNC void XTD_F16ToF32Array(f32* out, const f16* in, usize count)
+{
+    usize i = 0;
+#if XTD_HAS_F16C || XTD_HAS_CPU_DISPATCH
+    if (XTD_GetCPUFeatures() & XTD_CPU_F16C)
+        i = _xtd_F16ToF32ArrayF16C(out, in, count);
+#endif
+    for (; i < count; i++)
+        out[i] = toF32F16(in[i]);
+}
+
 #endif
 
 ////////////////////////////////////////
@@ -0,0 +1,910 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Noise module: gradient (Perlin) and simplex noise in 2D, 3D and 4D with fBm and ridged fractals
+// #define XTD_NOISE_IMPLEMENTATION to include the implementation
+
+#ifndef XTD_NOISE_HEADER_H
+#define XTD_NOISE_HEADER_H
+
+#ifndef XTD_NOISE_FUNC
+#define XTD_NOISE_FUNC
+#endif
+
+#ifndef XTD_NOISE_FUNC_DECL
+#define XTD_NOISE_FUNC_DECL extern
+#endif
+
+#include "xtd_common.h"
+#include "xtd_math.h"
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  Types
+//
+
+// Lattice gradients come from hashing the lattice coordinates with the seed, there are no
+// permutation tables, so any u32 is a valid seed and the SIMD paths need no gathers.
+
+typedef enum {
+    XTD_NOISE_PERLIN,
+    XTD_NOISE_SIMPLEX,
+} XTD_NoiseType;
+
+typedef enum {
+    XTD_NOISE_SINGLE, // One octave
+    XTD_NOISE_FBM,    // Sum of octaves
+    XTD_NOISE_RIDGED, // Sum of (1 - |noise|)^2 octaves, sharp ridges where the noise crosses zero
+} XTD_NoiseFractal;
+
+// Octave i samples at frequency * lacunarity^i with amplitude gain^i and seed + i.
+// The sum is divided by the total amplitude so every combination stays in [-1, 1].
+typedef struct {
+    XTD_NoiseType type;
+    XTD_NoiseFractal fractal;
+    u32 seed;
+    i32 octaves;
+    f32 frequency;
+    f32 lacunarity;
+    f32 gain;
+} XTD_NoiseParams;
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+// Single octave noise with unit frequency, result in [-1, 1]
+XTD_NOISE_FUNC_DECL f32 XTD_Perlin2D(f32 x, f32 y, u32 seed);
+XTD_NOISE_FUNC_DECL f32 XTD_Perlin3D(f32 x, f32 y, f32 z, u32 seed);
+XTD_NOISE_FUNC_DECL f32 XTD_Perlin4D(f32 x, f32 y, f32 z, f32 w, u32 seed);
+XTD_NOISE_FUNC_DECL f32 XTD_Simplex2D(f32 x, f32 y, u32 seed);
+XTD_NOISE_FUNC_DECL f32 XTD_Simplex3D(f32 x, f32 y, f32 z, u32 seed);
+XTD_NOISE_FUNC_DECL f32 XTD_Simplex4D(f32 x, f32 y, f32 z, f32 w, u32 seed);
+
+// 5 fBm octaves at unit frequency, lacunarity 2 and gain 0.5
+XTD_NOISE_FUNC_DECL XTD_NoiseParams XTD_NoiseDefaultParams(XTD_NoiseType type, u32 seed);
+
+XTD_NOISE_FUNC_DECL f32 XTD_Noise2D(const XTD_NoiseParams* params, V2f p);
+XTD_NOISE_FUNC_DECL f32 XTD_Noise3D(const XTD_NoiseParams* params, V3f p);
+XTD_NOISE_FUNC_DECL f32 XTD_Noise4D(const XTD_NoiseParams* params, V4f p);
+
+// out[i] = XTD_NoiseND(params, {x[i], y[i], ...}), evaluated 8 points at a time with AVX2.
+// Results are bit-identical to the single point functions unless the compiler fuses the scalar
+// multiply-adds into FMAs (GCC and Clang do with -march flags that enable FMA), then they differ in the last bits.
+XTD_NOISE_FUNC_DECL void XTD_NoiseBatch2D(const XTD_NoiseParams* params, f32* out, const f32* x, const f32* y, usize count);
+XTD_NOISE_FUNC_DECL void XTD_NoiseBatch3D(const XTD_NoiseParams* params, f32* out, const f32* x, const f32* y, const f32* z, usize count);
+XTD_NOISE_FUNC_DECL void XTD_NoiseBatch4D(const XTD_NoiseParams* params, f32* out, const f32* x, const f32* y, const f32* z, const f32* w, usize count);
+
+// Sample (x, y) = origin + (i, j) * step for every pixel of a width x height grid.
+// stride is the distance between rows in bytes.
+XTD_NOISE_FUNC_DECL void XTD_NoiseFillGrid2D(const XTD_NoiseParams* params, f32* out, i32 width, i32 height, usize stride, V2f origin, V2f step);
+// Volume version, out holds depth slices of height rows of width samples with no padding
+XTD_NOISE_FUNC_DECL void XTD_NoiseFillGrid3D(const XTD_NoiseParams* params, f32* out, i32 width, i32 height, i32 depth, V3f origin, V3f step);
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_NOISE_IMPLEMENTATION
+
+#define _XTD_NOISE_PRIME_X 501125321u
+#define _XTD_NOISE_PRIME_Y 1136930381u
+#define _XTD_NOISE_PRIME_Z 1720413743u
+#define _XTD_NOISE_PRIME_W 1066037191u
+#define _XTD_NOISE_HASH_MUL 0x27d4eb2du
+
+// Skew and unskew factors, (sqrt(n + 1) - 1) / n and (n + 1 - sqrt(n + 1)) / (n * (n + 1))
+#define _XTD_SIMPLEX_F2 0.366025403f
+#define _XTD_SIMPLEX_G2 0.211324865f
+#define _XTD_SIMPLEX_F3 0.333333333f
+#define _XTD_SIMPLEX_G3 0.166666667f
+#define _XTD_SIMPLEX_F4 0.309016994f
+#define _XTD_SIMPLEX_G4 0.138196601f
+
+// Bring the raw sums to [-1, 1]. The bound is the maximum over the cell of the corner weights times
+// the best gradient at each corner (|a| + 2|b| in 2D, the two or three largest |d| in 3D and 4D):
+// Perlin 1.511171, 1.036354, 1.536582 and simplex 0.02210892, 0.01300716, 0.01592922.
+// The scales are rounded down so float rounding can't leave the range.
+#define _XTD_PERLIN2_SCALE 0.6617f
+#define _XTD_PERLIN3_SCALE 0.9649f
+#define _XTD_PERLIN4_SCALE 0.6507f
+#define _XTD_SIMPLEX2_SCALE 45.230f
+#define _XTD_SIMPLEX3_SCALE 76.880f
+#define _XTD_SIMPLEX4_SCALE 62.777f
+
+#define _XTD_NOISE_MAX_DIMS 4
+
+////////////////////////////////////////
+//
+//  Scalar noise
+//
+
+// Lattice coordinates are premultiplied by their prime so neighbours only need an add
+XTD_FORCE_INLINE u32 _xtd_NoiseHash(u32 h)
+{
+    h *= _XTD_NOISE_HASH_MUL;
+    return h ^ (h >> 15);
+}
+
+XTD_FORCE_INLINE f32 _xtd_NoiseFlip(f32 v, u32 h, u32 bit)
+{
+    return (h & (1u << bit)) ? -v : v;
+}
+
+// Gradient selection from Perlin's improved noise and Gustavson's simplex notes:
+// 8 directions in 2D, the 12 cube edges (padded to 16) in 3D and the 32 hypercube edges in 4D
+XTD_FORCE_INLINE f32 _xtd_Grad2(u32 h, f32 x, f32 y)
+{
+    h &= 7;
+    f32 u = h < 4 ? x : y;
+    f32 v = h < 4 ? y : x;
+    return _xtd_NoiseFlip(u, h, 0) + _xtd_NoiseFlip(2.0f * v, h, 1);
+}
+
+XTD_FORCE_INLINE f32 _xtd_Grad3(u32 h, f32 x, f32 y, f32 z)
+{
+    h &= 15;
+    f32 u = h < 8 ? x : y;
+    f32 v = h < 4 ? y : ((h == 12 || h == 14) ? x : z);
+    return _xtd_NoiseFlip(u, h, 0) + _xtd_NoiseFlip(v, h, 1);
+}
+
+XTD_FORCE_INLINE f32 _xtd_Grad4(u32 h, f32 x, f32 y, f32 z, f32 w)
+{
+    h &= 31;
+    f32 u = h < 24 ? x : y;
+    f32 v = h < 16 ? y : z;
+    f32 t = h < 8 ? z : w;
+    return _xtd_NoiseFlip(u, h, 0) + _xtd_NoiseFlip(v, h, 1) + _xtd_NoiseFlip(t, h, 2);
+}
+
+XTD_FORCE_INLINE f32 _xtd_NoiseFade(f32 t)
+{
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+// Simplex corner falloff, (0.5 - r^2)^4 clamped at 0
+XTD_FORCE_INLINE f32 _xtd_SimplexFalloff(f32 r2)
+{
+    f32 t = XTD_MAX(0.5f - r2, 0.0f);
+    t *= t;
+    return t * t;
+}
+
+XTD_NOISE_FUNC f32 XTD_Perlin2D(f32 x, f32 y, u32 seed)
+{
+    f32 fx = floorf(x), fy = floorf(y);
+    f32 dx = x - fx, dy = y - fy;
+    u32 x0 = (u32)(i32)fx * _XTD_NOISE_PRIME_X, x1 = x0 + _XTD_NOISE_PRIME_X;
+    u32 y0 = (u32)(i32)fy * _XTD_NOISE_PRIME_Y, y1 = y0 + _XTD_NOISE_PRIME_Y;
+    f32 u = _xtd_NoiseFade(dx), v = _xtd_NoiseFade(dy);
+
+    f32 n00 = _xtd_Grad2(_xtd_NoiseHash(seed ^ x0 ^ y0), dx, dy);
+    f32 n10 = _xtd_Grad2(_xtd_NoiseHash(seed ^ x1 ^ y0), dx - 1.0f, dy);
+    f32 n01 = _xtd_Grad2(_xtd_NoiseHash(seed ^ x0 ^ y1), dx, dy - 1.0f);
+    f32 n11 = _xtd_Grad2(_xtd_NoiseHash(seed ^ x1 ^ y1), dx - 1.0f, dy - 1.0f);
+    f32 nx0 = lerpF32(n00, n10, u);
+    f32 nx1 = lerpF32(n01, n11, u);
+    return lerpF32(nx0, nx1, v) * _XTD_PERLIN2_SCALE;
+}
+
+XTD_NOISE_FUNC f32 XTD_Perlin3D(f32 x, f32 y, f32 z, u32 seed)
+{
+    f32 fx = floorf(x), fy = floorf(y), fz = floorf(z);
+    f32 dx = x - fx, dy = y - fy, dz = z - fz;
+    u32 x0 = (u32)(i32)fx * _XTD_NOISE_PRIME_X, x1 = x0 + _XTD_NOISE_PRIME_X;
+    u32 y0 = (u32)(i32)fy * _XTD_NOISE_PRIME_Y, y1 = y0 + _XTD_NOISE_PRIME_Y;
+    u32 z0 = (u32)(i32)fz * _XTD_NOISE_PRIME_Z, z1 = z0 + _XTD_NOISE_PRIME_Z;
+    f32 u = _xtd_NoiseFade(dx), v = _xtd_NoiseFade(dy), w = _xtd_NoiseFade(dz);
+
+    f32 n000 = _xtd_Grad3(_xtd_NoiseHash(seed ^ x0 ^ y0 ^ z0), dx, dy, dz);
+    f32 n100 = _xtd_Grad3(_xtd_NoiseHash(seed ^ x1 ^ y0 ^ z0), dx - 1.0f, dy, dz);
+    f32 n010 = _xtd_Grad3(_xtd_NoiseHash(seed ^ x0 ^ y1 ^ z0), dx, dy - 1.0f, dz);
+    f32 n110 = _xtd_Grad3(_xtd_NoiseHash(seed ^ x1 ^ y1 ^ z0), dx - 1.0f, dy - 1.0f, dz);
+    f32 n001 = _xtd_Grad3(_xtd_NoiseHash(seed ^ x0 ^ y0 ^ z1), dx, dy, dz - 1.0f);
+    f32 n101 = _xtd_Grad3(_xtd_NoiseHash(seed ^ x1 ^ y0 ^ z1), dx - 1.0f, dy, dz - 1.0f);
+    f32 n011 = _xtd_Grad3(_xtd_NoiseHash(seed ^ x0 ^ y1 ^ z1), dx, dy - 1.0f, dz - 1.0f);
+    f32 n111 = _xtd_Grad3(_xtd_NoiseHash(seed ^ x1 ^ y1 ^ z1), dx - 1.0f, dy - 1.0f, dz - 1.0f);
+    f32 nx00 = lerpF32(n000, n100, u);
+    f32 nx10 = lerpF32(n010, n110, u);
+    f32 nx01 = lerpF32(n001, n101, u);
+    f32 nx11 = lerpF32(n011, n111, u);
+    f32 nxy0 = lerpF32(nx00, nx10, v);
+    f32 nxy1 = lerpF32(nx01, nx11, v);
+    return lerpF32(nxy0, nxy1, w) * _XTD_PERLIN3_SCALE;
+}
+
+XTD_NOISE_FUNC f32 XTD_Perlin4D(f32 x, f32 y, f32 z, f32 w, u32 seed)
+{
+    f32 fx = floorf(x), fy = floorf(y), fz = floorf(z), fw = floorf(w);
+    f32 d[4] = {x - fx, y - fy, z - fz, w - fw};
+    u32 lattice[4][2];
+    lattice[0][0] = (u32)(i32)fx * _XTD_NOISE_PRIME_X;
+    lattice[1][0] = (u32)(i32)fy * _XTD_NOISE_PRIME_Y;
+    lattice[2][0] = (u32)(i32)fz * _XTD_NOISE_PRIME_Z;
+    lattice[3][0] = (u32)(i32)fw * _XTD_NOISE_PRIME_W;
+    lattice[0][1] = lattice[0][0] + _XTD_NOISE_PRIME_X;
+    lattice[1][1] = lattice[1][0] + _XTD_NOISE_PRIME_Y;
+    lattice[2][1] = lattice[2][0] + _XTD_NOISE_PRIME_Z;
+    lattice[3][1] = lattice[3][0] + _XTD_NOISE_PRIME_W;
+
+    // Corner c has bit i set when it is on the far side of axis i, the lerps collapse one axis at a time
+    f32 n[16];
+    for (u32 c = 0; c < 16; c++)
+    {
+        u32 bx = c & 1, by = (c >> 1) & 1, bz = (c >> 2) & 1, bw = c >> 3;
+        u32 h = _xtd_NoiseHash(seed ^ lattice[0][bx] ^ lattice[1][by] ^ lattice[2][bz] ^ lattice[3][bw]);
+        n[c] = _xtd_Grad4(h, d[0] - (f32)bx, d[1] - (f32)by, d[2] - (f32)bz, d[3] - (f32)bw);
+    }
+    for (u32 axis = 0, count = 16; axis < 4; axis++)
+    {
+        f32 t = _xtd_NoiseFade(d[axis]);
+        count >>= 1;
+        for (u32 i = 0; i < count; i++)
+            n[i] = lerpF32(n[2 * i], n[2 * i + 1], t);
+    }
+    return n[0] * _XTD_PERLIN4_SCALE;
+}
+
+XTD_NOISE_FUNC f32 XTD_Simplex2D(f32 x, f32 y, u32 seed)
+{
+    f32 s = (x + y) * _XTD_SIMPLEX_F2;
+    f32 fi = floorf(x + s), fj = floorf(y + s);
+    f32 t = (fi + fj) * _XTD_SIMPLEX_G2;
+    f32 x0 = x - (fi - t), y0 = y - (fj - t);
+
+    // Lower or upper triangle of the skewed cell
+    u32 i1 = x0 > y0;
+    u32 j1 = !i1;
+    f32 x1 = x0 - (f32)i1 + _XTD_SIMPLEX_G2, y1 = y0 - (f32)j1 + _XTD_SIMPLEX_G2;
+    f32 x2 = x0 + (-1.0f + 2.0f * _XTD_SIMPLEX_G2), y2 = y0 + (-1.0f + 2.0f * _XTD_SIMPLEX_G2);
+
+    u32 xp = (u32)(i32)fi * _XTD_NOISE_PRIME_X;
+    u32 yp = (u32)(i32)fj * _XTD_NOISE_PRIME_Y;
+    u32 h0 = _xtd_NoiseHash(seed ^ xp ^ yp);
+    u32 h1 = _xtd_NoiseHash(seed ^ (xp + (i1 ? _XTD_NOISE_PRIME_X : 0)) ^ (yp + (j1 ? _XTD_NOISE_PRIME_Y : 0)));
+    u32 h2 = _xtd_NoiseHash(seed ^ (xp + _XTD_NOISE_PRIME_X) ^ (yp + _XTD_NOISE_PRIME_Y));
+
+    f32 n = _xtd_SimplexFalloff(x0 * x0 + y0 * y0) * _xtd_Grad2(h0, x0, y0);
+    n += _xtd_SimplexFalloff(x1 * x1 + y1 * y1) * _xtd_Grad2(h1, x1, y1);
+    n += _xtd_SimplexFalloff(x2 * x2 + y2 * y2) * _xtd_Grad2(h2, x2, y2);
+    return n * _XTD_SIMPLEX2_SCALE;
+}
+
+XTD_NOISE_FUNC f32 XTD_Simplex3D(f32 x, f32 y, f32 z, u32 seed)
+{
+    f32 s = (x + y + z) * _XTD_SIMPLEX_F3;
+    f32 fi = floorf(x + s), fj = floorf(y + s), fk = floorf(z + s);
+    f32 t = (fi + fj + fk) * _XTD_SIMPLEX_G3;
+    f32 x0 = x - (fi - t), y0 = y - (fj - t), z0 = z - (fk - t);
+
+    // The second corner steps along the largest offset, the third along the two largest
+    u32 x_ge_y = x0 >= y0, y_ge_z = y0 >= z0, x_ge_z = x0 >= z0;
+    u32 i1 = x_ge_y & x_ge_z;
+    u32 j1 = (1 - x_ge_y) & y_ge_z;
+    u32 k1 = (1 - x_ge_z) & (1 - y_ge_z);
+    u32 i2 = x_ge_y | x_ge_z;
+    u32 j2 = (1 - x_ge_y) | y_ge_z;
+    u32 k2 = 1 - (x_ge_z & y_ge_z);
+
+    f32 x1 = x0 - (f32)i1 + _XTD_SIMPLEX_G3, y1 = y0 - (f32)j1 + _XTD_SIMPLEX_G3, z1 = z0 - (f32)k1 + _XTD_SIMPLEX_G3;
+    f32 x2 = x0 - (f32)i2 + 2.0f * _XTD_SIMPLEX_G3, y2 = y0 - (f32)j2 + 2.0f * _XTD_SIMPLEX_G3, z2 = z0 - (f32)k2 + 2.0f * _XTD_SIMPLEX_G3;
+    f32 x3 = x0 + (-1.0f + 3.0f * _XTD_SIMPLEX_G3), y3 = y0 + (-1.0f + 3.0f * _XTD_SIMPLEX_G3), z3 = z0 + (-1.0f + 3.0f * _XTD_SIMPLEX_G3);
+
+    u32 xp = (u32)(i32)fi * _XTD_NOISE_PRIME_X;
+    u32 yp = (u32)(i32)fj * _XTD_NOISE_PRIME_Y;
+    u32 zp = (u32)(i32)fk * _XTD_NOISE_PRIME_Z;
+    u32 h0 = _xtd_NoiseHash(seed ^ xp ^ yp ^ zp);
+    u32 h1 = _xtd_NoiseHash(seed ^ (xp + i1 * _XTD_NOISE_PRIME_X) ^ (yp + j1 * _XTD_NOISE_PRIME_Y) ^ (zp + k1 * _XTD_NOISE_PRIME_Z));
+    u32 h2 = _xtd_NoiseHash(seed ^ (xp + i2 * _XTD_NOISE_PRIME_X) ^ (yp + j2 * _XTD_NOISE_PRIME_Y) ^ (zp + k2 * _XTD_NOISE_PRIME_Z));
+    u32 h3 = _xtd_NoiseHash(seed ^ (xp + _XTD_NOISE_PRIME_X) ^ (yp + _XTD_NOISE_PRIME_Y) ^ (zp + _XTD_NOISE_PRIME_Z));
+
+    f32 n = _xtd_SimplexFalloff(x0 * x0 + y0 * y0 + z0 * z0) * _xtd_Grad3(h0, x0, y0, z0);
+    n += _xtd_SimplexFalloff(x1 * x1 + y1 * y1 + z1 * z1) * _xtd_Grad3(h1, x1, y1, z1);
+    n += _xtd_SimplexFalloff(x2 * x2 + y2 * y2 + z2 * z2) * _xtd_Grad3(h2, x2, y2, z2);
+    n += _xtd_SimplexFalloff(x3 * x3 + y3 * y3 + z3 * z3) * _xtd_Grad3(h3, x3, y3, z3);
+    return n * _XTD_SIMPLEX3_SCALE;
+}
+
+XTD_NOISE_FUNC f32 XTD_Simplex4D(f32 x, f32 y, f32 z, f32 w, u32 seed)
+{
+    f32 s = (x + y + z + w) * _XTD_SIMPLEX_F4;
+    f32 fi = floorf(x + s), fj = floorf(y + s), fk = floorf(z + s), fl = floorf(w + s);
+    f32 t = (fi + fj + fk + fl) * _XTD_SIMPLEX_G4;
+    f32 d[4] = {x - (fi - t), y - (fj - t), z - (fk - t), w - (fl - t)};
+
+    // Rank of each offset among the four, corner c steps along the axes with rank >= 4 - c
+    u32 x_gt_y = d[0] > d[1], x_gt_z = d[0] > d[2], x_gt_w = d[0] > d[3];
+    u32 y_gt_z = d[1] > d[2], y_gt_w = d[1] > d[3], z_gt_w = d[2] > d[3];
+    u32 rank[4];
+    rank[0] = x_gt_y + x_gt_z + x_gt_w;
+    rank[1] = (1 - x_gt_y) + y_gt_z + y_gt_w;
+    rank[2] = (1 - x_gt_z) + (1 - y_gt_z) + z_gt_w;
+    rank[3] = 3 - x_gt_w - y_gt_w - z_gt_w;
+
+    u32 base[4];
+    base[0] = (u32)(i32)fi * _XTD_NOISE_PRIME_X;
+    base[1] = (u32)(i32)fj * _XTD_NOISE_PRIME_Y;
+    base[2] = (u32)(i32)fk * _XTD_NOISE_PRIME_Z;
+    base[3] = (u32)(i32)fl * _XTD_NOISE_PRIME_W;
+    const u32 primes[4] = {_XTD_NOISE_PRIME_X, _XTD_NOISE_PRIME_Y, _XTD_NOISE_PRIME_Z, _XTD_NOISE_PRIME_W};
+
+    f32 n = 0.0f;
+    for (u32 c = 0; c < 5; c++)
+    {
+        f32 o[4];
+        u32 h = seed;
+        for (u32 a = 0; a < 4; a++)
+        {
+            u32 step = rank[a] + c >= 4;
+            o[a] = d[a] - (f32)step + (f32)c * _XTD_SIMPLEX_G4;
+            h ^= base[a] + step * primes[a];
+        }
+        f32 r2 = o[0] * o[0] + o[1] * o[1] + o[2] * o[2] + o[3] * o[3];
+        n += _xtd_SimplexFalloff(r2) * _xtd_Grad4(_xtd_NoiseHash(h), o[0], o[1], o[2], o[3]);
+    }
+    return n * _XTD_SIMPLEX4_SCALE;
+}
+
+////////////////////////////////////////
+//
+//  Fractals
+//
+
+XTD_NOISE_FUNC XTD_NoiseParams XTD_NoiseDefaultParams(XTD_NoiseType type, u32 seed)
+{
+    XTD_NoiseParams params;
+    params.type = type;
+    params.fractal = XTD_NOISE_FBM;
+    params.seed = seed;
+    params.octaves = 5;
+    params.frequency = 1.0f;
+    params.lacunarity = 2.0f;
+    params.gain = 0.5f;
+    return params;
+}
+
+static f32 _xtd_NoiseSingle(XTD_NoiseType type, i32 dims, const f32* p, u32 seed)
+{
+    if (type == XTD_NOISE_SIMPLEX)
+    {
+        switch (dims)
+        {
+            case 2: return XTD_Simplex2D(p[0], p[1], seed);
+            case 3: return XTD_Simplex3D(p[0], p[1], p[2], seed);
+            default: return XTD_Simplex4D(p[0], p[1], p[2], p[3], seed);
+        }
+    }
+    switch (dims)
+    {
+        case 2: return XTD_Perlin2D(p[0], p[1], seed);
+        case 3: return XTD_Perlin3D(p[0], p[1], p[2], seed);
+        default: return XTD_Perlin4D(p[0], p[1], p[2], p[3], seed);
+    }
+}
+
+static f32 _xtd_NoiseFractal(const XTD_NoiseParams* params, i32 dims, const f32* p)
+{
+    i32 octaves = params->fractal == XTD_NOISE_SINGLE ? 1 : XTD_MAX(params->octaves, 1);
+    f32 freq = params->frequency;
+    f32 amp = 1.0f;
+    f32 sum = 0.0f;
+    f32 total = 0.0f;
+    for (i32 o = 0; o < octaves; o++)
+    {
+        f32 q[_XTD_NOISE_MAX_DIMS];
+        for (i32 i = 0; i < dims; i++)
+            q[i] = p[i] * freq;
+        f32 n = _xtd_NoiseSingle(params->type, dims, q, params->seed + (u32)o);
+        if (params->fractal == XTD_NOISE_RIDGED)
+        {
+            n = 1.0f - fabsf(n);
+            n = n * n * 2.0f - 1.0f;
+        }
+        sum += n * amp;
+        total += amp;
+        amp *= params->gain;
+        freq *= params->lacunarity;
+    }
+    return sum / total;
+}
+
+XTD_NOISE_FUNC f32 XTD_Noise2D(const XTD_NoiseParams* params, V2f p)
+{
+    return _xtd_NoiseFractal(params, 2, p.e);
+}
+
+XTD_NOISE_FUNC f32 XTD_Noise3D(const XTD_NoiseParams* params, V3f p)
+{
+    return _xtd_NoiseFractal(params, 3, p.e);
+}
+
+XTD_NOISE_FUNC f32 XTD_Noise4D(const XTD_NoiseParams* params, V4f p)
+{
+    return _xtd_NoiseFractal(params, 4, p.e);
+}
+
+////////////////////////////////////////
+//
+//  SIMD noise
+//
+
+// 8 wide versions of the functions above, same operations in the same order
+
+#if XTD_HAS_AVX2 || XTD_HAS_CPU_DISPATCH
+
+XTD_TARGET_AVX2 XTD_FORCE_INLINE __m256i _xtd_NoiseHashx8(__m256i h)
+{
+    h = _mm256_mullo_epi32(h, _mm256_set1_epi32((i32)_XTD_NOISE_HASH_MUL));
+    return _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+}
+
+XTD_TARGET_AVX2 XTD_FORCE_INLINE __m256i _xtd_NoiseLatticex8(F32x8 f, u32 prime)
+{
+    return _mm256_mullo_epi32(_mm256_cvttps_epi32(f), _mm256_set1_epi32((i32)prime));
+}
+
+// Negate the lanes that have the given hash bit set
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_NoiseFlipx8(F32x8 v, __m256i h, i32 bit)
+{
+    __m256i sign = _mm256_and_si256(_mm256_slli_epi32(h, 31 - bit), _mm256_set1_epi32((i32)0x80000000));
+    return _mm256_xor_ps(v, _mm256_castsi256_ps(sign));
+}
+
+// a where h < limit, b elsewhere
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_NoiseSelectLtx8(__m256i h, i32 limit, F32x8 a, F32x8 b)
+{
+    __m256i lt = _mm256_cmpgt_epi32(_mm256_set1_epi32(limit), h);
+    return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(lt));
+}
+
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_Grad2x8(__m256i h, F32x8 x, F32x8 y)
+{
+    h = _mm256_and_si256(h, _mm256_set1_epi32(7));
+    F32x8 u = _xtd_NoiseSelectLtx8(h, 4, x, y);
+    F32x8 v = _xtd_NoiseSelectLtx8(h, 4, y, x);
+    return _mm256_add_ps(_xtd_NoiseFlipx8(u, h, 0), _xtd_NoiseFlipx8(_mm256_mul_ps(_mm256_set1_ps(2.0f), v), h, 1));
+}
+
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_Grad3x8(__m256i h, F32x8 x, F32x8 y, F32x8 z)
+{
+    h = _mm256_and_si256(h, _mm256_set1_epi32(15));
+    F32x8 u = _xtd_NoiseSelectLtx8(h, 8, x, y);
+    __m256i use_x = _mm256_cmpeq_epi32(_mm256_or_si256(h, _mm256_set1_epi32(2)), _mm256_set1_epi32(14));
+    F32x8 xz = _mm256_blendv_ps(z, x, _mm256_castsi256_ps(use_x));
+    F32x8 v = _xtd_NoiseSelectLtx8(h, 4, y, xz);
+    return _mm256_add_ps(_xtd_NoiseFlipx8(u, h, 0), _xtd_NoiseFlipx8(v, h, 1));
+}
+
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_Grad4x8(__m256i h, F32x8 x, F32x8 y, F32x8 z, F32x8 w)
+{
+    h = _mm256_and_si256(h, _mm256_set1_epi32(31));
+    F32x8 u = _xtd_NoiseSelectLtx8(h, 24, x, y);
+    F32x8 v = _xtd_NoiseSelectLtx8(h, 16, y, z);
+    F32x8 t = _xtd_NoiseSelectLtx8(h, 8, z, w);
+    F32x8 uv = _mm256_add_ps(_xtd_NoiseFlipx8(u, h, 0), _xtd_NoiseFlipx8(v, h, 1));
+    return _mm256_add_ps(uv, _xtd_NoiseFlipx8(t, h, 2));
+}
+
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_NoiseFadex8(F32x8 t)
+{
+    F32x8 p = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(t, p), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), p);
+}
+
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_NoiseLerpx8(F32x8 a, F32x8 b, F32x8 t)
+{
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_SimplexFalloffx8(F32x8 r2)
+{
+    F32x8 t = _mm256_max_ps(_mm256_sub_ps(_mm256_set1_ps(0.5f), r2), _mm256_setzero_ps());
+    t = _mm256_mul_ps(t, t);
+    return _mm256_mul_ps(t, t);
+}
+
+// Step of prime where the mask is set, 0 elsewhere
+XTD_TARGET_AVX2 XTD_FORCE_INLINE __m256i _xtd_NoiseStepx8(__m256i mask, u32 prime)
+{
+    return _mm256_and_si256(mask, _mm256_set1_epi32((i32)prime));
+}
+
+// Mask to 1.0f / 0.0f
+XTD_TARGET_AVX2 XTD_FORCE_INLINE F32x8 _xtd_NoiseMaskToOnex8(__m256i mask)
+{
+    return _mm256_and_ps(_mm256_castsi256_ps(mask), _mm256_set1_ps(1.0f));
+}
+
+static XTD_TARGET_AVX2 F32x8 _xtd_Perlin2Dx8(const F32x8* p, __m256i seed)
+{
+    F32x8 one = _mm256_set1_ps(1.0f);
+    F32x8 fx = _mm256_floor_ps(p[0]), fy = _mm256_floor_ps(p[1]);
+    F32x8 dx = _mm256_sub_ps(p[0], fx), dy = _mm256_sub_ps(p[1], fy);
+    F32x8 dx1 = _mm256_sub_ps(dx, one), dy1 = _mm256_sub_ps(dy, one);
+    __m256i x0 = _xtd_NoiseLatticex8(fx, _XTD_NOISE_PRIME_X), x1 = _mm256_add_epi32(x0, _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_X));
+    __m256i y0 = _xtd_NoiseLatticex8(fy, _XTD_NOISE_PRIME_Y), y1 = _mm256_add_epi32(y0, _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_Y));
+    __m256i sy0 = _mm256_xor_si256(seed, y0), sy1 = _mm256_xor_si256(seed, y1);
+    F32x8 u = _xtd_NoiseFadex8(dx), v = _xtd_NoiseFadex8(dy);
+
+    F32x8 n00 = _xtd_Grad2x8(_xtd_NoiseHashx8(_mm256_xor_si256(sy0, x0)), dx, dy);
+    F32x8 n10 = _xtd_Grad2x8(_xtd_NoiseHashx8(_mm256_xor_si256(sy0, x1)), dx1, dy);
+    F32x8 n01 = _xtd_Grad2x8(_xtd_NoiseHashx8(_mm256_xor_si256(sy1, x0)), dx, dy1);
+    F32x8 n11 = _xtd_Grad2x8(_xtd_NoiseHashx8(_mm256_xor_si256(sy1, x1)), dx1, dy1);
+    F32x8 n = _xtd_NoiseLerpx8(_xtd_NoiseLerpx8(n00, n10, u), _xtd_NoiseLerpx8(n01, n11, u), v);
+    return _mm256_mul_ps(n, _mm256_set1_ps(_XTD_PERLIN2_SCALE));
+}
+
+static XTD_TARGET_AVX2 F32x8 _xtd_Perlin3Dx8(const F32x8* p, __m256i seed)
+{
+    F32x8 one = _mm256_set1_ps(1.0f);
+    F32x8 fx = _mm256_floor_ps(p[0]), fy = _mm256_floor_ps(p[1]), fz = _mm256_floor_ps(p[2]);
+    F32x8 dx = _mm256_sub_ps(p[0], fx), dy = _mm256_sub_ps(p[1], fy), dz = _mm256_sub_ps(p[2], fz);
+    F32x8 dx1 = _mm256_sub_ps(dx, one), dy1 = _mm256_sub_ps(dy, one), dz1 = _mm256_sub_ps(dz, one);
+    __m256i x0 = _xtd_NoiseLatticex8(fx, _XTD_NOISE_PRIME_X), x1 = _mm256_add_epi32(x0, _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_X));
+    __m256i y0 = _xtd_NoiseLatticex8(fy, _XTD_NOISE_PRIME_Y), y1 = _mm256_add_epi32(y0, _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_Y));
+    __m256i z0 = _xtd_NoiseLatticex8(fz, _XTD_NOISE_PRIME_Z), z1 = _mm256_add_epi32(z0, _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_Z));
+    F32x8 u = _xtd_NoiseFadex8(dx), v = _xtd_NoiseFadex8(dy), w = _xtd_NoiseFadex8(dz);
+
+    __m256i s00 = _mm256_xor_si256(seed, _mm256_xor_si256(y0, z0));
+    __m256i s10 = _mm256_xor_si256(seed, _mm256_xor_si256(y1, z0));
+    __m256i s01 = _mm256_xor_si256(seed, _mm256_xor_si256(y0, z1));
+    __m256i s11 = _mm256_xor_si256(seed, _mm256_xor_si256(y1, z1));
+    F32x8 n000 = _xtd_Grad3x8(_xtd_NoiseHashx8(_mm256_xor_si256(s00, x0)), dx, dy, dz);
+    F32x8 n100 = _xtd_Grad3x8(_xtd_NoiseHashx8(_mm256_xor_si256(s00, x1)), dx1, dy, dz);
+    F32x8 n010 = _xtd_Grad3x8(_xtd_NoiseHashx8(_mm256_xor_si256(s10, x0)), dx, dy1, dz);
+    F32x8 n110 = _xtd_Grad3x8(_xtd_NoiseHashx8(_mm256_xor_si256(s10, x1)), dx1, dy1, dz);
+    F32x8 n001 = _xtd_Grad3x8(_xtd_NoiseHashx8(_mm256_xor_si256(s01, x0)), dx, dy, dz1);
+    F32x8 n101 = _xtd_Grad3x8(_xtd_NoiseHashx8(_mm256_xor_si256(s01, x1)), dx1, dy, dz1);
+    F32x8 n011 = _xtd_Grad3x8(_xtd_NoiseHashx8(_mm256_xor_si256(s11, x0)), dx, dy1, dz1);
+    F32x8 n111 = _xtd_Grad3x8(_xtd_NoiseHashx8(_mm256_xor_si256(s11, x1)), dx1, dy1, dz1);
+    F32x8 nxy0 = _xtd_NoiseLerpx8(_xtd_NoiseLerpx8(n000, n100, u), _xtd_NoiseLerpx8(n010, n110, u), v);
+    F32x8 nxy1 = _xtd_NoiseLerpx8(_xtd_NoiseLerpx8(n001, n101, u), _xtd_NoiseLerpx8(n011, n111, u), v);
+    return _mm256_mul_ps(_xtd_NoiseLerpx8(nxy0, nxy1, w), _mm256_set1_ps(_XTD_PERLIN3_SCALE));
+}
+
+static XTD_TARGET_AVX2 F32x8 _xtd_Perlin4Dx8(const F32x8* p, __m256i seed)
+{
+    const u32 primes[4] = {_XTD_NOISE_PRIME_X, _XTD_NOISE_PRIME_Y, _XTD_NOISE_PRIME_Z, _XTD_NOISE_PRIME_W};
+    F32x8 d[4][2];
+    __m256i lattice[4][2];
+    for (u32 a = 0; a < 4; a++)
+    {
+        F32x8 f = _mm256_floor_ps(p[a]);
+        d[a][0] = _mm256_sub_ps(p[a], f);
+        d[a][1] = _mm256_sub_ps(d[a][0], _mm256_set1_ps(1.0f));
+        lattice[a][0] = _xtd_NoiseLatticex8(f, primes[a]);
+        lattice[a][1] = _mm256_add_epi32(lattice[a][0], _mm256_set1_epi32((i32)primes[a]));
+    }
+
+    F32x8 n[16];
+    for (u32 c = 0; c < 16; c++)
+    {
+        u32 bx = c & 1, by = (c >> 1) & 1, bz = (c >> 2) & 1, bw = c >> 3;
+        __m256i h = _mm256_xor_si256(seed, lattice[0][bx]);
+        h = _mm256_xor_si256(h, lattice[1][by]);
+        h = _mm256_xor_si256(h, lattice[2][bz]);
+        h = _mm256_xor_si256(h, lattice[3][bw]);
+        n[c] = _xtd_Grad4x8(_xtd_NoiseHashx8(h), d[0][bx], d[1][by], d[2][bz], d[3][bw]);
+    }
+    for (u32 axis = 0, count = 16; axis < 4; axis++)
+    {
+        F32x8 t = _xtd_NoiseFadex8(d[axis][0]);
+        count >>= 1;
+        for (u32 i = 0; i < count; i++)
+            n[i] = _xtd_NoiseLerpx8(n[2 * i], n[2 * i + 1], t);
+    }
+    return _mm256_mul_ps(n[0], _mm256_set1_ps(_XTD_PERLIN4_SCALE));
+}
+
+static XTD_TARGET_AVX2 F32x8 _xtd_Simplex2Dx8(const F32x8* p, __m256i seed)
+{
+    F32x8 g2 = _mm256_set1_ps(_XTD_SIMPLEX_G2);
+    F32x8 s = _mm256_mul_ps(_mm256_add_ps(p[0], p[1]), _mm256_set1_ps(_XTD_SIMPLEX_F2));
+    F32x8 fi = _mm256_floor_ps(_mm256_add_ps(p[0], s)), fj = _mm256_floor_ps(_mm256_add_ps(p[1], s));
+    F32x8 t = _mm256_mul_ps(_mm256_add_ps(fi, fj), g2);
+    F32x8 x0 = _mm256_sub_ps(p[0], _mm256_sub_ps(fi, t)), y0 = _mm256_sub_ps(p[1], _mm256_sub_ps(fj, t));
+
+    __m256i i1 = _mm256_castps_si256(_mm256_cmp_ps(x0, y0, _CMP_GT_OQ));
+    __m256i j1 = _mm256_xor_si256(i1, _mm256_set1_epi32(-1));
+    F32x8 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _xtd_NoiseMaskToOnex8(i1)), g2);
+    F32x8 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _xtd_NoiseMaskToOnex8(j1)), g2);
+    F32x8 c2 = _mm256_set1_ps(-1.0f + 2.0f * _XTD_SIMPLEX_G2);
+    F32x8 x2 = _mm256_add_ps(x0, c2), y2 = _mm256_add_ps(y0, c2);
+
+    __m256i xp = _xtd_NoiseLatticex8(fi, _XTD_NOISE_PRIME_X);
+    __m256i yp = _xtd_NoiseLatticex8(fj, _XTD_NOISE_PRIME_Y);
+    __m256i h0 = _mm256_xor_si256(seed, _mm256_xor_si256(xp, yp));
+    __m256i h1 = _mm256_xor_si256(_mm256_add_epi32(xp, _xtd_NoiseStepx8(i1, _XTD_NOISE_PRIME_X)), _mm256_add_epi32(yp, _xtd_NoiseStepx8(j1, _XTD_NOISE_PRIME_Y)));
+    __m256i h2 = _mm256_xor_si256(_mm256_add_epi32(xp, _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_X)), _mm256_add_epi32(yp, _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_Y)));
+    h1 = _mm256_xor_si256(seed, h1);
+    h2 = _mm256_xor_si256(seed, h2);
+
+    F32x8 r0 = _mm256_add_ps(_mm256_mul_ps(x0, x0), _mm256_mul_ps(y0, y0));
+    F32x8 r1 = _mm256_add_ps(_mm256_mul_ps(x1, x1), _mm256_mul_ps(y1, y1));
+    F32x8 r2 = _mm256_add_ps(_mm256_mul_ps(x2, x2), _mm256_mul_ps(y2, y2));
+    F32x8 n = _mm256_mul_ps(_xtd_SimplexFalloffx8(r0), _xtd_Grad2x8(_xtd_NoiseHashx8(h0), x0, y0));
+    n = _mm256_add_ps(n, _mm256_mul_ps(_xtd_SimplexFalloffx8(r1), _xtd_Grad2x8(_xtd_NoiseHashx8(h1), x1, y1)));
+    n = _mm256_add_ps(n, _mm256_mul_ps(_xtd_SimplexFalloffx8(r2), _xtd_Grad2x8(_xtd_NoiseHashx8(h2), x2, y2)));
+    return _mm256_mul_ps(n, _mm256_set1_ps(_XTD_SIMPLEX2_SCALE));
+}
+
+static XTD_TARGET_AVX2 F32x8 _xtd_Simplex3Dx8(const F32x8* p, __m256i seed)
+{
+    F32x8 g3 = _mm256_set1_ps(_XTD_SIMPLEX_G3);
+    F32x8 s = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(p[0], p[1]), p[2]), _mm256_set1_ps(_XTD_SIMPLEX_F3));
+    F32x8 fi = _mm256_floor_ps(_mm256_add_ps(p[0], s));
+    F32x8 fj = _mm256_floor_ps(_mm256_add_ps(p[1], s));
+    F32x8 fk = _mm256_floor_ps(_mm256_add_ps(p[2], s));
+    F32x8 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(fi, fj), fk), g3);
+    F32x8 x0 = _mm256_sub_ps(p[0], _mm256_sub_ps(fi, t));
+    F32x8 y0 = _mm256_sub_ps(p[1], _mm256_sub_ps(fj, t));
+    F32x8 z0 = _mm256_sub_ps(p[2], _mm256_sub_ps(fk, t));
+
+    __m256i x_ge_y = _mm256_castps_si256(_mm256_cmp_ps(x0, y0, _CMP_GE_OQ));
+    __m256i y_ge_z = _mm256_castps_si256(_mm256_cmp_ps(y0, z0, _CMP_GE_OQ));
+    __m256i x_ge_z = _mm256_castps_si256(_mm256_cmp_ps(x0, z0, _CMP_GE_OQ));
+    __m256i ones = _mm256_set1_epi32(-1);
+    __m256i i1 = _mm256_and_si256(x_ge_y, x_ge_z);
+    __m256i j1 = _mm256_andnot_si256(x_ge_y, y_ge_z);
+    __m256i k1 = _mm256_andnot_si256(_mm256_or_si256(x_ge_z, y_ge_z), ones);
+    __m256i i2 = _mm256_or_si256(x_ge_y, x_ge_z);
+    __m256i j2 = _mm256_or_si256(_mm256_xor_si256(x_ge_y, ones), y_ge_z);
+    __m256i k2 = _mm256_xor_si256(_mm256_and_si256(x_ge_z, y_ge_z), ones);
+
+    F32x8 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _xtd_NoiseMaskToOnex8(i1)), g3);
+    F32x8 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _xtd_NoiseMaskToOnex8(j1)), g3);
+    F32x8 z1 = _mm256_add_ps(_mm256_sub_ps(z0, _xtd_NoiseMaskToOnex8(k1)), g3);
+    F32x8 g3_2 = _mm256_set1_ps(2.0f * _XTD_SIMPLEX_G3);
+    F32x8 x2 = _mm256_add_ps(_mm256_sub_ps(x0, _xtd_NoiseMaskToOnex8(i2)), g3_2);
+    F32x8 y2 = _mm256_add_ps(_mm256_sub_ps(y0, _xtd_NoiseMaskToOnex8(j2)), g3_2);
+    F32x8 z2 = _mm256_add_ps(_mm256_sub_ps(z0, _xtd_NoiseMaskToOnex8(k2)), g3_2);
+    F32x8 c3 = _mm256_set1_ps(-1.0f + 3.0f * _XTD_SIMPLEX_G3);
+    F32x8 x3 = _mm256_add_ps(x0, c3), y3 = _mm256_add_ps(y0, c3), z3 = _mm256_add_ps(z0, c3);
+
+    __m256i px = _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_X);
+    __m256i py = _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_Y);
+    __m256i pz = _mm256_set1_epi32((i32)_XTD_NOISE_PRIME_Z);
+    __m256i xp = _xtd_NoiseLatticex8(fi, _XTD_NOISE_PRIME_X);
+    __m256i yp = _xtd_NoiseLatticex8(fj, _XTD_NOISE_PRIME_Y);
+    __m256i zp = _xtd_NoiseLatticex8(fk, _XTD_NOISE_PRIME_Z);
+    __m256i h0 = _mm256_xor_si256(_mm256_xor_si256(seed, xp), _mm256_xor_si256(yp, zp));
+    __m256i h1 = _mm256_xor_si256(seed, _mm256_add_epi32(xp, _mm256_and_si256(i1, px)));
+    h1 = _mm256_xor_si256(h1, _mm256_xor_si256(_mm256_add_epi32(yp, _mm256_and_si256(j1, py)), _mm256_add_epi32(zp, _mm256_and_si256(k1, pz))));
+    __m256i h2 = _mm256_xor_si256(seed, _mm256_add_epi32(xp, _mm256_and_si256(i2, px)));
+    h2 = _mm256_xor_si256(h2, _mm256_xor_si256(_mm256_add_epi32(yp, _mm256_and_si256(j2, py)), _mm256_add_epi32(zp, _mm256_and_si256(k2, pz))));
+    __m256i h3 = _mm256_xor_si256(seed, _mm256_add_epi32(xp, px));
+    h3 = _mm256_xor_si256(h3, _mm256_xor_si256(_mm256_add_epi32(yp, py), _mm256_add_epi32(zp, pz)));
+
+#define _XTD_SIMPLEX3_CORNER(h, x, y, z) \
+    _mm256_mul_ps(_xtd_SimplexFalloffx8(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z))), \
+                  _xtd_Grad3x8(_xtd_NoiseHashx8(h), x, y, z))
+    F32x8 n = _XTD_SIMPLEX3_CORNER(h0, x0, y0, z0);
+    n = _mm256_add_ps(n, _XTD_SIMPLEX3_CORNER(h1, x1, y1, z1));
+    n = _mm256_add_ps(n, _XTD_SIMPLEX3_CORNER(h2, x2, y2, z2));
+    n = _mm256_add_ps(n, _XTD_SIMPLEX3_CORNER(h3, x3, y3, z3));
+#undef _XTD_SIMPLEX3_CORNER
+    return _mm256_mul_ps(n, _mm256_set1_ps(_XTD_SIMPLEX3_SCALE));
+}
+
+static XTD_TARGET_AVX2 F32x8 _xtd_Simplex4Dx8(const F32x8* p, __m256i seed)
+{
+    const u32 primes[4] = {_XTD_NOISE_PRIME_X, _XTD_NOISE_PRIME_Y, _XTD_NOISE_PRIME_Z, _XTD_NOISE_PRIME_W};
+    F32x8 s = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(p[0], p[1]), p[2]), p[3]), _mm256_set1_ps(_XTD_SIMPLEX_F4));
+    F32x8 f[4];
+    for (u32 a = 0; a < 4; a++)
+        f[a] = _mm256_floor_ps(_mm256_add_ps(p[a], s));
+    F32x8 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(f[0], f[1]), f[2]), f[3]), _mm256_set1_ps(_XTD_SIMPLEX_G4));
+    F32x8 d[4];
+    __m256i base[4];
+    for (u32 a = 0; a < 4; a++)
+    {
+        d[a] = _mm256_sub_ps(p[a], _mm256_sub_ps(f[a], t));
+        base[a] = _xtd_NoiseLatticex8(f[a], primes[a]);
+    }
+
+    // Comparison masks are -1 where true, so the ranks are accumulated with subtractions
+    __m256i x_gt_y = _mm256_castps_si256(_mm256_cmp_ps(d[0], d[1], _CMP_GT_OQ));
+    __m256i x_gt_z = _mm256_castps_si256(_mm256_cmp_ps(d[0], d[2], _CMP_GT_OQ));
+    __m256i x_gt_w = _mm256_castps_si256(_mm256_cmp_ps(d[0], d[3], _CMP_GT_OQ));
+    __m256i y_gt_z = _mm256_castps_si256(_mm256_cmp_ps(d[1], d[2], _CMP_GT_OQ));
+    __m256i y_gt_w = _mm256_castps_si256(_mm256_cmp_ps(d[1], d[3], _CMP_GT_OQ));
+    __m256i z_gt_w = _mm256_castps_si256(_mm256_cmp_ps(d[2], d[3], _CMP_GT_OQ));
+    __m256i zero = _mm256_setzero_si256();
+    __m256i rank[4];
+    rank[0] = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_sub_epi32(zero, x_gt_y), x_gt_z), x_gt_w);
+    rank[1] = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_add_epi32(_mm256_set1_epi32(1), x_gt_y), y_gt_z), y_gt_w);
+    rank[2] = _mm256_sub_epi32(_mm256_add_epi32(_mm256_add_epi32(_mm256_set1_epi32(2), x_gt_z), y_gt_z), z_gt_w);
+    rank[3] = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(_mm256_set1_epi32(3), x_gt_w), y_gt_w), z_gt_w);
+
+    F32x8 n = _mm256_setzero_ps();
+    for (u32 c = 0; c < 5; c++)
+    {
+        F32x8 o[4];
+        __m256i h = seed;
+        F32x8 offset = _mm256_set1_ps((f32)c * _XTD_SIMPLEX_G4);
+        for (u32 a = 0; a < 4; a++)
+        {
+            __m256i step = _mm256_cmpgt_epi32(rank[a], _mm256_set1_epi32(3 - (i32)c));
+            o[a] = _mm256_add_ps(_mm256_sub_ps(d[a], _xtd_NoiseMaskToOnex8(step)), offset);
+            h = _mm256_xor_si256(h, _mm256_add_epi32(base[a], _xtd_NoiseStepx8(step, primes[a])));
+        }
+        F32x8 r2 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(o[0], o[0]), _mm256_mul_ps(o[1], o[1])), _mm256_mul_ps(o[2], o[2])), _mm256_mul_ps(o[3], o[3]));
+        n = _mm256_add_ps(n, _mm256_mul_ps(_xtd_SimplexFalloffx8(r2), _xtd_Grad4x8(_xtd_NoiseHashx8(h), o[0], o[1], o[2], o[3])));
+    }
+    return _mm256_mul_ps(n, _mm256_set1_ps(_XTD_SIMPLEX4_SCALE));
+}
+
+typedef F32x8 _XTD_NoiseFuncx8(const F32x8* p, __m256i seed);
+
+static XTD_TARGET_AVX2 F32x8 _xtd_NoiseFractalx8(const XTD_NoiseParams* params, i32 dims, const F32x8* p)
+{
+    static _XTD_NoiseFuncx8* const funcs[2][3] = {
+        {_xtd_Perlin2Dx8, _xtd_Perlin3Dx8, _xtd_Perlin4Dx8},
+        {_xtd_Simplex2Dx8, _xtd_Simplex3Dx8, _xtd_Simplex4Dx8},
+    };
+    _XTD_NoiseFuncx8* func = funcs[params->type == XTD_NOISE_SIMPLEX][dims - 2];
+
+    i32 octaves = params->fractal == XTD_NOISE_SINGLE ? 1 : XTD_MAX(params->octaves, 1);
+    f32 freq = params->frequency;
+    f32 amp = 1.0f;
+    f32 total = 0.0f;
+    F32x8 sum = _mm256_setzero_ps();
+    for (i32 o = 0; o < octaves; o++)
+    {
+        F32x8 q[_XTD_NOISE_MAX_DIMS];
+        for (i32 i = 0; i < dims; i++)
+            q[i] = _mm256_mul_ps(p[i], _mm256_set1_ps(freq));
+        F32x8 n = func(q, _mm256_set1_epi32((i32)(params->seed + (u32)o)));
+        if (params->fractal == XTD_NOISE_RIDGED)
+        {
+            F32x8 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+            n = _mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(n, abs_mask));
+            n = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(n, n), _mm256_set1_ps(2.0f)), _mm256_set1_ps(1.0f));
+        }
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(n, _mm256_set1_ps(amp)));
+        total += amp;
+        amp *= params->gain;
+        freq *= params->lacunarity;
+    }
+    return _mm256_div_ps(sum, _mm256_set1_ps(total));
+}
+
+#endif // XTD_HAS_AVX2 || XTD_HAS_CPU_DISPATCH
+
+////////////////////////////////////////
+//
+//  Batch and grid evaluation
+//
+
+// Evaluate up to 8 points stored as per axis lanes, the unused lanes are computed and dropped
+
+#if XTD_HAS_AVX2 || XTD_HAS_CPU_DISPATCH
+static XTD_TARGET_AVX2 void _xtd_NoiseLanesAVX2(const XTD_NoiseParams* params, i32 dims, f32 lanes[][8], f32* out, usize count)
+{
+    F32x8 p[_XTD_NOISE_MAX_DIMS];
+    for (i32 i = 0; i < dims; i++)
+        p[i] = _mm256_loadu_ps(lanes[i]);
+    f32 res[8];
+    _mm256_storeu_ps(res, _xtd_NoiseFractalx8(params, dims, p));
+    for (usize l = 0; l < count; l++)
+        out[l] = res[l];
+}
+#endif
+
+static void _xtd_NoiseLanesScalar(const XTD_NoiseParams* params, i32 dims, f32 lanes[][8], f32* out, usize count)
+{
+    for (usize l = 0; l < count; l++)
+    {
+        f32 p[_XTD_NOISE_MAX_DIMS];
+        for (i32 i = 0; i < dims; i++)
+            p[i] = lanes[i][l];
+        out[l] = _xtd_NoiseFractal(params, dims, p);
+    }
+}
+
+typedef void _XTD_NoiseLanesFunc(const XTD_NoiseParams* params, i32 dims, f32 lanes[][8], f32* out, usize count);
+
+static _XTD_NoiseLanesFunc* _xtd_NoiseGetLanesFunc(void)
+{
+#if XTD_HAS_AVX2 || XTD_HAS_CPU_DISPATCH
+    if (XTD_GetCPUTier() >= XTD_CPU_TIER_AVX2)
+        return _xtd_NoiseLanesAVX2;
+#endif
+    return _xtd_NoiseLanesScalar;
+}
+
+static void _xtd_NoiseBatch(const XTD_NoiseParams* params, i32 dims, f32* out, const f32* const* coords, usize count)
+{
+    _XTD_NoiseLanesFunc* lanes_func = _xtd_NoiseGetLanesFunc();
+    for (usize start = 0; start < count; start += 8)
+    {
+        usize n = XTD_MIN(count - start, 8);
+        f32 lanes[_XTD_NOISE_MAX_DIMS][8] = {{0}};
+        for (i32 i = 0; i < dims; i++)
+            for (usize l = 0; l < n; l++)
+                lanes[i][l] = coords[i][start + l];
+        lanes_func(params, dims, lanes, out + start, n);
+    }
+}
+
+XTD_NOISE_FUNC void XTD_NoiseBatch2D(const XTD_NoiseParams* params, f32* out, const f32* x, const f32* y, usize count)
+{
+    const f32* coords[2] = {x, y};
+    _xtd_NoiseBatch(params, 2, out, coords, count);
+}
+
+XTD_NOISE_FUNC void XTD_NoiseBatch3D(const XTD_NoiseParams* params, f32* out, const f32* x, const f32* y, const f32* z, usize count)
+{
+    const f32* coords[3] = {x, y, z};
+    _xtd_NoiseBatch(params, 3, out, coords, count);
+}
+
+XTD_NOISE_FUNC void XTD_NoiseBatch4D(const XTD_NoiseParams* params, f32* out, const f32* x, const f32* y, const f32* z, const f32* w, usize count)
+{
+    const f32* coords[4] = {x, y, z, w};
+    _xtd_NoiseBatch(params, 4, out, coords, count);
+}
+
+// Fills one row of a grid, only x changes along the row
+static void _xtd_NoiseGridRow(const XTD_NoiseParams* params, i32 dims, f32* out, i32 width, const f32* row_origin, f32 step_x)
+{
+    _XTD_NoiseLanesFunc* lanes_func = _xtd_NoiseGetLanesFunc();
+    f32 lanes[_XTD_NOISE_MAX_DIMS][8];
+    for (i32 i = 1; i < dims; i++)
+        for (i32 l = 0; l < 8; l++)
+            lanes[i][l] = row_origin[i];
+    for (i32 x = 0; x < width; x += 8)
+    {
+        for (i32 l = 0; l < 8; l++)
+            lanes[0][l] = row_origin[0] + (f32)(x + l) * step_x;
+        lanes_func(params, dims, lanes, out + x, (usize)XTD_MIN(width - x, 8));
+    }
+}
+
+XTD_NOISE_FUNC void XTD_NoiseFillGrid2D(const XTD_NoiseParams* params, f32* out, i32 width, i32 height, usize stride, V2f origin, V2f step)
+{
+    for (i32 y = 0; y < height; y++)
+    {
+        f32 row_origin[2] = {origin.x, origin.y + (f32)y * step.y};
+        f32* row = (f32*)((u8*)out + (usize)y * stride);
+        _xtd_NoiseGridRow(params, 2, row, width, row_origin, step.x);
+    }
+}
+
+XTD_NOISE_FUNC void XTD_NoiseFillGrid3D(const XTD_NoiseParams* params, f32* out, i32 width, i32 height, i32 depth, V3f origin, V3f step)
+{
+    for (i32 z = 0; z < depth; z++)
+    {
+        for (i32 y = 0; y < height; y++)
+        {
+            f32 row_origin[3] = {origin.x, origin.y + (f32)y * step.y, origin.z + (f32)z * step.z};
+            f32* row = out + ((usize)z * (usize)height + (usize)y) * (usize)width;
+            _xtd_NoiseGridRow(params, 3, row, width, row_origin, step.x);
+        }
+    }
+}
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_NOISE_HEADER_H
@@ -0,0 +1,580 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// QOI (Quite OK Image format) processing module, see https://qoiformat.org
+// #define XTD_QOI_IMPLEMENTATION to include the implementation
+// The XTD_Image functions need the xtd_image.h implementation for format conversion
+// Depends on xtd_thread.h for encoding several frames in parallel
+
+#ifndef XTD_QOI_HEADER_H
+#define XTD_QOI_HEADER_H
+
+#include "xtd_common.h"
+#include "xtd_image.h"
+
+#ifndef XTD_QOI_FUNC
+#define XTD_QOI_FUNC
+#endif
+
+#ifndef XTD_QOI_FUNC_DECL
+#define XTD_QOI_FUNC_DECL extern
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  QOI Types
+//
+
+#define XTD_QOI_HEADER_SIZE 14
+#define XTD_QOI_PADDING_SIZE 8 // End marker
+
+typedef enum {
+    XTD_QOI_SRGB = 0,   // sRGB colors with linear alpha
+    XTD_QOI_LINEAR = 1, // All channels linear
+} XTD_QOIColorspace;
+
+typedef struct {
+    i32 width;
+    i32 height;
+    u8 channels; // 3 (RGB) or 4 (RGBA), only informative, pixels always decode to 4 channels
+    u8 colorspace;
+} XTD_QOIDesc;
+
+// One image to encode with XTD_WriteQOIFrames
+typedef struct {
+    XTD_Image image;
+    void* out_file;   // FILE* to stream the frame to, or NULL to write it to out_buffer
+    void* out_buffer; // Must hold XTD_GetQOIMaxSize(image.width, image.height, 4) bytes
+    usize out_size;   // Bytes written
+    int result;       // 0 or an errno value
+} XTD_QOIFrame;
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+// Worst case encoded size, header and end marker included
+XTD_QOI_FUNC_DECL usize XTD_GetQOIMaxSize(i32 width, i32 height, i32 channels);
+
+// Raw pixels are tightly packed RGB or RGBA (channels 3 or 4) with row 0 at the top.
+// Files are tagged as sRGB. The memory variants return the number of bytes written.
+XTD_QOI_FUNC_DECL usize XTD_WriteQOIToMem(void* out_buffer, i32 width, i32 height, int channels, const u8* pixels);
+XTD_QOI_FUNC_DECL int XTD_WriteQOIToFile(void* out_file, i32 width, i32 height, int channels, const u8* pixels);
+
+// Write any image view as a 4 channel QOI, returns 0 bytes / ENOMEM if a conversion row can not be allocated
+XTD_QOI_FUNC_DECL usize XTD_WriteQOIImageToMem(void* out_buffer, const XTD_Image* img);
+XTD_QOI_FUNC_DECL int XTD_WriteQOIImageToFile(void* out_file, const XTD_Image* img);
+
+// Encodes independent frames on thread_count threads (0 = one per CPU), one frame per task
+XTD_QOI_FUNC_DECL void XTD_WriteQOIFrames(XTD_QOIFrame* frames, u32 count, u32 thread_count);
+
+// Decoding goes into a caller-allocated view of the size in the header, of any format.
+// Returns false for invalid or truncated data or a size mismatch.
+XTD_QOI_FUNC_DECL bool XTD_ReadQOIHeader(const void* data, usize size, XTD_QOIDesc* desc);
+XTD_QOI_FUNC_DECL bool XTD_ReadQOIFromMem(const void* data, usize size, XTD_Image* dst);
+
+// Streaming variants: read the header first to size dst, then the pixels that follow it.
+// Pixels are read in 64 KiB chunks, so the file position may end up past the end marker.
+// Return 0, an errno value or EINVAL for invalid data.
+XTD_QOI_FUNC_DECL int XTD_ReadQOIFileHeader(void* in_file, XTD_QOIDesc* desc);
+XTD_QOI_FUNC_DECL int XTD_ReadQOIFilePixels(void* in_file, XTD_Image* dst);
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_QOI_IMPLEMENTATION
+
+#include "xtd_thread.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _XTD_QOI_OP_INDEX 0x00
+#define _XTD_QOI_OP_DIFF  0x40
+#define _XTD_QOI_OP_LUMA  0x80
+#define _XTD_QOI_OP_RUN   0xC0
+#define _XTD_QOI_OP_RGB   0xFE
+#define _XTD_QOI_OP_RGBA  0xFF
+#define _XTD_QOI_MAX_RUN 62
+#define _XTD_QOI_MAX_OP_SIZE 5
+#define _XTD_QOI_MAX_PIXELS 400000000 // Same limit as the reference implementation
+#define _XTD_QOI_FILE_CHUNK XTD_KB(64)
+
+static const u8 _xtd_qoi_end_marker[XTD_QOI_PADDING_SIZE] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+// Encoder and decoder state, both sides keep it in sync
+typedef struct {
+    ColorRGBA index[64];
+    ColorRGBA prev;
+    u32 run;
+} _XTD_QOICodec;
+
+// Rows to encode, either raw pixels or an image view converted to RGBA8 row by row
+typedef struct {
+    const u8* pixels;
+    usize stride;
+    const XTD_Image* image;
+    i32 width;
+    i32 height;
+    int channels;
+} _XTD_QOISource;
+
+static void _xtd_QOICodecInit(_XTD_QOICodec* codec)
+{
+    XTD_ZERO_STRUCT(codec);
+    codec->prev.a = 255;
+}
+
+XTD_FORCE_INLINE u32 _xtd_QOIHash(ColorRGBA c)
+{
+    return (c.r * 3u + c.g * 5u + c.b * 7u + c.a * 11u) & 63;
+}
+
+static void _xtd_QOIWriteU32(u8* out, u32 v)
+{
+    out[0] = (u8)(v >> 24);
+    out[1] = (u8)(v >> 16);
+    out[2] = (u8)(v >> 8);
+    out[3] = (u8)v;
+}
+
+static u32 _xtd_QOIReadU32(const u8* p)
+{
+    return ((u32)p[0] << 24) | ((u32)p[1] << 16) | ((u32)p[2] << 8) | p[3];
+}
+
+XTD_QOI_FUNC usize XTD_GetQOIMaxSize(i32 width, i32 height, i32 channels)
+{
+    return (usize)width * (usize)height * (usize)(channels + 1) + XTD_QOI_HEADER_SIZE + XTD_QOI_PADDING_SIZE;
+}
+
+////////////////////////////////////////
+//
+//  Encoding
+//
+
+static u8* _xtd_QOIWriteHeader(u8* out, i32 width, i32 height, int channels)
+{
+    memcpy(out, "qoif", 4);
+    _xtd_QOIWriteU32(out + 4, (u32)width);
+    _xtd_QOIWriteU32(out + 8, (u32)height);
+    out[12] = (u8)channels;
+    out[13] = XTD_QOI_SRGB;
+    return out + XTD_QOI_HEADER_SIZE;
+}
+
+// Runs can span rows, they are only flushed when they reach the maximum length or on finish
+static u8* _xtd_QOIEncodeRow(_XTD_QOICodec* codec, u8* out, const u8* row, i32 width, int channels)
+{
+    ColorRGBA prev = codec->prev;
+    u32 run = codec->run;
+    for (i32 x = 0; x < width; x++, row += channels)
+    {
+        ColorRGBA px;
+        if (channels == 4)
+        {
+            memcpy(&px.hex, row, 4);
+        } else
+        {
+            px.r = row[0];
+            px.g = row[1];
+            px.b = row[2];
+            px.a = 255;
+        }
+
+        if (px.hex == prev.hex)
+        {
+            if (++run == _XTD_QOI_MAX_RUN)
+            {
+                *out++ = (u8)(_XTD_QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0)
+        {
+            *out++ = (u8)(_XTD_QOI_OP_RUN | (run - 1));
+            run = 0;
+        }
+
+        u32 h = _xtd_QOIHash(px);
+        if (codec->index[h].hex == px.hex)
+        {
+            *out++ = (u8)(_XTD_QOI_OP_INDEX | h);
+        } else if (px.a == prev.a)
+        {
+            codec->index[h] = px;
+            i8 vr = (i8)(px.r - prev.r);
+            i8 vg = (i8)(px.g - prev.g);
+            i8 vb = (i8)(px.b - prev.b);
+            i8 vg_r = (i8)(vr - vg);
+            i8 vg_b = (i8)(vb - vg);
+            if (vr >= -2 && vr <= 1 && vg >= -2 && vg <= 1 && vb >= -2 && vb <= 1)
+            {
+                *out++ = (u8)(_XTD_QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+            } else if (vg_r >= -8 && vg_r <= 7 && vg >= -32 && vg <= 31 && vg_b >= -8 && vg_b <= 7)
+            {
+                *out++ = (u8)(_XTD_QOI_OP_LUMA | (vg + 32));
+                *out++ = (u8)((vg_r + 8) << 4 | (vg_b + 8));
+            } else
+            {
+                *out++ = _XTD_QOI_OP_RGB;
+                *out++ = px.r;
+                *out++ = px.g;
+                *out++ = px.b;
+            }
+        } else
+        {
+            codec->index[h] = px;
+            *out++ = _XTD_QOI_OP_RGBA;
+            memcpy(out, &px.hex, 4);
+            out += 4;
+        }
+        prev = px;
+    }
+    codec->prev = prev;
+    codec->run = run;
+    return out;
+}
+
+static u8* _xtd_QOIEncodeFinish(_XTD_QOICodec* codec, u8* out)
+{
+    if (codec->run > 0)
+        *out++ = (u8)(_XTD_QOI_OP_RUN | (codec->run - 1));
+    codec->run = 0;
+    memcpy(out, _xtd_qoi_end_marker, XTD_QOI_PADDING_SIZE);
+    return out + XTD_QOI_PADDING_SIZE;
+}
+
+// Writes to out_buffer, or to out_file through a chunk buffer that is flushed whenever the
+// next row might not fit
+static int _xtd_QOIEncode(const _XTD_QOISource* src, u8* out_buffer, FILE* out_file, usize* out_size)
+{
+    // A run carried over from the previous row and the one flushed on finish add a byte each
+    usize row_max = (usize)src->width * _XTD_QOI_MAX_OP_SIZE + 2 + XTD_QOI_PADDING_SIZE;
+    usize capacity = XTD_MAX(row_max + XTD_QOI_HEADER_SIZE, (usize)_XTD_QOI_FILE_CHUNK);
+    u8* chunk = out_file ? (u8*)malloc(capacity) : NULL;
+    bool convert = src->image != NULL && src->image->format != XTD_PIXEL_RGBA8;
+    u8* converted = convert ? (u8*)malloc((usize)src->width * 4) : NULL;
+    *out_size = 0;
+    if ((out_file && chunk == NULL) || (convert && converted == NULL))
+    {
+        free(chunk);
+        free(converted);
+        return ENOMEM;
+    }
+
+    _XTD_QOICodec codec;
+    _xtd_QOICodecInit(&codec);
+    u8* start = out_file ? chunk : out_buffer;
+    u8* out = _xtd_QOIWriteHeader(start, src->width, src->height, src->channels);
+    int result = 0;
+    for (i32 y = 0; y < src->height && result == 0; y++)
+    {
+        if (out_file && (usize)(out - start) + row_max > capacity)
+        {
+            usize n = (usize)(out - start);
+            if (fwrite(start, 1, n, out_file) != n)
+                result = errno;
+            *out_size += n;
+            out = start;
+        }
+
+        const u8* row;
+        if (src->image == NULL)
+        {
+            row = src->pixels + (usize)y * src->stride;
+        } else if (convert)
+        {
+            XTD_Image dst_row = XTD_ImageWrap(converted, src->width, 1, (usize)src->width * 4, XTD_PIXEL_RGBA8);
+            XTD_Image src_row = XTD_ImageSubView(src->image, 0, y, src->width, 1);
+            XTD_ImageCopy(&dst_row, &src_row);
+            row = converted;
+        } else
+        {
+            row = XTD_ImageRow(src->image, y);
+        }
+        out = _xtd_QOIEncodeRow(&codec, out, row, src->width, src->channels);
+    }
+    out = _xtd_QOIEncodeFinish(&codec, out);
+
+    usize n = (usize)(out - start);
+    if (out_file && result == 0 && fwrite(start, 1, n, out_file) != n)
+        result = errno;
+    *out_size += n;
+    free(chunk);
+    free(converted);
+    return result;
+}
+
+static _XTD_QOISource _xtd_QOIRawSource(i32 width, i32 height, int channels, const u8* pixels)
+{
+    XTD_ASSERT(channels == 3 || channels == 4);
+    _XTD_QOISource src;
+    XTD_ZERO_STRUCT(&src);
+    src.pixels = pixels;
+    src.stride = (usize)width * (usize)channels;
+    src.width = width;
+    src.height = height;
+    src.channels = channels;
+    return src;
+}
+
+static _XTD_QOISource _xtd_QOIImageSource(const XTD_Image* img)
+{
+    _XTD_QOISource src;
+    XTD_ZERO_STRUCT(&src);
+    src.image = img;
+    src.width = img->width;
+    src.height = img->height;
+    src.channels = 4;
+    return src;
+}
+
+XTD_QOI_FUNC usize XTD_WriteQOIToMem(void* out_buffer, i32 width, i32 height, int channels, const u8* pixels)
+{
+    _XTD_QOISource src = _xtd_QOIRawSource(width, height, channels, pixels);
+    usize size;
+    _xtd_QOIEncode(&src, (u8*)out_buffer, NULL, &size);
+    return size;
+}
+
+XTD_QOI_FUNC int XTD_WriteQOIToFile(void* out_file, i32 width, i32 height, int channels, const u8* pixels)
+{
+    _XTD_QOISource src = _xtd_QOIRawSource(width, height, channels, pixels);
+    usize size;
+    return _xtd_QOIEncode(&src, NULL, (FILE*)out_file, &size);
+}
+
+XTD_QOI_FUNC usize XTD_WriteQOIImageToMem(void* out_buffer, const XTD_Image* img)
+{
+    _XTD_QOISource src = _xtd_QOIImageSource(img);
+    usize size;
+    return _xtd_QOIEncode(&src, (u8*)out_buffer, NULL, &size) == 0 ? size : 0;
+}
+
+XTD_QOI_FUNC int XTD_WriteQOIImageToFile(void* out_file, const XTD_Image* img)
+{
+    _XTD_QOISource src = _xtd_QOIImageSource(img);
+    usize size;
+    return _xtd_QOIEncode(&src, NULL, (FILE*)out_file, &size);
+}
+
+static void _xtd_QOIFrameTask(void* user, u32 task_index, u32 task_count)
+{
+    (void)task_count;
+    XTD_QOIFrame* frame = (XTD_QOIFrame*)user + task_index;
+    _XTD_QOISource src = _xtd_QOIImageSource(&frame->image);
+    frame->result = _xtd_QOIEncode(&src, (u8*)frame->out_buffer, (FILE*)frame->out_file, &frame->out_size);
+}
+
+XTD_QOI_FUNC void XTD_WriteQOIFrames(XTD_QOIFrame* frames, u32 count, u32 thread_count)
+{
+    XTD_ParallelFor(count, thread_count, _xtd_QOIFrameTask, frames);
+}
+
+////////////////////////////////////////
+//
+//  Decoding
+//
+
+// Ops are read while p < end, multi byte ops may read up to 4 bytes past it so end must
+// leave that much room (the end marker does). Returns NULL if the data runs out.
+static const u8* _xtd_QOIDecodeRow(_XTD_QOICodec* codec, const u8* p, const u8* end, u8* row, i32 width)
+{
+    ColorRGBA px = codec->prev;
+    u32 run = codec->run;
+    for (i32 x = 0; x < width; x++, row += 4)
+    {
+        if (run > 0)
+        {
+            run--;
+        } else
+        {
+            if (p >= end)
+                return NULL;
+            u8 b1 = *p++;
+            if (b1 == _XTD_QOI_OP_RGB)
+            {
+                px.r = p[0];
+                px.g = p[1];
+                px.b = p[2];
+                p += 3;
+            } else if (b1 == _XTD_QOI_OP_RGBA)
+            {
+                memcpy(&px.hex, p, 4);
+                p += 4;
+            } else
+            {
+                switch (b1 & 0xC0)
+                {
+                    case _XTD_QOI_OP_INDEX:
+                        px = codec->index[b1];
+                        break;
+                    case _XTD_QOI_OP_DIFF:
+                        px.r = (u8)(px.r + ((b1 >> 4) & 3) - 2);
+                        px.g = (u8)(px.g + ((b1 >> 2) & 3) - 2);
+                        px.b = (u8)(px.b + (b1 & 3) - 2);
+                        break;
+                    case _XTD_QOI_OP_LUMA:
+                    {
+                        u8 b2 = *p++;
+                        i32 vg = (b1 & 0x3F) - 32;
+                        px.r = (u8)(px.r + vg - 8 + ((b2 >> 4) & 0x0F));
+                        px.g = (u8)(px.g + vg);
+                        px.b = (u8)(px.b + vg - 8 + (b2 & 0x0F));
+                        break;
+                    }
+                    default:
+                        run = b1 & 0x3F;
+                        break;
+                }
+            }
+            codec->index[_xtd_QOIHash(px)] = px;
+        }
+        memcpy(row, &px.hex, 4);
+    }
+    codec->prev = px;
+    codec->run = run;
+    return p;
+}
+
+// Decodes one row straight into dst when it is RGBA8, through a converted row otherwise
+static const u8* _xtd_QOIDecodeImageRow(_XTD_QOICodec* codec, const u8* p, const u8* end, XTD_Image* dst, i32 y, u8* converted)
+{
+    if (converted == NULL)
+        return _xtd_QOIDecodeRow(codec, p, end, XTD_ImageRow(dst, y), dst->width);
+
+    p = _xtd_QOIDecodeRow(codec, p, end, converted, dst->width);
+    XTD_Image src_row = XTD_ImageWrap(converted, dst->width, 1, (usize)dst->width * 4, XTD_PIXEL_RGBA8);
+    XTD_Image dst_row = XTD_ImageSubView(dst, 0, y, dst->width, 1);
+    XTD_ImageCopy(&dst_row, &src_row);
+    return p;
+}
+
+XTD_QOI_FUNC bool XTD_ReadQOIHeader(const void* data, usize size, XTD_QOIDesc* desc)
+{
+    const u8* p = (const u8*)data;
+    if (size < XTD_QOI_HEADER_SIZE || memcmp(p, "qoif", 4) != 0)
+        return false;
+    u32 width = _xtd_QOIReadU32(p + 4);
+    u32 height = _xtd_QOIReadU32(p + 8);
+    if (width == 0 || height == 0 || p[12] < 3 || p[12] > 4 || p[13] > XTD_QOI_LINEAR ||
+        height >= _XTD_QOI_MAX_PIXELS / width)
+        return false;
+    desc->width = (i32)width;
+    desc->height = (i32)height;
+    desc->channels = p[12];
+    desc->colorspace = p[13];
+    return true;
+}
+
+XTD_QOI_FUNC bool XTD_ReadQOIFromMem(const void* data, usize size, XTD_Image* dst)
+{
+    XTD_QOIDesc desc;
+    if (!XTD_ReadQOIHeader(data, size, &desc) || size < XTD_QOI_HEADER_SIZE + XTD_QOI_PADDING_SIZE ||
+        desc.width != dst->width || desc.height != dst->height)
+        return false;
+
+    u8* converted = NULL;
+    if (dst->format != XTD_PIXEL_RGBA8 && (converted = (u8*)malloc((usize)dst->width * 4)) == NULL)
+        return false;
+
+    _XTD_QOICodec codec;
+    _xtd_QOICodecInit(&codec);
+    const u8* p = (const u8*)data + XTD_QOI_HEADER_SIZE;
+    const u8* end = (const u8*)data + size - XTD_QOI_PADDING_SIZE;
+    for (i32 y = 0; y < dst->height && p != NULL; y++)
+        p = _xtd_QOIDecodeImageRow(&codec, p, end, dst, y, converted);
+    free(converted);
+    return p != NULL;
+}
+
+XTD_QOI_FUNC int XTD_ReadQOIFileHeader(void* in_file, XTD_QOIDesc* desc)
+{
+    u8 header[XTD_QOI_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), (FILE*)in_file) != sizeof(header))
+        return ferror((FILE*)in_file) ? errno : EINVAL;
+    return XTD_ReadQOIHeader(header, sizeof(header), desc) ? 0 : EINVAL;
+}
+
+// The chunk buffer is topped up before every row and always holds a whole worst case row,
+// so rows never straddle a refill. Only at the end of the file is the end marker excluded.
+XTD_QOI_FUNC int XTD_ReadQOIFilePixels(void* in_file, XTD_Image* dst)
+{
+    FILE* file = (FILE*)in_file;
+    usize capacity = XTD_MAX((usize)dst->width * _XTD_QOI_MAX_OP_SIZE + XTD_QOI_PADDING_SIZE, (usize)_XTD_QOI_FILE_CHUNK);
+    u8* chunk = (u8*)malloc(capacity);
+    u8* converted = dst->format != XTD_PIXEL_RGBA8 ? (u8*)malloc((usize)dst->width * 4) : NULL;
+    if (chunk == NULL || (dst->format != XTD_PIXEL_RGBA8 && converted == NULL))
+    {
+        free(chunk);
+        free(converted);
+        return ENOMEM;
+    }
+
+    _XTD_QOICodec codec;
+    _xtd_QOICodecInit(&codec);
+    usize filled = 0;
+    const u8* p = chunk;
+    int result = 0;
+    for (i32 y = 0; y < dst->height; y++)
+    {
+        usize left = filled - (usize)(p - chunk);
+        memmove(chunk, p, left);
+        filled = left + fread(chunk + left, 1, capacity - left, file);
+        if (filled < capacity && ferror(file))
+        {
+            result = errno;
+            break;
+        }
+
+        const u8* end = chunk + filled;
+        if (filled < capacity)
+            end = filled >= XTD_QOI_PADDING_SIZE ? end - XTD_QOI_PADDING_SIZE : chunk;
+        p = _xtd_QOIDecodeImageRow(&codec, chunk, end, dst, y, converted);
+        if (p == NULL)
+        {
+            result = EINVAL;
+            break;
+        }
+    }
+    free(chunk);
+    free(converted);
+    return result;
+}
+
+#undef _XTD_QOI_OP_INDEX
+#undef _XTD_QOI_OP_DIFF
+#undef _XTD_QOI_OP_LUMA
+#undef _XTD_QOI_OP_RUN
+#undef _XTD_QOI_OP_RGB
+#undef _XTD_QOI_OP_RGBA
+#undef _XTD_QOI_MAX_RUN
+#undef _XTD_QOI_MAX_OP_SIZE
+#undef _XTD_QOI_MAX_PIXELS
+#undef _XTD_QOI_FILE_CHUNK
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //XTD_QOI_HEADER_H
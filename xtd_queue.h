@@ -0,0 +1,400 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Lock-free queue module
+// #define XTD_QUEUE_IMPLEMENTATION to include the implementation
+
+#ifndef XTD_QUEUE_HEADER_H
+#define XTD_QUEUE_HEADER_H
+
+#ifndef XTD_QUEUE_FUNC
+#define XTD_QUEUE_FUNC
+#endif
+
+#ifndef XTD_QUEUE_FUNC_DECL
+#define XTD_QUEUE_FUNC_DECL extern
+#endif
+
+#ifndef XTD_QUEUE_MALLOC
+#define XTD_QUEUE_MALLOC(size) malloc(size)
+#endif
+
+#ifndef XTD_QUEUE_FREE
+#define XTD_QUEUE_FREE(ptr) free(ptr)
+#endif
+
+#include "xtd_common.h"
+#include <stdbool.h>
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  Queue Types
+//
+
+// Both queues are bounded, store elements of a fixed size by value
+// and round the requested capacity up to a power of two.
+
+// Single producer, single consumer ring. Push and pop are wait-free.
+// Each side keeps a cached copy of the other side's index so it only
+// touches the shared cache line when the ring looks full/empty.
+typedef struct {
+    u8* buffer;
+    usize elem_size;
+    usize capacity;
+    usize mask;
+    XTD_CACHE_PAD(_pad0, sizeof(u8*) + 3 * sizeof(usize));
+
+    // Producer side
+    usize head;
+    usize cached_tail;
+    XTD_CACHE_PAD(_pad1, 2 * sizeof(usize));
+
+    // Consumer side
+    usize tail;
+    usize cached_head;
+    XTD_CACHE_PAD(_pad2, 2 * sizeof(usize));
+} XTD_SPSCQueue;
+
+// Multi producer, multi consumer queue (Dmitry Vyukov's bounded queue).
+// Every cell carries a sequence number that tells producers and consumers
+// whether it is ready for them, so the only contended words are the
+// enqueue and dequeue positions.
+typedef struct {
+    u8* cells;
+    usize elem_size;
+    usize cell_size;
+    usize capacity;
+    usize mask;
+    XTD_CACHE_PAD(_pad0, sizeof(u8*) + 4 * sizeof(usize));
+
+    usize enqueue_pos;
+    XTD_CACHE_PAD(_pad1, sizeof(usize));
+
+    usize dequeue_pos;
+    XTD_CACHE_PAD(_pad2, sizeof(usize));
+} XTD_MPMCQueue;
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+XTD_QUEUE_FUNC_DECL bool XTD_SPSCQueueInit(XTD_SPSCQueue* q, usize elem_size, usize capacity);
+XTD_QUEUE_FUNC_DECL void XTD_SPSCQueueFree(XTD_SPSCQueue* q);
+XTD_QUEUE_FUNC_DECL bool XTD_SPSCTryPush(XTD_SPSCQueue* q, const void* item);
+XTD_QUEUE_FUNC_DECL bool XTD_SPSCTryPop(XTD_SPSCQueue* q, void* out_item);
+// Batch functions move as many items as fit and return how many were moved
+XTD_QUEUE_FUNC_DECL usize XTD_SPSCPushBatch(XTD_SPSCQueue* q, const void* items, usize count);
+XTD_QUEUE_FUNC_DECL usize XTD_SPSCPopBatch(XTD_SPSCQueue* q, void* out_items, usize max_count);
+
+XTD_QUEUE_FUNC_DECL bool XTD_MPMCQueueInit(XTD_MPMCQueue* q, usize elem_size, usize capacity);
+XTD_QUEUE_FUNC_DECL void XTD_MPMCQueueFree(XTD_MPMCQueue* q);
+XTD_QUEUE_FUNC_DECL bool XTD_MPMCTryPush(XTD_MPMCQueue* q, const void* item);
+XTD_QUEUE_FUNC_DECL bool XTD_MPMCTryPop(XTD_MPMCQueue* q, void* out_item);
+XTD_QUEUE_FUNC_DECL usize XTD_MPMCPushBatch(XTD_MPMCQueue* q, const void* items, usize count);
+XTD_QUEUE_FUNC_DECL usize XTD_MPMCPopBatch(XTD_MPMCQueue* q, void* out_items, usize max_count);
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_QUEUE_IMPLEMENTATION
+
+#include <stdlib.h>
+#include <string.h>
+
+static usize _xtdq_RoundUpPow2(usize x)
+{
+    usize p = 1;
+    while (p < x)
+        p <<= 1;
+    return p;
+}
+
+// Copies 'count' elements into the ring starting at 'index', wrapping around the end
+static void _xtdq_CopyIn(u8* ring, usize mask, usize elem_size, usize index, const u8* src, usize count)
+{
+    usize start = index & mask;
+    usize first = XTD_MIN(count, mask + 1 - start);
+    memcpy(ring + start * elem_size, src, first * elem_size);
+    memcpy(ring, src + first * elem_size, (count - first) * elem_size);
+}
+
+static void _xtdq_CopyOut(const u8* ring, usize mask, usize elem_size, usize index, u8* dst, usize count)
+{
+    usize start = index & mask;
+    usize first = XTD_MIN(count, mask + 1 - start);
+    memcpy(dst, ring + start * elem_size, first * elem_size);
+    memcpy(dst + first * elem_size, ring, (count - first) * elem_size);
+}
+
+//
+// SPSC
+//
+
+XTD_QUEUE_FUNC bool XTD_SPSCQueueInit(XTD_SPSCQueue* q, usize elem_size, usize capacity)
+{
+    XTD_ZERO_STRUCT(q);
+    q->capacity = _xtdq_RoundUpPow2(XTD_MAX(capacity, (usize)2));
+    q->mask = q->capacity - 1;
+    q->elem_size = elem_size;
+    q->buffer = (u8*)XTD_QUEUE_MALLOC(q->capacity * elem_size);
+    return q->buffer != NULL;
+}
+
+XTD_QUEUE_FUNC void XTD_SPSCQueueFree(XTD_SPSCQueue* q)
+{
+    XTD_QUEUE_FREE(q->buffer);
+    XTD_ZERO_STRUCT(q);
+}
+
+XTD_QUEUE_FUNC bool XTD_SPSCTryPush(XTD_SPSCQueue* q, const void* item)
+{
+    usize head = q->head;
+    if (head - q->cached_tail >= q->capacity)
+    {
+        q->cached_tail = XTD_ATOMIC_LOAD_ACQUIRE(&q->tail);
+        if (head - q->cached_tail >= q->capacity)
+            return false;
+    }
+
+    memcpy(q->buffer + (head & q->mask) * q->elem_size, item, q->elem_size);
+    XTD_ATOMIC_STORE_RELEASE(&q->head, head + 1);
+    return true;
+}
+
+XTD_QUEUE_FUNC bool XTD_SPSCTryPop(XTD_SPSCQueue* q, void* out_item)
+{
+    usize tail = q->tail;
+    if (tail == q->cached_head)
+    {
+        q->cached_head = XTD_ATOMIC_LOAD_ACQUIRE(&q->head);
+        if (tail == q->cached_head)
+            return false;
+    }
+
+    memcpy(out_item, q->buffer + (tail & q->mask) * q->elem_size, q->elem_size);
+    XTD_ATOMIC_STORE_RELEASE(&q->tail, tail + 1);
+    return true;
+}
+
+XTD_QUEUE_FUNC usize XTD_SPSCPushBatch(XTD_SPSCQueue* q, const void* items, usize count)
+{
+    usize head = q->head;
+    usize free_slots = q->capacity - (head - q->cached_tail);
+    if (free_slots < count)
+    {
+        q->cached_tail = XTD_ATOMIC_LOAD_ACQUIRE(&q->tail);
+        free_slots = q->capacity - (head - q->cached_tail);
+    }
+
+    usize n = XTD_MIN(count, free_slots);
+    if (n == 0)
+        return 0;
+
+    _xtdq_CopyIn(q->buffer, q->mask, q->elem_size, head, (const u8*)items, n);
+    XTD_ATOMIC_STORE_RELEASE(&q->head, head + n);
+    return n;
+}
+
+XTD_QUEUE_FUNC usize XTD_SPSCPopBatch(XTD_SPSCQueue* q, void* out_items, usize max_count)
+{
+    usize tail = q->tail;
+    usize available = q->cached_head - tail;
+    if (available < max_count)
+    {
+        q->cached_head = XTD_ATOMIC_LOAD_ACQUIRE(&q->head);
+        available = q->cached_head - tail;
+    }
+
+    usize n = XTD_MIN(max_count, available);
+    if (n == 0)
+        return 0;
+
+    _xtdq_CopyOut(q->buffer, q->mask, q->elem_size, tail, (u8*)out_items, n);
+    XTD_ATOMIC_STORE_RELEASE(&q->tail, tail + n);
+    return n;
+}
+
+//
+// MPMC
+//
+
+#define _XTDQ_CELL(q, pos) ((q)->cells + ((pos) & (q)->mask) * (q)->cell_size)
+#define _XTDQ_CELL_SEQ(cell) ((usize*)(cell))
+#define _XTDQ_CELL_DATA(cell) ((cell) + sizeof(usize))
+
+XTD_QUEUE_FUNC bool XTD_MPMCQueueInit(XTD_MPMCQueue* q, usize elem_size, usize capacity)
+{
+    XTD_ZERO_STRUCT(q);
+    q->capacity = _xtdq_RoundUpPow2(XTD_MAX(capacity, (usize)2));
+    q->mask = q->capacity - 1;
+    q->elem_size = elem_size;
+    q->cell_size = XTD_ALIGNUP(sizeof(usize) + elem_size, sizeof(usize));
+    q->cells = (u8*)XTD_QUEUE_MALLOC(q->capacity * q->cell_size);
+    if (q->cells == NULL)
+        return false;
+
+    for (usize i = 0; i < q->capacity; i++)
+        *_XTDQ_CELL_SEQ(_XTDQ_CELL(q, i)) = i;
+    return true;
+}
+
+XTD_QUEUE_FUNC void XTD_MPMCQueueFree(XTD_MPMCQueue* q)
+{
+    XTD_QUEUE_FREE(q->cells);
+    XTD_ZERO_STRUCT(q);
+}
+
+XTD_QUEUE_FUNC bool XTD_MPMCTryPush(XTD_MPMCQueue* q, const void* item)
+{
+    usize pos = XTD_ATOMIC_LOAD_RELAXED(&q->enqueue_pos);
+    u8* cell;
+    for (;;)
+    {
+        cell = _XTDQ_CELL(q, pos);
+        isize diff = (isize)XTD_ATOMIC_LOAD_ACQUIRE(_XTDQ_CELL_SEQ(cell)) - (isize)pos;
+        if (diff == 0)
+        {
+            if (XTD_ATOMIC_CAS(&q->enqueue_pos, &pos, pos + 1))
+                break;
+        } else if (diff < 0)
+        {
+            return false;
+        } else
+        {
+            pos = XTD_ATOMIC_LOAD_RELAXED(&q->enqueue_pos);
+        }
+    }
+
+    memcpy(_XTDQ_CELL_DATA(cell), item, q->elem_size);
+    XTD_ATOMIC_STORE_RELEASE(_XTDQ_CELL_SEQ(cell), pos + 1);
+    return true;
+}
+
+XTD_QUEUE_FUNC bool XTD_MPMCTryPop(XTD_MPMCQueue* q, void* out_item)
+{
+    usize pos = XTD_ATOMIC_LOAD_RELAXED(&q->dequeue_pos);
+    u8* cell;
+    for (;;)
+    {
+        cell = _XTDQ_CELL(q, pos);
+        isize diff = (isize)XTD_ATOMIC_LOAD_ACQUIRE(_XTDQ_CELL_SEQ(cell)) - (isize)(pos + 1);
+        if (diff == 0)
+        {
+            if (XTD_ATOMIC_CAS(&q->dequeue_pos, &pos, pos + 1))
+                break;
+        } else if (diff < 0)
+        {
+            return false;
+        } else
+        {
+            pos = XTD_ATOMIC_LOAD_RELAXED(&q->dequeue_pos);
+        }
+    }
+
+    memcpy(out_item, _XTDQ_CELL_DATA(cell), q->elem_size);
+    XTD_ATOMIC_STORE_RELEASE(_XTDQ_CELL_SEQ(cell), pos + q->mask + 1);
+    return true;
+}
+
+// Batches claim a run of consecutive ready cells with a single CAS.
+// Cells in the run can only be modified by whoever owns their position,
+// so if the CAS succeeds they are still ready for us.
+XTD_QUEUE_FUNC usize XTD_MPMCPushBatch(XTD_MPMCQueue* q, const void* items, usize count)
+{
+    usize pos = XTD_ATOMIC_LOAD_RELAXED(&q->enqueue_pos);
+    usize n;
+    for (;;)
+    {
+        n = 0;
+        isize diff = 0;
+        while (n < count)
+        {
+            diff = (isize)XTD_ATOMIC_LOAD_ACQUIRE(_XTDQ_CELL_SEQ(_XTDQ_CELL(q, pos + n))) - (isize)(pos + n);
+            if (diff != 0)
+                break;
+            n++;
+        }
+
+        if (n == 0)
+        {
+            if (diff < 0 || count == 0)
+                return 0;
+            pos = XTD_ATOMIC_LOAD_RELAXED(&q->enqueue_pos);
+            continue;
+        }
+
+        if (XTD_ATOMIC_CAS(&q->enqueue_pos, &pos, pos + n))
+            break;
+    }
+
+    const u8* src = (const u8*)items;
+    for (usize i = 0; i < n; i++)
+    {
+        u8* cell = _XTDQ_CELL(q, pos + i);
+        memcpy(_XTDQ_CELL_DATA(cell), src + i * q->elem_size, q->elem_size);
+        XTD_ATOMIC_STORE_RELEASE(_XTDQ_CELL_SEQ(cell), pos + i + 1);
+    }
+    return n;
+}
+
+XTD_QUEUE_FUNC usize XTD_MPMCPopBatch(XTD_MPMCQueue* q, void* out_items, usize max_count)
+{
+    usize pos = XTD_ATOMIC_LOAD_RELAXED(&q->dequeue_pos);
+    usize n;
+    for (;;)
+    {
+        n = 0;
+        isize diff = 0;
+        while (n < max_count)
+        {
+            diff = (isize)XTD_ATOMIC_LOAD_ACQUIRE(_XTDQ_CELL_SEQ(_XTDQ_CELL(q, pos + n))) - (isize)(pos + n + 1);
+            if (diff != 0)
+                break;
+            n++;
+        }
+
+        if (n == 0)
+        {
+            if (diff < 0 || max_count == 0)
+                return 0;
+            pos = XTD_ATOMIC_LOAD_RELAXED(&q->dequeue_pos);
+            continue;
+        }
+
+        if (XTD_ATOMIC_CAS(&q->dequeue_pos, &pos, pos + n))
+            break;
+    }
+
+    u8* dst = (u8*)out_items;
+    for (usize i = 0; i < n; i++)
+    {
+        u8* cell = _XTDQ_CELL(q, pos + i);
+        memcpy(dst + i * q->elem_size, _XTDQ_CELL_DATA(cell), q->elem_size);
+        XTD_ATOMIC_STORE_RELEASE(_XTDQ_CELL_SEQ(cell), pos + i + q->mask + 1);
+    }
+    return n;
+}
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_QUEUE_HEADER_H
@@ -0,0 +1,463 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Sorting module
+// #define XTD_SORT_IMPLEMENTATION to include the implementation
+// Depends on xtd_thread.h for the parallel variants
+
+#ifndef XTD_SORT_HEADER_H
+#define XTD_SORT_HEADER_H
+
+#ifndef XTD_SORT_FUNC
+#define XTD_SORT_FUNC
+#endif
+
+#ifndef XTD_SORT_FUNC_DECL
+#define XTD_SORT_FUNC_DECL extern
+#endif
+
+#include "xtd_common.h"
+#include "xtd_dyn.h"
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  Radix Sort
+//
+
+// LSD radix sorts with 8 bit digits. All of them are stable, sort ascending and need a
+// caller-supplied scratch buffer of 'count' elements (one per array being sorted).
+// Digits where every key has the same value are skipped.
+// Floats are ordered like their numeric value, with -0 before +0 and NaNs at the ends.
+// Values are u32 payloads (e.g. indices) that are permuted along with the keys.
+
+typedef enum {
+    XTD_RADIX_KEY_U32,
+    XTD_RADIX_KEY_I32,
+    XTD_RADIX_KEY_F32,
+} XTD_RadixKeyType;
+
+// Sorts any XTD_DA-shaped array in place, growing scratch_da (any XTD_DA of the
+// same element type) as needed so it can be reused between calls:
+//   XTD_DA_RADIX_SORT(XTD_RadixSortF32, depths, depth_scratch);
+#define XTD_DA_RADIX_SORT(sort_func, da, scratch_da) do { \
+        XTD_DA_RESERVE(scratch_da, (da).count) \
+        sort_func((da).items, (da).count, (scratch_da).items); \
+    } while(0)
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+XTD_SORT_FUNC_DECL void XTD_RadixSortU32(u32* keys, usize count, u32* scratch);
+XTD_SORT_FUNC_DECL void XTD_RadixSortI32(i32* keys, usize count, i32* scratch);
+XTD_SORT_FUNC_DECL void XTD_RadixSortF32(f32* keys, usize count, f32* scratch);
+XTD_SORT_FUNC_DECL void XTD_RadixSortU64(u64* keys, usize count, u64* scratch);
+
+XTD_SORT_FUNC_DECL void XTD_RadixSortU32KV(u32* keys, u32* values, usize count, u32* key_scratch, u32* value_scratch);
+XTD_SORT_FUNC_DECL void XTD_RadixSortI32KV(i32* keys, u32* values, usize count, i32* key_scratch, u32* value_scratch);
+XTD_SORT_FUNC_DECL void XTD_RadixSortF32KV(f32* keys, u32* values, usize count, f32* key_scratch, u32* value_scratch);
+XTD_SORT_FUNC_DECL void XTD_RadixSortU64KV(u64* keys, u32* values, usize count, u64* key_scratch, u32* value_scratch);
+
+// Multi-threaded 32 bit key sort: histogramming and scattering are split in contiguous
+// chunks across thread_count threads (0 = one per CPU). values may be NULL to sort
+// keys only, value_scratch is ignored then.
+XTD_SORT_FUNC_DECL void XTD_RadixSort32Parallel(void* keys, u32* values, usize count, void* key_scratch, u32* value_scratch,
+                                                XTD_RadixKeyType key_type, u32 thread_count);
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_SORT_IMPLEMENTATION
+
+#include "xtd_thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Maps keys to u32 so that unsigned order matches the key type's order
+XTD_FORCE_INLINE u32 _xtd_RadixEncode32(u32 k, XTD_RadixKeyType type) {
+    if (type == XTD_RADIX_KEY_I32)
+        return k ^ 0x80000000u;
+    if (type == XTD_RADIX_KEY_F32)
+        return k ^ ((u32)((i32)k >> 31) | 0x80000000u);
+    return k;
+}
+
+XTD_FORCE_INLINE u32 _xtd_RadixDecode32(u32 k, XTD_RadixKeyType type) {
+    if (type == XTD_RADIX_KEY_I32)
+        return k ^ 0x80000000u;
+    if (type == XTD_RADIX_KEY_F32)
+        return k ^ (((k >> 31) - 1) | 0x80000000u);
+    return k;
+}
+
+static void _xtd_RadixSort32(u32* keys, u32* values, usize count, u32* key_scratch, u32* value_scratch, XTD_RadixKeyType type)
+{
+    usize hist[4][256];
+    XTD_ZERO_FIXEDARRAY(hist);
+
+    // Encode in place and build all four digit histograms in a single read
+    for (usize i = 0; i < count; i++)
+    {
+        u32 k = _xtd_RadixEncode32(keys[i], type);
+        keys[i] = k;
+        hist[0][k & 0xFF]++;
+        hist[1][(k >> 8) & 0xFF]++;
+        hist[2][(k >> 16) & 0xFF]++;
+        hist[3][k >> 24]++;
+    }
+
+    u32* src_k = keys;
+    u32* dst_k = key_scratch;
+    u32* src_v = values;
+    u32* dst_v = value_scratch;
+
+    for (u32 pass = 0; pass < 4; pass++)
+    {
+        u32 shift = pass * 8;
+        usize* h = hist[pass];
+        if (count == 0 || h[(src_k[0] >> shift) & 0xFF] == count)
+            continue;
+
+        usize offsets[256];
+        usize sum = 0;
+        for (u32 b = 0; b < 256; b++)
+        {
+            offsets[b] = sum;
+            sum += h[b];
+        }
+
+        if (values)
+        {
+            for (usize i = 0; i < count; i++)
+            {
+                u32 k = src_k[i];
+                usize o = offsets[(k >> shift) & 0xFF]++;
+                dst_k[o] = k;
+                dst_v[o] = src_v[i];
+            }
+        } else
+        {
+            for (usize i = 0; i < count; i++)
+            {
+                u32 k = src_k[i];
+                dst_k[offsets[(k >> shift) & 0xFF]++] = k;
+            }
+        }
+
+        u32* t = src_k; src_k = dst_k; dst_k = t;
+        t = src_v; src_v = dst_v; dst_v = t;
+    }
+
+    if (src_k != keys)
+    {
+        for (usize i = 0; i < count; i++)
+            keys[i] = _xtd_RadixDecode32(src_k[i], type);
+        if (values)
+            memcpy(values, src_v, count * sizeof(u32));
+    } else if (type != XTD_RADIX_KEY_U32)
+    {
+        for (usize i = 0; i < count; i++)
+            keys[i] = _xtd_RadixDecode32(keys[i], type);
+    }
+}
+
+static void _xtd_RadixSort64(u64* keys, u32* values, usize count, u64* key_scratch, u32* value_scratch)
+{
+    usize hist[8][256];
+    XTD_ZERO_FIXEDARRAY(hist);
+
+    for (usize i = 0; i < count; i++)
+    {
+        u64 k = keys[i];
+        for (u32 d = 0; d < 8; d++)
+            hist[d][(k >> (d * 8)) & 0xFF]++;
+    }
+
+    u64* src_k = keys;
+    u64* dst_k = key_scratch;
+    u32* src_v = values;
+    u32* dst_v = value_scratch;
+
+    for (u32 pass = 0; pass < 8; pass++)
+    {
+        u32 shift = pass * 8;
+        usize* h = hist[pass];
+        if (count == 0 || h[(src_k[0] >> shift) & 0xFF] == count)
+            continue;
+
+        usize offsets[256];
+        usize sum = 0;
+        for (u32 b = 0; b < 256; b++)
+        {
+            offsets[b] = sum;
+            sum += h[b];
+        }
+
+        if (values)
+        {
+            for (usize i = 0; i < count; i++)
+            {
+                u64 k = src_k[i];
+                usize o = offsets[(k >> shift) & 0xFF]++;
+                dst_k[o] = k;
+                dst_v[o] = src_v[i];
+            }
+        } else
+        {
+            for (usize i = 0; i < count; i++)
+            {
+                u64 k = src_k[i];
+                dst_k[offsets[(k >> shift) & 0xFF]++] = k;
+            }
+        }
+
+        u64* tk = src_k; src_k = dst_k; dst_k = tk;
+        u32* tv = src_v; src_v = dst_v; dst_v = tv;
+    }
+
+    if (src_k != keys)
+    {
+        memcpy(keys, src_k, count * sizeof(u64));
+        if (values)
+            memcpy(values, src_v, count * sizeof(u32));
+    }
+}
+
+XTD_SORT_FUNC void XTD_RadixSortU32(u32* keys, usize count, u32* scratch)
+{
+    _xtd_RadixSort32(keys, NULL, count, scratch, NULL, XTD_RADIX_KEY_U32);
+}
+
+XTD_SORT_FUNC void XTD_RadixSortI32(i32* keys, usize count, i32* scratch)
+{
+    _xtd_RadixSort32((u32*)keys, NULL, count, (u32*)scratch, NULL, XTD_RADIX_KEY_I32);
+}
+
+XTD_SORT_FUNC void XTD_RadixSortF32(f32* keys, usize count, f32* scratch)
+{
+    _xtd_RadixSort32((u32*)keys, NULL, count, (u32*)scratch, NULL, XTD_RADIX_KEY_F32);
+}
+
+XTD_SORT_FUNC void XTD_RadixSortU64(u64* keys, usize count, u64* scratch)
+{
+    _xtd_RadixSort64(keys, NULL, count, scratch, NULL);
+}
+
+XTD_SORT_FUNC void XTD_RadixSortU32KV(u32* keys, u32* values, usize count, u32* key_scratch, u32* value_scratch)
+{
+    _xtd_RadixSort32(keys, values, count, key_scratch, value_scratch, XTD_RADIX_KEY_U32);
+}
+
+XTD_SORT_FUNC void XTD_RadixSortI32KV(i32* keys, u32* values, usize count, i32* key_scratch, u32* value_scratch)
+{
+    _xtd_RadixSort32((u32*)keys, values, count, (u32*)key_scratch, value_scratch, XTD_RADIX_KEY_I32);
+}
+
+XTD_SORT_FUNC void XTD_RadixSortF32KV(f32* keys, u32* values, usize count, f32* key_scratch, u32* value_scratch)
+{
+    _xtd_RadixSort32((u32*)keys, values, count, (u32*)key_scratch, value_scratch, XTD_RADIX_KEY_F32);
+}
+
+XTD_SORT_FUNC void XTD_RadixSortU64KV(u64* keys, u32* values, usize count, u64* key_scratch, u32* value_scratch)
+{
+    _xtd_RadixSort64(keys, values, count, key_scratch, value_scratch);
+}
+
+//
+// Parallel
+//
+
+#define _XTD_RADIX_MAX_THREADS 64
+
+typedef struct {
+    u32* src_k;
+    u32* dst_k;
+    u32* src_v;
+    u32* dst_v;
+    usize count;
+    usize chunk;
+    u32 shift;
+    XTD_RadixKeyType type;
+    usize total[4][256];
+    usize hist[_XTD_RADIX_MAX_THREADS][4][256];
+} _XTD_RadixParallelState;
+
+static void _xtd_RadixEncodeTask(void* user, u32 task, u32 task_count)
+{
+    (void)task_count;
+    _XTD_RadixParallelState* s = (_XTD_RadixParallelState*)user;
+    usize begin = task * s->chunk;
+    usize end = XTD_MIN(begin + s->chunk, s->count);
+
+    usize local[4][256];
+    XTD_ZERO_FIXEDARRAY(local);
+    for (usize i = begin; i < end; i++)
+    {
+        u32 k = _xtd_RadixEncode32(s->src_k[i], s->type);
+        s->src_k[i] = k;
+        local[0][k & 0xFF]++;
+        local[1][(k >> 8) & 0xFF]++;
+        local[2][(k >> 16) & 0xFF]++;
+        local[3][k >> 24]++;
+    }
+    memcpy(s->hist[task], local, sizeof(local));
+}
+
+// Rebuilds the per-thread histogram of the current digit into hist[task][0]
+static void _xtd_RadixHistogramTask(void* user, u32 task, u32 task_count)
+{
+    (void)task_count;
+    _XTD_RadixParallelState* s = (_XTD_RadixParallelState*)user;
+    usize begin = task * s->chunk;
+    usize end = XTD_MIN(begin + s->chunk, s->count);
+
+    usize local[256];
+    XTD_ZERO_FIXEDARRAY(local);
+    for (usize i = begin; i < end; i++)
+        local[(s->src_k[i] >> s->shift) & 0xFF]++;
+    memcpy(s->hist[task][0], local, sizeof(local));
+}
+
+static void _xtd_RadixScatterTask(void* user, u32 task, u32 task_count)
+{
+    (void)task_count;
+    _XTD_RadixParallelState* s = (_XTD_RadixParallelState*)user;
+    usize begin = task * s->chunk;
+    usize end = XTD_MIN(begin + s->chunk, s->count);
+    usize* offsets = s->hist[task][0];
+    u32 shift = s->shift;
+
+    if (s->src_v)
+    {
+        for (usize i = begin; i < end; i++)
+        {
+            u32 k = s->src_k[i];
+            usize o = offsets[(k >> shift) & 0xFF]++;
+            s->dst_k[o] = k;
+            s->dst_v[o] = s->src_v[i];
+        }
+    } else
+    {
+        for (usize i = begin; i < end; i++)
+        {
+            u32 k = s->src_k[i];
+            s->dst_k[offsets[(k >> shift) & 0xFF]++] = k;
+        }
+    }
+}
+
+static void _xtd_RadixDecodeTask(void* user, u32 task, u32 task_count)
+{
+    (void)task_count;
+    _XTD_RadixParallelState* s = (_XTD_RadixParallelState*)user;
+    usize begin = task * s->chunk;
+    usize end = XTD_MIN(begin + s->chunk, s->count);
+    for (usize i = begin; i < end; i++)
+        s->dst_k[i] = _xtd_RadixDecode32(s->src_k[i], s->type);
+    if (s->src_v && s->src_v != s->dst_v)
+        memcpy(s->dst_v + begin, s->src_v + begin, (end - begin) * sizeof(u32));
+}
+
+XTD_SORT_FUNC void XTD_RadixSort32Parallel(void* keys, u32* values, usize count, void* key_scratch, u32* value_scratch,
+                                           XTD_RadixKeyType key_type, u32 thread_count)
+{
+    if (thread_count == 0)
+        thread_count = XTD_GetCPUCount();
+    thread_count = XTD_MIN(thread_count, (u32)_XTD_RADIX_MAX_THREADS);
+
+    // Not worth splitting small inputs
+    if (thread_count <= 1 || count < (usize)thread_count * 4096)
+    {
+        _xtd_RadixSort32((u32*)keys, values, count, (u32*)key_scratch, value_scratch, key_type);
+        return;
+    }
+
+    _XTD_RadixParallelState* s = (_XTD_RadixParallelState*)malloc(sizeof(_XTD_RadixParallelState));
+    if (s == NULL)
+    {
+        _xtd_RadixSort32((u32*)keys, values, count, (u32*)key_scratch, value_scratch, key_type);
+        return;
+    }
+
+    s->count = count;
+    s->chunk = XTD_DIVCEIL(count, (usize)thread_count);
+    s->type = key_type;
+    s->src_k = (u32*)keys;
+    s->dst_k = (u32*)key_scratch;
+    // Keys only when values is NULL, whatever value_scratch is, like the serial sort
+    s->src_v = values;
+    s->dst_v = values ? value_scratch : NULL;
+
+    // Encode keys and build per-thread histograms of every digit in one pass
+    XTD_ParallelFor(thread_count, thread_count, _xtd_RadixEncodeTask, s);
+    XTD_ZERO_FIXEDARRAY(s->total);
+    for (u32 t = 0; t < thread_count; t++)
+        for (u32 d = 0; d < 4; d++)
+            for (u32 b = 0; b < 256; b++)
+                s->total[d][b] += s->hist[t][d][b];
+
+    for (u32 pass = 0; pass < 4; pass++)
+    {
+        s->shift = pass * 8;
+        if (s->total[pass][(s->src_k[0] >> s->shift) & 0xFF] == count)
+            continue;
+
+        // The encoding pass already left the digit 0 histograms in place, later
+        // digits have to be recounted because each pass reorders the chunks
+        if (pass != 0)
+            XTD_ParallelFor(thread_count, thread_count, _xtd_RadixHistogramTask, s);
+
+        // Bucket-major, thread-minor offsets keep the sort stable
+        usize sum = 0;
+        for (u32 b = 0; b < 256; b++)
+        {
+            for (u32 t = 0; t < thread_count; t++)
+            {
+                usize c = s->hist[t][0][b];
+                s->hist[t][0][b] = sum;
+                sum += c;
+            }
+        }
+
+        XTD_ParallelFor(thread_count, thread_count, _xtd_RadixScatterTask, s);
+
+        u32* t = s->src_k; s->src_k = s->dst_k; s->dst_k = t;
+        t = s->src_v; s->src_v = s->dst_v; s->dst_v = t;
+    }
+
+    // Decode back into the caller's arrays
+    if (s->src_k != (u32*)keys || key_type != XTD_RADIX_KEY_U32)
+    {
+        s->dst_k = (u32*)keys;
+        s->dst_v = values;
+        XTD_ParallelFor(thread_count, thread_count, _xtd_RadixDecodeTask, s);
+    }
+
+    free(s);
+}
+
+#undef _XTD_RADIX_MAX_THREADS
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_SORT_HEADER_H
@@ -0,0 +1,522 @@
+// XTD - Extended Standard Utilities for C/C++
+// Single header libraries
+// by Marcos Oviedo Rodríguez
+
+// Threading and synchronization module
+// #define XTD_THREAD_IMPLEMENTATION to include the implementation
+
+#ifndef XTD_THREAD_HEADER_H
+#define XTD_THREAD_HEADER_H
+
+#ifndef XTD_THREAD_FUNC
+#define XTD_THREAD_FUNC
+#endif
+
+#ifndef XTD_THREAD_FUNC_DECL
+#define XTD_THREAD_FUNC_DECL extern
+#endif
+
+// Pause iterations a waiting spinlock doubles up to before it starts yielding the CPU
+#ifndef XTD_SPIN_MAX_BACKOFF
+#define XTD_SPIN_MAX_BACKOFF 64
+#endif
+
+#include "xtd_common.h"
+#include <stdbool.h>
+
+// C++ compatibility
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+//
+//  Synchronization Types
+//
+
+// Test-and-test-and-set spinlock with exponential backoff. Zero initialized = unlocked.
+typedef struct {
+    u32 locked;
+} XTD_Spinlock;
+
+// Mutex with an uncontended path of a single CAS, waiters sleep in the kernel
+// (futex on Linux, WaitOnAddress on Windows). Zero initialized = unlocked.
+typedef struct {
+    u32 state; // 0: unlocked, 1: locked, 2: locked with waiters
+} XTD_Mutex;
+
+// Manual-reset event. Zero initialized = not signaled.
+typedef struct {
+    u32 signaled;
+} XTD_Event;
+
+// Counting semaphore, waiters sleep in the kernel. Zero initialized = count 0.
+typedef struct {
+    u32 count;
+    u32 waiters;
+} XTD_Semaphore;
+
+// OS thread handle
+typedef struct {
+    usize handle;
+} XTD_Thread;
+
+typedef void XTD_ThreadFunc(void* arg);
+
+// Task callback for XTD_ParallelFor, called once per task index
+typedef void XTD_TaskFunc(void* user, u32 task_index, u32 task_count);
+
+////////////////////////////////////////
+//
+//  Function Declarations
+//
+
+XTD_THREAD_FUNC_DECL bool XTD_ThreadCreate(XTD_Thread* thread, XTD_ThreadFunc* func, void* arg);
+XTD_THREAD_FUNC_DECL void XTD_ThreadJoin(XTD_Thread* thread);
+XTD_THREAD_FUNC_DECL void XTD_ThreadYield(void);
+XTD_THREAD_FUNC_DECL u32 XTD_GetCPUCount(void);
+
+// Runs func for every task index in [0, task_count) on up to thread_count threads
+// (0 = one per CPU) and returns once all of them finished. The caller runs tasks too.
+// Helper threads come from a pool started on first use and kept until the process exits.
+// One call uses the pool at a time, calls made meanwhile (nested ones too) start their own.
+XTD_THREAD_FUNC_DECL void XTD_ParallelFor(u32 task_count, u32 thread_count, XTD_TaskFunc* func, void* user);
+
+// Faults in the pages of a fresh allocation from thread_count threads (0 = one per CPU), see
+// XTD_FirstTouchRange. XTD_ParallelFor doesn't bind tasks to threads, so this only spreads
+// the page faults, it doesn't place pages on any particular NUMA node.
+XTD_THREAD_FUNC_DECL void XTD_ParallelFirstTouch(void* ptr, usize size, u32 thread_count);
+
+XTD_THREAD_FUNC_DECL void _XTD_SpinlockLockSlow(XTD_Spinlock* lock);
+XTD_THREAD_FUNC_DECL void _XTD_MutexLockSlow(XTD_Mutex* mutex);
+XTD_THREAD_FUNC_DECL void _XTD_MutexWake(XTD_Mutex* mutex);
+
+XTD_THREAD_FUNC_DECL void XTD_EventSet(XTD_Event* event);
+XTD_THREAD_FUNC_DECL void XTD_EventReset(XTD_Event* event);
+XTD_THREAD_FUNC_DECL void XTD_EventWait(XTD_Event* event);
+
+XTD_THREAD_FUNC_DECL void XTD_SemaphorePost(XTD_Semaphore* sem, u32 count);
+XTD_THREAD_FUNC_DECL void XTD_SemaphoreWait(XTD_Semaphore* sem);
+
+//
+// Inline fast paths
+//
+
+XTD_FORCE_INLINE bool XTD_SpinlockTryLock(XTD_Spinlock* lock) {
+    u32 expected = 0;
+    return XTD_ATOMIC_LOAD_RELAXED(&lock->locked) == 0 && XTD_ATOMIC_CAS(&lock->locked, &expected, 1);
+}
+
+XTD_FORCE_INLINE void XTD_SpinlockLock(XTD_Spinlock* lock) {
+    if (!XTD_SpinlockTryLock(lock))
+        _XTD_SpinlockLockSlow(lock);
+}
+
+XTD_FORCE_INLINE void XTD_SpinlockUnlock(XTD_Spinlock* lock) {
+    XTD_ATOMIC_STORE_RELEASE(&lock->locked, 0);
+}
+
+XTD_FORCE_INLINE bool XTD_MutexTryLock(XTD_Mutex* mutex) {
+    u32 expected = 0;
+    return XTD_ATOMIC_CAS(&mutex->state, &expected, 1);
+}
+
+XTD_FORCE_INLINE void XTD_MutexLock(XTD_Mutex* mutex) {
+    if (!XTD_MutexTryLock(mutex))
+        _XTD_MutexLockSlow(mutex);
+}
+
+XTD_FORCE_INLINE void XTD_MutexUnlock(XTD_Mutex* mutex) {
+    if (XTD_ATOMIC_FETCH_SUB(&mutex->state, 1) != 1)
+        _XTD_MutexWake(mutex);
+}
+
+XTD_FORCE_INLINE bool XTD_EventIsSet(XTD_Event* event) {
+    return XTD_ATOMIC_LOAD_ACQUIRE(&event->signaled) != 0;
+}
+
+XTD_FORCE_INLINE bool XTD_SemaphoreTryWait(XTD_Semaphore* sem) {
+    u32 count = XTD_ATOMIC_LOAD_RELAXED(&sem->count);
+    while (count > 0)
+    {
+        if (XTD_ATOMIC_CAS_WEAK(&sem->count, &count, count - 1))
+            return true;
+    }
+    return false;
+}
+
+// Writes a zero into each page of share task_index of [ptr, ptr + size) split in task_count
+// shares. Shares are split on 2 MiB boundaries when they are that big (a large page is faulted
+// as a whole). Only for memory whose contents don't matter yet, like fresh XTD_AlignedAlloc blocks.
+// A page is backed by memory on the NUMA node of the thread that writes it first, so calling
+// this from threads of your own that always work on the same share (pinned, or at least kept
+// on one node) places each share next to its thread.
+XTD_INLINE void XTD_FirstTouchRange(void* ptr, usize size, u32 task_index, u32 task_count) {
+    usize begin = (usize)ptr;
+    usize granule = size / task_count >= XTD_LARGE_PAGE_SIZE ? XTD_LARGE_PAGE_SIZE : XTD_PAGE_SIZE;
+    usize lo = begin + (usize)((u64)size * task_index / task_count);
+    usize hi = begin + (usize)((u64)size * (task_index + 1) / task_count);
+    if (task_index > 0)
+        lo = XTD_MAX(XTD_ALIGNDOWN(lo, granule), begin);
+    if (task_index + 1 < task_count)
+        hi = XTD_MAX(XTD_ALIGNDOWN(hi, granule), begin);
+    for (usize page = XTD_ALIGNDOWN(lo, XTD_PAGE_SIZE); page < hi; page += XTD_PAGE_SIZE)
+        *(volatile u8*)XTD_MAX(page, lo) = 0;
+}
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  Implementation
+//
+
+#ifdef XTD_THREAD_IMPLEMENTATION
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #pragma comment(lib, "Synchronization.lib")
+#elif defined(__linux__)
+    #include <linux/futex.h>
+    #include <sched.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #ifndef __cplusplus
+    // Hidden by unistd.h in strict ISO C modes
+    extern long syscall(long number, ...);
+    #endif
+#else
+    #include <sched.h>
+#endif
+
+#if !defined(_WIN32)
+    #include <pthread.h>
+    #include <unistd.h>
+    XTD_STATIC_ASSERT(sizeof(pthread_t) <= sizeof(usize));
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    XTD_ThreadFunc* func;
+    void* arg;
+} _XTD_ThreadStart;
+
+#if defined(_WIN32)
+static DWORD WINAPI _xtd_ThreadTrampoline(LPVOID param)
+#else
+static void* _xtd_ThreadTrampoline(void* param)
+#endif
+{
+    _XTD_ThreadStart start = *(_XTD_ThreadStart*)param;
+    free(param);
+    start.func(start.arg);
+    return 0;
+}
+
+XTD_THREAD_FUNC bool XTD_ThreadCreate(XTD_Thread* thread, XTD_ThreadFunc* func, void* arg)
+{
+    _XTD_ThreadStart* start = (_XTD_ThreadStart*)malloc(sizeof(_XTD_ThreadStart));
+    if (start == NULL)
+        return false;
+    start->func = func;
+    start->arg = arg;
+
+#if defined(_WIN32)
+    HANDLE handle = CreateThread(NULL, 0, _xtd_ThreadTrampoline, start, 0, NULL);
+    if (handle == NULL)
+    {
+        free(start);
+        return false;
+    }
+    thread->handle = (usize)handle;
+#else
+    pthread_t handle;
+    if (pthread_create(&handle, NULL, _xtd_ThreadTrampoline, start) != 0)
+    {
+        free(start);
+        return false;
+    }
+    thread->handle = 0;
+    memcpy(&thread->handle, &handle, sizeof(handle));
+#endif
+    return true;
+}
+
+XTD_THREAD_FUNC void XTD_ThreadJoin(XTD_Thread* thread)
+{
+#if defined(_WIN32)
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+#else
+    pthread_t handle;
+    memcpy(&handle, &thread->handle, sizeof(handle));
+    pthread_join(handle, NULL);
+#endif
+    thread->handle = 0;
+}
+
+XTD_THREAD_FUNC void XTD_ThreadYield(void)
+{
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+XTD_THREAD_FUNC u32 XTD_GetCPUCount(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (u32)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (u32)n : 1;
+#endif
+}
+
+typedef struct {
+    XTD_TaskFunc* func;
+    void* user;
+    u32 task_count;
+    u32 next_task;
+} _XTD_ParallelForState;
+
+static void _xtd_ParallelForWorker(void* arg)
+{
+    _XTD_ParallelForState* state = (_XTD_ParallelForState*)arg;
+    for (;;)
+    {
+        u32 task = XTD_ATOMIC_FETCH_ADD(&state->next_task, 1);
+        if (task >= state->task_count)
+            break;
+        state->func(state->user, task, state->task_count);
+    }
+}
+
+#define _XTD_MAX_PARALLEL_THREADS 256
+
+// Idle helpers sleep on wake. Every job posts wake once per helper it wants and waits for
+// as many done posts, so the job pointer stays valid while helpers read it.
+typedef struct {
+    XTD_Mutex lock;
+    XTD_Semaphore wake;
+    XTD_Semaphore done;
+    _XTD_ParallelForState* job;
+    u32 thread_count;
+    XTD_Thread threads[_XTD_MAX_PARALLEL_THREADS - 1];
+} _XTD_ThreadPool;
+
+static _XTD_ThreadPool _xtd_pool;
+
+static void _xtd_PoolWorker(void* arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        // The semaphore orders the job pointer written before the post
+        XTD_SemaphoreWait(&_xtd_pool.wake);
+        _xtd_ParallelForWorker(_xtd_pool.job);
+        XTD_SemaphorePost(&_xtd_pool.done, 1);
+    }
+}
+
+XTD_THREAD_FUNC void XTD_ParallelFor(u32 task_count, u32 thread_count, XTD_TaskFunc* func, void* user)
+{
+    if (thread_count == 0)
+        thread_count = XTD_GetCPUCount();
+    thread_count = XTD_MIN(XTD_MIN(thread_count, task_count), (u32)_XTD_MAX_PARALLEL_THREADS);
+    if (thread_count <= 1)
+    {
+        for (u32 i = 0; i < task_count; i++)
+            func(user, i, task_count);
+        return;
+    }
+
+    _XTD_ParallelForState state;
+    state.func = func;
+    state.user = user;
+    state.task_count = task_count;
+    state.next_task = 0;
+
+    if (XTD_MutexTryLock(&_xtd_pool.lock))
+    {
+        u32 helpers = thread_count - 1;
+        while (_xtd_pool.thread_count < helpers &&
+               XTD_ThreadCreate(&_xtd_pool.threads[_xtd_pool.thread_count], _xtd_PoolWorker, NULL))
+            _xtd_pool.thread_count++;
+        helpers = XTD_MIN(helpers, _xtd_pool.thread_count);
+
+        _xtd_pool.job = &state;
+        XTD_SemaphorePost(&_xtd_pool.wake, helpers);
+        _xtd_ParallelForWorker(&state);
+        for (u32 i = 0; i < helpers; i++)
+            XTD_SemaphoreWait(&_xtd_pool.done);
+        XTD_MutexUnlock(&_xtd_pool.lock);
+        return;
+    }
+
+    XTD_Thread threads[_XTD_MAX_PARALLEL_THREADS];
+    u32 started = 0;
+    for (u32 i = 1; i < thread_count; i++)
+    {
+        if (XTD_ThreadCreate(&threads[started], _xtd_ParallelForWorker, &state))
+            started++;
+    }
+
+    _xtd_ParallelForWorker(&state);
+
+    for (u32 i = 0; i < started; i++)
+        XTD_ThreadJoin(&threads[i]);
+}
+
+typedef struct {
+    void* ptr;
+    usize size;
+} _XTD_FirstTouchState;
+
+static void _xtd_FirstTouchTask(void* user, u32 task_index, u32 task_count)
+{
+    _XTD_FirstTouchState* state = (_XTD_FirstTouchState*)user;
+    XTD_FirstTouchRange(state->ptr, state->size, task_index, task_count);
+}
+
+XTD_THREAD_FUNC void XTD_ParallelFirstTouch(void* ptr, usize size, u32 thread_count)
+{
+    if (thread_count == 0)
+        thread_count = XTD_GetCPUCount();
+    _XTD_FirstTouchState state;
+    state.ptr = ptr;
+    state.size = size;
+    XTD_ParallelFor(thread_count, thread_count, _xtd_FirstTouchTask, &state);
+}
+
+// Blocks while *addr == expected (spurious wakeups are allowed)
+static void _xtd_FutexWait(u32* addr, u32 expected)
+{
+#if defined(_WIN32)
+    WaitOnAddress((volatile VOID*)addr, &expected, sizeof(expected), INFINITE);
+#elif defined(__linux__)
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#else
+    if (XTD_ATOMIC_LOAD(addr) == expected)
+        XTD_ThreadYield();
+#endif
+}
+
+static void _xtd_FutexWake(u32* addr, bool wake_all)
+{
+#if defined(_WIN32)
+    if (wake_all)
+        WakeByAddressAll((PVOID)addr);
+    else
+        WakeByAddressSingle((PVOID)addr);
+#elif defined(__linux__)
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, wake_all ? I32_MAX : 1, NULL, NULL, 0);
+#else
+    (void)addr;
+    (void)wake_all;
+#endif
+}
+
+XTD_THREAD_FUNC void _XTD_SpinlockLockSlow(XTD_Spinlock* lock)
+{
+    u32 backoff = 1;
+    for (;;)
+    {
+        // Spin on a plain load so waiters don't keep stealing the cache line
+        while (XTD_ATOMIC_LOAD_RELAXED(&lock->locked))
+        {
+            if (backoff <= XTD_SPIN_MAX_BACKOFF)
+            {
+                for (u32 i = 0; i < backoff; i++)
+                    XTD_CPU_PAUSE();
+                backoff *= 2;
+            } else
+            {
+                // The holder is probably descheduled
+                XTD_ThreadYield();
+            }
+        }
+        if (XTD_SpinlockTryLock(lock))
+            return;
+    }
+}
+
+// From Ulrich Drepper's "Futexes Are Tricky", mutex take 2
+XTD_THREAD_FUNC void _XTD_MutexLockSlow(XTD_Mutex* mutex)
+{
+    // Brief spin in case the holder is about to release
+    for (u32 i = 0; i < XTD_SPIN_MAX_BACKOFF; i++)
+    {
+        XTD_CPU_PAUSE();
+        if (XTD_ATOMIC_LOAD_RELAXED(&mutex->state) == 0 && XTD_MutexTryLock(mutex))
+            return;
+    }
+
+    u32 c = XTD_ATOMIC_EXCHANGE(&mutex->state, 2);
+    while (c != 0)
+    {
+        _xtd_FutexWait(&mutex->state, 2);
+        c = XTD_ATOMIC_EXCHANGE(&mutex->state, 2);
+    }
+}
+
+XTD_THREAD_FUNC void _XTD_MutexWake(XTD_Mutex* mutex)
+{
+    XTD_ATOMIC_STORE(&mutex->state, 0);
+    _xtd_FutexWake(&mutex->state, false);
+}
+
+XTD_THREAD_FUNC void XTD_EventSet(XTD_Event* event)
+{
+    if (XTD_ATOMIC_EXCHANGE(&event->signaled, 1) == 0)
+        _xtd_FutexWake(&event->signaled, true);
+}
+
+XTD_THREAD_FUNC void XTD_EventReset(XTD_Event* event)
+{
+    XTD_ATOMIC_STORE(&event->signaled, 0);
+}
+
+XTD_THREAD_FUNC void XTD_EventWait(XTD_Event* event)
+{
+    while (XTD_ATOMIC_LOAD_ACQUIRE(&event->signaled) == 0)
+        _xtd_FutexWait(&event->signaled, 0);
+}
+
+// Waiters register before sleeping, a post that misses them still changed the count so
+// their futex wait returns immediately
+XTD_THREAD_FUNC void XTD_SemaphorePost(XTD_Semaphore* sem, u32 count)
+{
+    XTD_ATOMIC_FETCH_ADD(&sem->count, count);
+    if (XTD_ATOMIC_LOAD(&sem->waiters) != 0)
+        _xtd_FutexWake(&sem->count, count > 1);
+}
+
+XTD_THREAD_FUNC void XTD_SemaphoreWait(XTD_Semaphore* sem)
+{
+    while (!XTD_SemaphoreTryWait(sem))
+    {
+        XTD_ATOMIC_FETCH_ADD(&sem->waiters, 1);
+        _xtd_FutexWait(&sem->count, 0);
+        XTD_ATOMIC_FETCH_SUB(&sem->waiters, 1);
+    }
+}
+
+#endif
+
+////////////////////////////////////////
+////////////////////////////////////////
+//
+//  End of Implementation
+//
+
+#ifdef __cplusplus //End extern "C"
+}
+#endif
+
+#endif // XTD_THREAD_HEADER_H